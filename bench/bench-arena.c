@@ -0,0 +1,47 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vsuite.h"
+#include "vsuite/arena.h"
+#include "bench.h"
+
+/*
+ * A report row: FIELDS VARCHAR columns duplicated into C strings, used, and
+ * released together.  ns/op is per row.
+ */
+
+enum { FIELDS = 30 };
+
+#define BENCH_ARENA(N)                                                       \
+static void bench_arena_##N(vs_arena_t *arena) {                             \
+    static VARCHAR(row[FIELDS], N);                                          \
+    char *out[FIELDS];                                                       \
+    for (size_t i = 0; i < FIELDS; i++) {                                    \
+        memset(row[i].arr, 'f', N);                                          \
+        row[i].len = (unsigned short)((i * 13 + 5) % N + 1);                 \
+    }                                                                        \
+    BENCH_RUN("dup", "dv_dup + free", N, N * FIELDS, (void)0,                \
+        { for (size_t i = 0; i < FIELDS; i++) out[i] = dv_dup(row[i]);       \
+          BENCH_CLOBBER(out);                                                \
+          for (size_t i = 0; i < FIELDS; i++) free(out[i]); });              \
+    BENCH_RUN("dup", "dv_arena_dup + reset", N, N * FIELDS, (void)0,         \
+        { for (size_t i = 0; i < FIELDS; i++)                                \
+              out[i] = dv_arena_dup(arena, row[i]);                          \
+          BENCH_CLOBBER(out);                                                \
+          vs_arena_reset(arena); });                                         \
+}
+
+BENCH_SIZES(BENCH_ARENA)
+
+#define CALL_ARENA(N) bench_arena_##N(arena);
+
+int main(void) {
+    vs_arena_t *arena = vs_arena_create(4096);
+    if (!arena)
+        return 1;
+    bench_header();
+    BENCH_SIZES(CALL_ARENA)
+    vs_arena_destroy(arena);
+    return 0;
+}
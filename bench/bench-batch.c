@@ -0,0 +1,64 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "vsuite.h"
+#include "bench.h"
+
+/*
+ * Post-fetch processing of a 10,000 row host array: the per-row loops that
+ * converted code runs after EXEC SQL FETCH against the vb_ batch macros.
+ * Sizes are the declared element widths; ns/op is per 10,000 row batch.
+ * Every macro here except v_rtrim is idempotent, so only rtrim needs the
+ * lengths restored between runs.
+ */
+
+enum { ROWS = 10000 };
+
+#define RESET_LEN(col, pad) \
+    for (size_t j = 0; j < ROWS; j++) (col)[j].len = (pad)[j].len
+
+#define BENCH_BATCH(N)                                                       \
+static void bench_batch_##N(void) {                                          \
+    static VARCHAR(col[ROWS], N);                                            \
+    static VARCHAR(pad[ROWS], N);                                            \
+    static VARCHAR(out[ROWS], N);                                            \
+    for (size_t i = 0; i < ROWS; i++) {                                      \
+        size_t w = (i * 13 + 5) % N;                                         \
+        memset(pad[i].arr, ' ', N);                                          \
+        memset(pad[i].arr, 'r', w / 2);                                      \
+        pad[i].arr[w] = '\0';                                                \
+        pad[i].len = (unsigned short)w;                                      \
+    }                                                                        \
+    memcpy(col, pad, sizeof col);                                            \
+    BENCH_RUN("zsetlen", "zv_zsetlen loop", N, N * ROWS, BENCH_CLOBBER(col), \
+        { for (size_t i = 0; i < ROWS; i++) zv_zsetlen(col[i]);              \
+          BENCH_CLOBBER(col); });                                            \
+    BENCH_RUN("zsetlen", "vb_zsetlen", N, N * ROWS, BENCH_CLOBBER(col),   \
+        { vb_zsetlen(col, ROWS); BENCH_CLOBBER(col); });                     \
+    BENCH_RUN("rtrim", "v_rtrim loop", N, N * ROWS, RESET_LEN(col, pad),    \
+        { for (size_t i = 0; i < ROWS; i++) v_rtrim(col[i]);                 \
+          BENCH_CLOBBER(col); });                                            \
+    BENCH_RUN("rtrim", "vb_rtrim", N, N * ROWS, RESET_LEN(col, pad),        \
+        { vb_rtrim(col, ROWS); BENCH_CLOBBER(col); });                       \
+    BENCH_RUN("upper", "v_upper loop", N, N * ROWS, BENCH_CLOBBER(col),   \
+        { for (size_t i = 0; i < ROWS; i++) v_upper(col[i]);                 \
+          BENCH_CLOBBER(col); });                                            \
+    BENCH_RUN("upper", "vb_upper", N, N * ROWS, BENCH_CLOBBER(col),       \
+        { vb_upper(col, ROWS); BENCH_CLOBBER(col); });                       \
+    BENCH_RUN("copy", "v_copy loop", N, N * ROWS, BENCH_CLOBBER(pad),               \
+        { for (size_t i = 0; i < ROWS; i++)                                  \
+              out[i].len = v_copy(out[i], pad[i]);                           \
+          BENCH_CLOBBER(out); });                                            \
+    BENCH_RUN("copy", "vb_copy", N, N * ROWS, BENCH_CLOBBER(pad),                   \
+        { vb_copy(out, pad, ROWS); BENCH_CLOBBER(out); });                   \
+}
+
+BENCH_SIZES(BENCH_BATCH)
+
+#define CALL_BATCH(N) bench_batch_##N();
+
+int main(void) {
+    bench_header();
+    BENCH_SIZES(CALL_BATCH)
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "vsuite.h"
+#include "vsuite/builder.h"
+#include "bench.h"
+
+/*
+ * A gl_post_desc style description built with v_sprintf() against the
+ * typed builder, plain and zero terminated.  Size is the length of the
+ * vendor field; ns/op is per description.
+ */
+
+#define WIDTHS(X) X(4) X(12) X(30)
+
+#define BENCH_BUILDER(N)                                                     \
+static void bench_builder_##N(void) {                                        \
+    VARCHAR(desc, 80);                                                       \
+    VARCHAR(vendor, 32);                                                     \
+    VARCHAR(zdesc, 80);                                                      \
+    long line = 7, inv = 123456;                                             \
+    memset(vendor.arr, 'V', N);                                              \
+    vendor.len = N;                                                          \
+    BENCH_RUN("build", "v_sprintf", N, N, BENCH_CLOBBER(&vendor),            \
+        { v_sprintf(desc, "AP %.*s/%04ld inv %ld", (int)vendor.len,           \
+                    vendor.arr, line, inv);                                  \
+          BENCH_CLOBBER(&desc); });                                          \
+    BENCH_RUN("build", "v_build", N, N, BENCH_CLOBBER(&vendor),              \
+        { v_builder_t b = v_build_begin(desc);                               \
+          v_build_lit(&b, "AP ");                                            \
+          v_build_v(&b, vendor);                                             \
+          v_build_char(&b, '/');                                             \
+          v_build_int_pad(&b, line, 4);                                      \
+          v_build_lit(&b, " inv ");                                          \
+          v_build_int(&b, inv);                                              \
+          v_build_end(desc, &b);                                             \
+          BENCH_CLOBBER(&desc); });                                          \
+    BENCH_RUN("build", "zv_build", N, N, BENCH_CLOBBER(&vendor),             \
+        { v_builder_t b = zv_build_begin(zdesc);                             \
+          v_build_lit(&b, "AP ");                                            \
+          v_build_v(&b, vendor);                                             \
+          v_build_char(&b, '/');                                             \
+          v_build_int_pad(&b, line, 4);                                      \
+          v_build_lit(&b, " inv ");                                          \
+          v_build_int(&b, inv);                                              \
+          zv_build_end(zdesc, &b);                                           \
+          BENCH_CLOBBER(&zdesc); });                                         \
+}
+
+WIDTHS(BENCH_BUILDER)
+
+#define CALL_BUILDER(N) bench_builder_##N();
+
+int main(void) {
+    bench_header();
+    WIDTHS(CALL_BUILDER)
+    return 0;
+}
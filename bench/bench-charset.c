@@ -0,0 +1,51 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "vsuite.h"
+#include "vsuite/charset.h"
+#include "bench.h"
+
+/*
+ * strspn/strcspn/strpbrk after zv_setlenz against the precompiled charset
+ * forms.  The field is digits with a delimiter at the end, so each call
+ * scans all of it; ns/op is per call.
+ */
+
+#define SIZES(X) X(12) X(40) X(200) X(2000)
+
+#define BENCH_CHARSET(N)                                                     \
+static void bench_charset_##N(void) {                                        \
+    static VARCHAR(v, N + 1);                                                \
+    static vs_charset_t digits, delims;                                      \
+    size_t r;                                                                \
+    long k;                                                                  \
+    const char *p;                                                           \
+    for (size_t i = 0; i < N; i++)                                           \
+        v.arr[i] = (char)('0' + i % 10);                                     \
+    v.arr[N - 1] = '|';                                                      \
+    v.len = N;                                                               \
+    digits = vs_charset("0123456789");                                       \
+    delims = vs_charset("|,;\t");                                            \
+    BENCH_RUN("strspn", "zv_setlenz+strspn", N, N, BENCH_CLOBBER(&v),        \
+        { zv_setlenz(v); r = strspn(v.arr, "0123456789"); BENCH_CLOBBER(r); }); \
+    BENCH_RUN("strspn", "v_strspn", N, N, BENCH_CLOBBER(&v),                 \
+        { r = v_strspn(v, &digits); BENCH_CLOBBER(r); });                    \
+    BENCH_RUN("strcspn", "zv_setlenz+strcspn", N, N, BENCH_CLOBBER(&v),      \
+        { zv_setlenz(v); r = strcspn(v.arr, "|,;\t"); BENCH_CLOBBER(r); });  \
+    BENCH_RUN("strcspn", "v_strcspn", N, N, BENCH_CLOBBER(&v),               \
+        { r = v_strcspn(v, &delims); BENCH_CLOBBER(r); });                   \
+    BENCH_RUN("strpbrk", "zv_setlenz+strpbrk", N, N, BENCH_CLOBBER(&v),      \
+        { zv_setlenz(v); p = strpbrk(v.arr, "|,;\t"); BENCH_CLOBBER(p); });  \
+    BENCH_RUN("strpbrk", "v_strpbrk", N, N, BENCH_CLOBBER(&v),               \
+        { k = v_strpbrk(v, &delims); BENCH_CLOBBER(k); });                   \
+}
+
+SIZES(BENCH_CHARSET)
+
+#define CALL_CHARSET(N) bench_charset_##N();
+
+int main(void) {
+    bench_header();
+    SIZES(CALL_CHARSET)
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "vsuite.h"
+#include "vsuite/column.h"
+#include "bench.h"
+
+/*
+ * Column-wide scans of 10,000 rows held as an array of VARCHAR against the
+ * same rows in a VCOLUMN.  ns/op is per 10,000 row scan; bytes counts the
+ * row data the scan is about.
+ */
+
+enum { ROWS = 10000 };
+
+#define BENCH_COLUMN(N)                                                      \
+static void bench_column_##N(void) {                                         \
+    static VARCHAR(rows[ROWS], N);                                           \
+    static VCOLUMN(col, ROWS, N);                                            \
+    for (size_t i = 0; i < ROWS; i++) {                                      \
+        size_t w = (i * 13 + 5) % N;                                         \
+        memset(rows[i].arr, 'k', N);                                         \
+        rows[i].len = (unsigned short)w;                                     \
+    }                                                                        \
+    vc_from_array(col, rows, ROWS);                                          \
+    size_t hits;                                                             \
+    BENCH_RUN("valid", "vb_valid", N, N * ROWS, (void)0,                     \
+        { hits = vb_valid(rows, ROWS); BENCH_CLOBBER(hits); });              \
+    BENCH_RUN("valid", "vc_valid", N, N * ROWS, (void)0,                     \
+        { hits = vc_valid(col); BENCH_CLOBBER(hits); });                     \
+    BENCH_RUN("eq", "v_ loop", N, N * ROWS, (void)0,                         \
+        { hits = 0;                                                          \
+          for (size_t i = 0; i < ROWS; i++)                                  \
+              hits += rows[i].len == 2 && memcmp(rows[i].arr, "kk", 2) == 0; \
+          BENCH_CLOBBER(hits); });                                           \
+    BENCH_RUN("eq", "vc_eq", N, N * ROWS, (void)0,                           \
+        { hits = vc_eq(col, "kk", NULL); BENCH_CLOBBER(hits); });            \
+    BENCH_RUN("upper", "v_upper loop", N, N * ROWS, (void)0,                 \
+        { for (size_t i = 0; i < ROWS; i++) v_upper(rows[i]);                \
+          BENCH_CLOBBER(rows); });                                           \
+    BENCH_RUN("upper", "vc_upper", N, N * ROWS, (void)0,                     \
+        { vc_upper(col); BENCH_CLOBBER(col); });                             \
+    static uint64_t h[ROWS];                                                 \
+    BENCH_RUN("hash", "v_hash loop", N, N * ROWS, (void)0,                   \
+        { for (size_t i = 0; i < ROWS; i++) h[i] = v_hash(rows[i]);          \
+          BENCH_CLOBBER(h); });                                              \
+    BENCH_RUN("hash", "vc_hash", N, N * ROWS, (void)0,                       \
+        { vc_hash(col, h); BENCH_CLOBBER(h); });                             \
+}
+
+BENCH_SIZES(BENCH_COLUMN)
+
+#define CALL_COLUMN(N) bench_column_##N();
+
+int main(void) {
+    bench_header();
+    BENCH_SIZES(CALL_COLUMN)
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+#include "vsuite.h"
+#include "vsuite/compare.h"
+#include "bench.h"
+
+/*
+ * Comparing two VARCHARs the current way (terminate both with zv_setlenz,
+ * then strcmp/strcasecmp) against the length-aware forms.  The values are
+ * equal, so every byte is compared; the case-insensitive pair differs in
+ * case only.  ns/op is per compare.
+ */
+
+#define SIZES(X) X(6) X(12) X(40) X(200)
+
+#define BENCH_COMPARE(N)                                                     \
+static void bench_compare_##N(void) {                                        \
+    static VARCHAR(a, N + 1);                                                \
+    static VARCHAR(b, N + 1);                                                \
+    static VARCHAR(u, N + 1);                                                \
+    int r;                                                                   \
+    for (size_t i = 0; i < N; i++) {                                         \
+        a.arr[i] = b.arr[i] = (char)('a' + i % 26);                          \
+        u.arr[i] = (char)('A' + i % 26);                                     \
+    }                                                                        \
+    a.len = b.len = u.len = N;                                               \
+    BENCH_RUN("cmp", "zv_setlenz+strcmp", N, N,                              \
+        { BENCH_CLOBBER(&a); BENCH_CLOBBER(&b); },                           \
+        { zv_setlenz(a); zv_setlenz(b); r = strcmp(a.arr, b.arr);            \
+          BENCH_CLOBBER(r); });                                              \
+    BENCH_RUN("cmp", "v_cmp", N, N,                                          \
+        { BENCH_CLOBBER(&a); BENCH_CLOBBER(&b); },                           \
+        { r = v_cmp(a, b); BENCH_CLOBBER(r); });                             \
+    BENCH_RUN("eq", "v_eq", N, N,                                            \
+        { BENCH_CLOBBER(&a); BENCH_CLOBBER(&b); },                           \
+        { r = v_eq(a, b); BENCH_CLOBBER(r); });                              \
+    BENCH_RUN("casecmp", "zv_setlenz+strcasecmp", N, N,                      \
+        { BENCH_CLOBBER(&a); BENCH_CLOBBER(&u); },                           \
+        { zv_setlenz(a); zv_setlenz(u); r = strcasecmp(a.arr, u.arr);        \
+          BENCH_CLOBBER(r); });                                              \
+    BENCH_RUN("casecmp", "v_casecmp", N, N,                                  \
+        { BENCH_CLOBBER(&a); BENCH_CLOBBER(&u); },                           \
+        { r = v_casecmp(a, u); BENCH_CLOBBER(r); });                         \
+    BENCH_RUN("caseeq", "v_caseeq", N, N,                                    \
+        { BENCH_CLOBBER(&a); BENCH_CLOBBER(&u); },                           \
+        { r = v_caseeq(a, u); BENCH_CLOBBER(r); });                          \
+}
+
+SIZES(BENCH_COMPARE)
+
+#define CALL_COMPARE(N) bench_compare_##N();
+
+int main(void) {
+    bench_header();
+    SIZES(CALL_COMPARE)
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "vsuite.h"
+#include "vsuite/concat.h"
+#include "bench.h"
+
+/*
+ * Composite keys of N parts built with a v_strcat()/zv_strcat() chain
+ * against v_concat_many()/zv_concat_many(), with one memcpy of the whole
+ * key as the floor.  Size is the key length; ns/op is per key.
+ */
+
+#define BENCH_CONCAT(name, parts, CHAIN, MANY, ZCHAIN, ZMANY)                \
+static void bench_concat_##name(void) {                                      \
+    VARCHAR(key, 64);                                                        \
+    VARCHAR(entity, 4);                                                      \
+    VARCHAR(org, 6);                                                         \
+    VARCHAR(acct, 10);                                                       \
+    VARCHAR(sep, 1);                                                         \
+    char flat[64];                                                           \
+    memcpy(entity.arr, "0100", 4); entity.len = 4;                           \
+    memcpy(org.arr, "R12345", 6); org.len = 6;                               \
+    memcpy(acct.arr, "6100200300", 10); acct.len = 10;                       \
+    sep.arr[0] = '|'; sep.len = 1;                                           \
+    BENCH_CLOBBER(&sep);                                                     \
+    size_t n = v_concat_many MANY;                                           \
+    memcpy(flat, key.arr, n);                                                \
+    BENCH_RUN("concat" #parts, "memcpy (floor)", n, n, BENCH_CLOBBER(flat),  \
+        { memcpy(key.arr, flat, n); key.len = n; BENCH_CLOBBER(&key); });    \
+    BENCH_RUN("concat" #parts, "v_strcat chain", n, n,                       \
+        BENCH_CLOBBER(&entity),                                              \
+        { key.len = 0; CHAIN; BENCH_CLOBBER(&key); });                       \
+    BENCH_RUN("concat" #parts, "v_concat_many", n, n,                        \
+        BENCH_CLOBBER(&entity),                                              \
+        { v_concat_many MANY; BENCH_CLOBBER(&key); });                       \
+    BENCH_RUN("concat" #parts, "zv_strcat chain", n, n,                      \
+        BENCH_CLOBBER(&entity),                                              \
+        { zv_init(key); ZCHAIN; BENCH_CLOBBER(&key); });                     \
+    BENCH_RUN("concat" #parts, "zv_concat_many", n, n,                       \
+        BENCH_CLOBBER(&entity),                                              \
+        { zv_concat_many ZMANY; BENCH_CLOBBER(&key); });                     \
+}
+
+BENCH_CONCAT(3, 3,
+    (v_strcat(key, entity), v_strcat(key, org), v_strcat(key, acct)),
+    (key, entity, org, acct),
+    (zv_strcat(key, entity), zv_strcat(key, org), zv_strcat(key, acct)),
+    (key, entity, org, acct))
+
+BENCH_CONCAT(6, 6,
+    (v_strcat(key, entity), v_strcat(key, sep), v_strcat(key, org),
+     v_strcat(key, sep), v_strcat(key, acct), v_strcat(key, sep)),
+    (key, entity, sep, org, sep, acct, sep),
+    (zv_strcat(key, entity), zv_strcat(key, sep), zv_strcat(key, org),
+     zv_strcat(key, sep), zv_strcat(key, acct), zv_strcat(key, sep)),
+    (key, entity, sep, org, sep, acct, sep))
+
+int main(void) {
+    bench_header();
+    bench_concat_3();
+    bench_concat_6();
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vsuite.h"
+#include "bench.h"
+
+/*
+ * Copy, concatenation and C string conversion macros against the raw code
+ * that better-varchar.py rewrites into them (see issue/001.txt):
+ *
+ *     strcpy(DST.arr, SRC.arr); DST.len = strlen(DST.arr);
+ *
+ * Every source holds size-1 bytes so the zv_ and C string forms fit.
+ */
+
+#define BENCH_COPY(N)                                                        \
+static void bench_copy_##N(void) {                                           \
+    VARCHAR(src, N); VARCHAR(dst, N);                                        \
+    memset(src.arr, 'c', N - 1);                                             \
+    src.arr[N - 1] = '\0';                                                   \
+    src.len = N - 1;                                                         \
+    BENCH_RUN("copy", "strcpy+strlen", N, N - 1, BENCH_CLOBBER(&src),        \
+        { strcpy(dst.arr, src.arr); dst.len = strlen(dst.arr);               \
+          BENCH_CLOBBER(&dst); });                                           \
+    BENCH_RUN("copy", "v_copy", N, N - 1, BENCH_CLOBBER(&src),               \
+        { dst.len = v_copy(dst, src); BENCH_CLOBBER(&dst); });               \
+    BENCH_RUN("copy", "zv_copy", N, N - 1, BENCH_CLOBBER(&src),              \
+        { zv_copy(dst, src); BENCH_CLOBBER(&dst); });                        \
+}
+
+#define BENCH_CAT(N)                                                         \
+static void bench_cat_##N(void) {                                            \
+    VARCHAR(a, N); VARCHAR(b, N); VARCHAR(dst, N);                           \
+    size_t ha = (N - 1) / 2, hb = (N - 1) - ha;                              \
+    memset(a.arr, 'a', ha); a.arr[ha] = '\0'; a.len = ha;                    \
+    memset(b.arr, 'b', hb); b.arr[hb] = '\0'; b.len = hb;                    \
+    BENCH_RUN("cat", "strcpy+strcat+strlen", N, N - 1, BENCH_CLOBBER(&a),    \
+        { strcpy(dst.arr, a.arr); strcat(dst.arr, b.arr);                    \
+          dst.len = strlen(dst.arr); BENCH_CLOBBER(&dst); });                \
+    BENCH_RUN("cat", "v_copy+v_strcat", N, N - 1, BENCH_CLOBBER(&a),         \
+        { dst.len = v_copy(dst, a); v_strcat(dst, b);                        \
+          BENCH_CLOBBER(&dst); });                                           \
+    BENCH_RUN("cat", "zv_copy+zv_strcat", N, N - 1, BENCH_CLOBBER(&a),       \
+        { zv_copy(dst, a); zv_strcat(dst, b); BENCH_CLOBBER(&dst); });       \
+}
+
+#define BENCH_CONVERT(N)                                                     \
+static void bench_convert_##N(void) {                                        \
+    VARCHAR(v, N);                                                           \
+    static char cstr[N];                                                     \
+    char out[N];                                                             \
+    char *p = cstr;                                                          \
+    memset(cstr, 'p', N - 1);                                                \
+    cstr[N - 1] = '\0';                                                      \
+    BENCH_RUN("convert", "strcpy+strlen (char*)", N, N - 1, BENCH_CLOBBER(p),\
+        { strcpy(v.arr, p); v.len = strlen(v.arr); BENCH_CLOBBER(&v); });    \
+    BENCH_RUN("convert", "vp_copy", N, N - 1, BENCH_CLOBBER(p),              \
+        { v.len = vp_copy(v, p); BENCH_CLOBBER(&v); });                      \
+    BENCH_RUN("convert", "zvp_copy", N, N - 1, BENCH_CLOBBER(p),             \
+        { zvp_copy(v, p); BENCH_CLOBBER(&v); });                             \
+    BENCH_RUN("convert", "vf_copy", N, N - 1, BENCH_CLOBBER(cstr),           \
+        { v.len = vf_copy(v, cstr); BENCH_CLOBBER(&v); });                   \
+    v.len = N - 1;                                                           \
+    BENCH_RUN("convert", "setlenz+strcpy", N, N - 1, BENCH_CLOBBER(&v),      \
+        { v.arr[v.len] = '\0'; strcpy(out, v.arr); BENCH_CLOBBER(out); });   \
+    BENCH_RUN("convert", "pv_copy", N, N - 1, BENCH_CLOBBER(&v),             \
+        { pv_copy(out, sizeof out, v); BENCH_CLOBBER(out); });               \
+    BENCH_RUN("convert", "setlenz+strdup", N, N - 1, BENCH_CLOBBER(&v),      \
+        { v.arr[v.len] = '\0'; char *d = strdup(v.arr);                      \
+          BENCH_CLOBBER(d); free(d); });                                     \
+    BENCH_RUN("convert", "dv_dup", N, N - 1, BENCH_CLOBBER(&v),              \
+        { char *d = dv_dup(v); BENCH_CLOBBER(d); free(d); });                \
+}
+
+BENCH_SIZES(BENCH_COPY)
+BENCH_SIZES(BENCH_CAT)
+BENCH_SIZES(BENCH_CONVERT)
+
+#define CALL_COPY(N)    bench_copy_##N();
+#define CALL_CAT(N)     bench_cat_##N();
+#define CALL_CONVERT(N) bench_convert_##N();
+
+int main(void) {
+    bench_header();
+    BENCH_SIZES(CALL_COPY)
+    BENCH_SIZES(CALL_CAT)
+    BENCH_SIZES(CALL_CONVERT)
+    return 0;
+}
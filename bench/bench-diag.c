@@ -0,0 +1,37 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vsuite/diag.h"
+#include "bench.h"
+
+/*
+ * The same VARCHAR_ZSETLEN style diagnostic as bench-logring, fired on
+ * every op.  "unlimited" writes each one; "limited" is a VS_DIAG_LIMITED
+ * site past its limit, i.e. what a bad column costs per row once the
+ * first VS_DIAG_LIMIT messages are out.
+ */
+
+int main(void) {
+    FILE *out = fopen("/dev/null", "w");
+    if (!out) {
+        perror("/dev/null");
+        return 1;
+    }
+    setvbuf(out, NULL, _IONBF, 0);
+    vs_diag_out = out;
+    const char *field = "invoice_list_ptr->product_list_tail->entity";
+    size_t bytes = (size_t)snprintf(NULL, 0,
+        "Line %d : VARCHAR_ZSETLEN(%s) : No NUL byte found within %u sizeof(.arr) bytes : value '%s'\n",
+        2104, field, 3u, "01");
+
+    bench_header();
+    BENCH_RUN("diag", "unlimited", 0, bytes, (void)0,
+        fprintf(out, "Line %d : VARCHAR_ZSETLEN(%s) : No NUL byte found within %u sizeof(.arr) bytes : value '%s'\n",
+                2104, field, 3u, "01"));
+    BENCH_RUN("diag", "limited", 0, bytes, (void)0,
+        VS_DIAG_LIMITED("VARCHAR_ZSETLEN",
+            fprintf(out, "Line %d : VARCHAR_ZSETLEN(%s) : No NUL byte found within %u sizeof(.arr) bytes : value '%s'\n",
+                    2104, field, 3u, "01")));
+    return 0;
+}
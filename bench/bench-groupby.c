@@ -0,0 +1,78 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vsuite.h"
+#include "vsuite/groupby.h"
+#include "bench.h"
+
+/*
+ * ROWS rows of (entity, account) keys with an amount, spread over G
+ * groups.  "sort" is the usual client-side fallback: qsort the row indices
+ * by key, then sum each run.  "v_group_row" adds row by row;
+ * "vb_group_add" takes the host arrays whole.  ns/op is per ROWS rows.
+ */
+
+enum { ROWS = 10000 };
+
+#define GROUP_COUNTS(X) X(10) X(1000) X(10000)
+
+static VARCHAR(ent[ROWS], 4);
+static VARCHAR(account[ROWS], 16);
+static int64_t amount[ROWS];
+
+static int cmp_row(const void *a, const void *b)
+{
+    size_t i = *(const size_t *)a, j = *(const size_t *)b;
+    int r = vs_cmp(ent[i].arr, ent[i].len, ent[j].arr, ent[j].len);
+    return r ? r : vs_cmp(account[i].arr, account[i].len, account[j].arr, account[j].len);
+}
+
+#define BENCH_GROUPBY(G)                                                     \
+static void bench_groupby_##G(void) {                                        \
+    for (size_t r = 0; r < ROWS; r++) {                                      \
+        size_t i = (r * 2654435761u) % G;                                    \
+        ent[r].len = (unsigned short)snprintf(ent[r].arr, 4, "%02zu", i % 7); \
+        account[r].len = (unsigned short)snprintf(account[r].arr, 16, "61%07zu", i); \
+        amount[r] = (int64_t)(r % 1000);                                     \
+    }                                                                        \
+    static size_t idx[ROWS];                                                 \
+    size_t groups;                                                           \
+    const vs_group_col_t cols[] = { VB_GROUP_COL(ent), VB_GROUP_COL(account) }; \
+    const int64_t *const vals[] = { amount };                                \
+    BENCH_RUN("groupby", "qsort+runs", G, ROWS,                              \
+        { for (size_t r = 0; r < ROWS; r++) idx[r] = r; },                   \
+        { qsort(idx, ROWS, sizeof idx[0], cmp_row);                          \
+          int64_t sum = 0;                                                   \
+          groups = 0;                                                        \
+          for (size_t r = 0; r < ROWS; r++) {                                \
+              if (r == 0 || cmp_row(&idx[r - 1], &idx[r]) != 0)              \
+                  { groups++; sum = 0; }                                     \
+              sum += amount[idx[r]];                                         \
+          }                                                                  \
+          BENCH_CLOBBER(sum); BENCH_CLOBBER(groups); });                     \
+    BENCH_RUN("groupby", "v_group_row", G, ROWS, (void)0,                    \
+        { vs_group_t *g = vs_group_create(2, 1, 0);                          \
+          for (size_t r = 0; r < ROWS; r++)                                  \
+              v_group_row(g, ent[r], account[r])[0] += amount[r];            \
+          groups = vs_group_count(g);                                        \
+          BENCH_CLOBBER(groups);                                             \
+          vs_group_destroy(g); });                                           \
+    BENCH_RUN("groupby", "vb_group_add", G, ROWS, (void)0,                   \
+        { vs_group_t *g = vs_group_create(2, 1, 0);                          \
+          vb_group_add(g, cols, vals, ROWS);                                 \
+          groups = vs_group_count(g);                                        \
+          BENCH_CLOBBER(groups);                                             \
+          vs_group_destroy(g); });                                           \
+}
+
+GROUP_COUNTS(BENCH_GROUPBY)
+
+#define CALL_GROUPBY(G) bench_groupby_##G();
+
+int main(void) {
+    bench_header();
+    GROUP_COUNTS(CALL_GROUPBY)
+    return 0;
+}
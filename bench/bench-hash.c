@@ -0,0 +1,70 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "vsuite.h"
+#include "vsuite/hash.h"
+#include "bench.h"
+
+/*
+ * Hashing a VARCHAR the current way (zv_setlenz, then an FNV-1a loop over
+ * the C string) against v_hash/v_casehash, and a three-field key hashed
+ * after v_concat_many against v_hash_fields.  ns/op is per key.
+ */
+
+#define SIZES(X) X(6) X(12) X(40) X(200)
+
+static inline uint64_t fnv1a(const char *s)
+{
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (; *s; s++)
+        h = (h ^ (unsigned char)*s) * 0x100000001B3ULL;
+    return h;
+}
+
+#define BENCH_HASH(N)                                                        \
+static void bench_hash_##N(void) {                                           \
+    static VARCHAR(v, N + 1);                                                \
+    uint64_t h;                                                              \
+    for (size_t i = 0; i < N; i++)                                           \
+        v.arr[i] = (char)('A' + i % 26);                                     \
+    v.len = N;                                                               \
+    BENCH_RUN("hash", "zv_setlenz+fnv1a", N, N, BENCH_CLOBBER(&v),           \
+        { zv_setlenz(v); h = fnv1a(v.arr); BENCH_CLOBBER(h); });             \
+    BENCH_RUN("hash", "v_hash", N, N, BENCH_CLOBBER(&v),                     \
+        { h = v_hash(v); BENCH_CLOBBER(h); });                               \
+    BENCH_RUN("hash", "v_casehash", N, N, BENCH_CLOBBER(&v),                 \
+        { h = v_casehash(v); BENCH_CLOBBER(h); });                           \
+}
+
+SIZES(BENCH_HASH)
+
+static void bench_fields(void)
+{
+    VARCHAR(entity, 8);
+    VARCHAR(org, 12);
+    VARCHAR(acct, 12);
+    VARCHAR(key, 40);
+    uint64_t h;
+    memcpy(entity.arr, "0100", 4);
+    entity.len = 4;
+    memcpy(org.arr, "R1234", 5);
+    org.len = 5;
+    memcpy(acct.arr, "6100200", 7);
+    acct.len = 7;
+    BENCH_RUN("key3", "v_concat_many+v_hash", 16, 16,
+        { BENCH_CLOBBER(&entity); BENCH_CLOBBER(&org); BENCH_CLOBBER(&acct); },
+        { v_concat_many(key, entity, org, acct); h = v_hash(key);
+          BENCH_CLOBBER(h); });
+    BENCH_RUN("key3", "v_hash_fields", 16, 16,
+        { BENCH_CLOBBER(&entity); BENCH_CLOBBER(&org); BENCH_CLOBBER(&acct); },
+        { h = v_hash_fields(entity, org, acct); BENCH_CLOBBER(h); });
+}
+
+#define CALL_HASH(N) bench_hash_##N();
+
+int main(void) {
+    bench_header();
+    SIZES(CALL_HASH)
+    bench_fields();
+    return 0;
+}
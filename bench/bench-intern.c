@@ -0,0 +1,58 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "vsuite.h"
+#include "vsuite/intern.h"
+#include "bench.h"
+
+/*
+ * A code column of ROWS values drawn from CODES distinct strings.  "store"
+ * keeps each row's code (a VARCHAR copy against a 4 byte id); "match" counts
+ * the rows equal to one code.  ns/op is per ROWS rows.
+ */
+
+enum { ROWS = 10000, CODES = 40 };
+
+#define BENCH_INTERN(N)                                                      \
+static void bench_intern_##N(void) {                                         \
+    static VARCHAR(col[ROWS], N);                                            \
+    static VARCHAR(kept[ROWS], N);                                           \
+    static uint32_t ids[ROWS];                                               \
+    vs_intern_t *pool = vs_intern_create(CODES);                             \
+    for (size_t i = 0; i < ROWS; i++) {                                      \
+        memset(col[i].arr, '0', N);                                          \
+        size_t w = N < 6 ? N : 6;                                            \
+        col[i].arr[w - 1] = (char)('A' + (i * 7) % CODES);                   \
+        col[i].len = (unsigned short)w;                                      \
+    }                                                                        \
+    size_t hits;                                                             \
+    BENCH_RUN("store", "v_copy", N, N * ROWS, (void)0,                       \
+        { for (size_t i = 0; i < ROWS; i++)                                  \
+              kept[i].len = v_copy(kept[i], col[i]);                         \
+          BENCH_CLOBBER(kept); });                                           \
+    BENCH_RUN("store", "v_intern", N, N * ROWS, (void)0,                     \
+        { for (size_t i = 0; i < ROWS; i++) ids[i] = v_intern(pool, col[i]); \
+          BENCH_CLOBBER(ids); });                                            \
+    BENCH_RUN("match", "len+memcmp", N, N * ROWS, (void)0,                   \
+        { hits = 0;                                                          \
+          for (size_t i = 0; i < ROWS; i++)                                  \
+              hits += kept[i].len == col[3].len &&                           \
+                      memcmp(kept[i].arr, col[3].arr, col[3].len) == 0;      \
+          BENCH_CLOBBER(hits); });                                           \
+    BENCH_RUN("match", "id ==", N, N * ROWS, (void)0,                        \
+        { hits = 0;                                                          \
+          for (size_t i = 0; i < ROWS; i++) hits += ids[i] == ids[3];        \
+          BENCH_CLOBBER(hits); });                                           \
+    vs_intern_destroy(pool);                                                 \
+}
+
+BENCH_SIZES(BENCH_INTERN)
+
+#define CALL_INTERN(N) bench_intern_##N();
+
+int main(void) {
+    bench_header();
+    BENCH_SIZES(CALL_INTERN)
+    return 0;
+}
@@ -0,0 +1,40 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vsuite/logring.h"
+#include "bench.h"
+
+/*
+ * One VARCHAR_ZSETLEN style diagnostic per op, written to /dev/null.
+ * "fprintf unbuffered" is the recommended logFile setup: one write(2) per
+ * message on the calling thread.  "vs_log_printf" formats into the ring and
+ * leaves the write to the drain thread; once the ring is full it runs at
+ * the drain rate, so the row is the sustained cost, not just the enqueue.
+ */
+
+int main(void) {
+    FILE *sync = fopen("/dev/null", "w");
+    FILE *async = fopen("/dev/null", "w");
+    if (!sync || !async) {
+        perror("/dev/null");
+        return 1;
+    }
+    setvbuf(sync, NULL, _IONBF, 0);
+    const char *field = "invoice_list_ptr->product_list_tail->entity";
+    size_t bytes = (size_t)snprintf(NULL, 0,
+        "Line %d : VARCHAR_ZSETLEN(%s) : No NUL byte found within %u sizeof(.arr) bytes : value '%s'\n",
+        2104, field, 3u, "01");
+
+    bench_header();
+    BENCH_RUN("log", "fprintf unbuffered", 0, bytes, (void)0,
+        fprintf(sync, "Line %d : VARCHAR_ZSETLEN(%s) : No NUL byte found within %u sizeof(.arr) bytes : value '%s'\n",
+                2104, field, 3u, "01"));
+    BENCH_RUN("log", "vs_log_printf", 0, bytes, (void)0,
+        vs_log_printf(async, "Line %d : VARCHAR_ZSETLEN(%s) : No NUL byte found within %u sizeof(.arr) bytes : value '%s'\n",
+                      2104, field, 3u, "01"));
+    vs_log_stop();
+    fclose(sync);
+    fclose(async);
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vsuite.h"
+#include "vsuite/map.h"
+#include "bench.h"
+
+/*
+ * A lookup table of KEYS account codes, probed with LOOKUPS codes per op in
+ * a scrambled order.  "find" compares bsearch over a sorted array of C
+ * strings (after zv_setlenz on the probe) with v_map_find; "build" compares
+ * strdup+qsort with vb_map_build.  ns/op is per LOOKUPS probes or per build.
+ */
+
+enum { LOOKUPS = 1000 };
+
+#define KEY_COUNTS(X) X(100) X(10000) X(1000000)
+
+static int cmp_str(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+#define BENCH_MAP(K)                                                         \
+static void bench_map_##K(void) {                                            \
+    static VARCHAR(acct[K], 16);                                             \
+    static typeof(acct[0]) probe[LOOKUPS];                                      \
+    static char *sorted[K];                                                  \
+    for (size_t i = 0; i < K; i++) {                                         \
+        acct[i].len = (unsigned short)snprintf(acct[i].arr, 16, "%02zu-%07zu", \
+                                               i % 97, i * 7919 % 10000019); \
+        sorted[i] = strndup(acct[i].arr, acct[i].len);                       \
+    }                                                                        \
+    qsort(sorted, K, sizeof sorted[0], cmp_str);                             \
+    for (size_t i = 0; i < LOOKUPS; i++)                                     \
+        memcpy(&probe[i], &acct[(i * 2654435761u) % K], sizeof probe[i]);                              \
+    vs_map_t *m = vs_map_create(K);                                          \
+    vb_map_build(m, acct, K);                                                \
+    size_t hits;                                                             \
+    BENCH_RUN("find", "zv_setlenz+bsearch", K, LOOKUPS, (void)0,             \
+        { hits = 0;                                                          \
+          for (size_t i = 0; i < LOOKUPS; i++) {                             \
+              zv_setlenz(probe[i]);                                          \
+              char *p = probe[i].arr;                                        \
+              hits += bsearch(&p, sorted, K, sizeof sorted[0], cmp_str) != NULL; \
+          }                                                                  \
+          BENCH_CLOBBER(hits); });                                           \
+    BENCH_RUN("find", "v_map_find", K, LOOKUPS, (void)0,                     \
+        { hits = 0;                                                          \
+          for (size_t i = 0; i < LOOKUPS; i++)                               \
+              hits += v_map_find(m, probe[i]) != NULL;                       \
+          BENCH_CLOBBER(hits); });                                           \
+    vs_map_destroy(m);                                                       \
+    if (K <= 10000) {                                                        \
+        BENCH_RUN("build", "strndup+qsort", K, K, (void)0,                   \
+            { char **s = malloc(K * sizeof *s);                              \
+              for (size_t i = 0; i < K; i++)                                 \
+                  s[i] = strndup(acct[i].arr, acct[i].len);                  \
+              qsort(s, K, sizeof *s, cmp_str);                               \
+              BENCH_CLOBBER(s);                                              \
+              for (size_t i = 0; i < K; i++) free(s[i]);                     \
+              free(s); });                                                   \
+        BENCH_RUN("build", "vb_map_build", K, K, (void)0,                    \
+            { vs_map_t *b = vs_map_create(K);                                \
+              vb_map_build(b, acct, K);                                      \
+              BENCH_CLOBBER(b);                                              \
+              vs_map_destroy(b); });                                         \
+    }                                                                        \
+    for (size_t i = 0; i < K; i++)                                           \
+        free(sorted[i]);                                                     \
+}
+
+KEY_COUNTS(BENCH_MAP)
+
+#define CALL_MAP(K) bench_map_##K();
+
+int main(void) {
+    bench_header();
+    KEY_COUNTS(CALL_MAP)
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vsuite.h"
+#include "vsuite/number.h"
+#include "bench.h"
+
+/*
+ * Numeric fields converted the current way (terminate a copy, then
+ * strtol/strtod, or v_sprintf to format) against the direct VARCHAR
+ * parsers and formatters.  Sizes are digit counts in a VARCHAR(20) field;
+ * ns/op is per conversion.
+ */
+
+#define DIGITS(X) X(3) X(7) X(12) X(18)
+
+#define BENCH_NUMBER(N)                                                      \
+static void bench_number_##N(void) {                                         \
+    VARCHAR(f, 20), d;                                                       \
+    VARCHAR(g, 24);                                                          \
+    char tmp[21];                                                            \
+    long x;                                                                  \
+    double y;                                                                \
+    memset(f.arr, ' ', sizeof f.arr);                                        \
+    for (size_t k = 0; k < N; k++)                                           \
+        f.arr[k] = (char)('1' + k % 9);                                      \
+    f.len = N;                                                               \
+    d = f;                                                                   \
+    d.arr[N - 2] = '.';                                                      \
+    BENCH_RUN("long", "pv_copy+strtol", N, N, BENCH_CLOBBER(&f),            \
+        { pv_copy(tmp, sizeof tmp, f); x = strtol(tmp, NULL, 10);            \
+          BENCH_CLOBBER(x); });                                              \
+    BENCH_RUN("long", "v_to_long", N, N, BENCH_CLOBBER(&f),                  \
+        { (void)v_to_long(f, &x); BENCH_CLOBBER(x); });                      \
+    BENCH_RUN("decimal", "pv_copy+strtod", N, N, BENCH_CLOBBER(&d),          \
+        { pv_copy(tmp, sizeof tmp, d); y = strtod(tmp, NULL);                \
+          BENCH_CLOBBER(y); });                                              \
+    BENCH_RUN("decimal", "v_to_decimal", N, N, BENCH_CLOBBER(&d),            \
+        { (void)v_to_decimal(d, 2, &x); BENCH_CLOBBER(x); });                \
+    (void)v_to_long(f, &x);                                                  \
+    BENCH_RUN("format", "v_sprintf", N, N, BENCH_CLOBBER(&x),               \
+        { v_sprintf(g, "%ld", x); BENCH_CLOBBER(&g); });                     \
+    BENCH_RUN("format", "v_from_int", N, N, BENCH_CLOBBER(&x),              \
+        { v_from_int(g, x); BENCH_CLOBBER(&g); });                           \
+    BENCH_RUN("format_pad", "v_sprintf", N, N, BENCH_CLOBBER(&x),           \
+        { v_sprintf(g, "%020ld", x); BENCH_CLOBBER(&g); });                  \
+    BENCH_RUN("format_pad", "v_from_int_pad", N, N, BENCH_CLOBBER(&x),      \
+        { v_from_int_pad(g, x, 20); BENCH_CLOBBER(&g); });                   \
+    BENCH_RUN("format_dec", "v_sprintf", N, N, BENCH_CLOBBER(&x),           \
+        { v_sprintf(g, "%ld.%02ld", x / 100, x % 100); BENCH_CLOBBER(&g); }); \
+    BENCH_RUN("format_dec", "v_from_decimal", N, N, BENCH_CLOBBER(&x),      \
+        { v_from_decimal(g, x, 2); BENCH_CLOBBER(&g); });                    \
+}
+
+DIGITS(BENCH_NUMBER)
+
+#define CALL_NUMBER(N) bench_number_##N();
+
+int main(void) {
+    bench_header();
+    DIGITS(CALL_NUMBER)
+    return 0;
+}
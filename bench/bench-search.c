@@ -0,0 +1,60 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "vsuite.h"
+#include "vsuite/search.h"
+#include "bench.h"
+
+/*
+ * Searching a VARCHAR the current way (terminate with zv_setlenz, then
+ * strchr/strrchr/strstr) against the length-bounded search functions.
+ * The match is at the end of the field; ns/op is per search.
+ */
+
+#define SIZES(X) X(12) X(40) X(200) X(2000)
+
+#define BENCH_SEARCH(N)                                                      \
+static void bench_search_##N(void) {                                         \
+    static VARCHAR(v, N + 1);                                                \
+    VARCHAR(sub, 8);                                                         \
+    static char longsub[48];                                                 \
+    long r;                                                                  \
+    const char *p;                                                           \
+    memset(v.arr, 'a', N);                                                   \
+    v.len = N;                                                               \
+    v.arr[N - 1] = '|';                                                      \
+    memcpy(v.arr + N - 4, "PAY|", 4);                                        \
+    memcpy(sub.arr, "PAY", 3);                                               \
+    sub.len = 3;                                                             \
+    memset(longsub, 'a', sizeof longsub - 1);                                \
+    longsub[sizeof longsub - 2] = 'P';                                       \
+    BENCH_RUN("index", "zv_setlenz+strchr", N, N, BENCH_CLOBBER(&v),         \
+        { zv_setlenz(v); p = strchr(v.arr, '|'); BENCH_CLOBBER(p); });       \
+    BENCH_RUN("index", "v_index", N, N, BENCH_CLOBBER(&v),                   \
+        { r = v_index(v, '|'); BENCH_CLOBBER(r); });                         \
+    BENCH_RUN("rindex", "zv_setlenz+strrchr", N, N, BENCH_CLOBBER(&v),       \
+        { zv_setlenz(v); p = strrchr(v.arr, 'P'); BENCH_CLOBBER(p); });      \
+    BENCH_RUN("rindex", "v_rindex", N, N, BENCH_CLOBBER(&v),                 \
+        { r = v_rindex(v, 'P'); BENCH_CLOBBER(r); });                        \
+    BENCH_RUN("strstr", "zv_setlenz+strstr", N, N, BENCH_CLOBBER(&v),        \
+        { zv_setlenz(v); p = strstr(v.arr, "PAY"); BENCH_CLOBBER(p); });     \
+    BENCH_RUN("strstr", "v_strstr", N, N, BENCH_CLOBBER(&v),                 \
+        { r = v_strstr(v, sub); BENCH_CLOBBER(r); });                        \
+    if (N > 48) {                                                            \
+        BENCH_RUN("strstr_long", "zv_setlenz+strstr", N, N,                  \
+            BENCH_CLOBBER(&v),                                               \
+            { zv_setlenz(v); p = strstr(v.arr, longsub); BENCH_CLOBBER(p); }); \
+        BENCH_RUN("strstr_long", "vp_strstr", N, N, BENCH_CLOBBER(&v),       \
+            { r = vp_strstr(v, longsub); BENCH_CLOBBER(r); });               \
+    }                                                                        \
+}
+
+SIZES(BENCH_SEARCH)
+
+#define CALL_SEARCH(N) bench_search_##N();
+
+int main(void) {
+    bench_header();
+    SIZES(CALL_SEARCH)
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "vsuite.h"
+#include "bench.h"
+
+/*
+ * In-place string macros against the loops they replace: trimming a
+ * blank-padded CHAR value, case conversion and formatting.
+ */
+
+/* Hand-written trim as found in converted Pro*C code. */
+static void raw_trim(char *s) {
+    size_t len = strlen(s);
+    while (len > 0 && isspace((unsigned char)s[len - 1]))
+        len--;
+    s[len] = '\0';
+    size_t i = 0;
+    while (s[i] && isspace((unsigned char)s[i]))
+        i++;
+    if (i)
+        memmove(s, s + i, len - i + 1);
+}
+
+#define BENCH_TRIM(N)                                                        \
+static void bench_trim_##N(void) {                                           \
+    VARCHAR(pad, N); VARCHAR(v, N);                                          \
+    size_t w = (N - 1) / 3 ? (N - 1) / 3 : 1;                                \
+    memset(pad.arr, ' ', N - 1);                                             \
+    memset(pad.arr + 1, 'T', w);                                             \
+    pad.arr[N - 1] = '\0';                                                   \
+    pad.len = N - 1;                                                         \
+    BENCH_RUN("trim", "isspace loops", N, N - 1, memcpy(&v, &pad, sizeof v), \
+        { raw_trim(v.arr); v.len = strlen(v.arr); BENCH_CLOBBER(&v); });    \
+    BENCH_RUN("trim", "v_trim", N, N - 1, memcpy(&v, &pad, sizeof v),        \
+        { v_trim(v); BENCH_CLOBBER(&v); });                                  \
+    BENCH_RUN("trim", "v_rtrim", N, N - 1, memcpy(&v, &pad, sizeof v),       \
+        { v_rtrim(v); BENCH_CLOBBER(&v); });                                 \
+    BENCH_RUN("trim", "s_trim", N, N - 1, memcpy(&v, &pad, sizeof v),        \
+        { s_trim(v.arr); BENCH_CLOBBER(&v); });                              \
+}
+
+#define BENCH_CASE(N)                                                        \
+static void bench_case_##N(void) {                                           \
+    VARCHAR(v, N);                                                           \
+    for (size_t i = 0; i < N - 1; i++)                                       \
+        v.arr[i] = "aBc1 -x"[i % 7];                                         \
+    v.arr[N - 1] = '\0';                                                     \
+    v.len = N - 1;                                                           \
+    BENCH_RUN("case", "toupper loop", N, N - 1, BENCH_CLOBBER(&v),           \
+        { for (size_t i = 0; i < v.len; i++)                                 \
+              v.arr[i] = toupper((unsigned char)v.arr[i]);                   \
+          BENCH_CLOBBER(&v); });                                             \
+    BENCH_RUN("case", "v_upper", N, N - 1, BENCH_CLOBBER(&v),                \
+        { v_upper(v); BENCH_CLOBBER(&v); });                                 \
+    BENCH_RUN("case", "v_lower", N, N - 1, BENCH_CLOBBER(&v),                \
+        { v_lower(v); BENCH_CLOBBER(&v); });                                 \
+    BENCH_RUN("case", "s_upper", N, N - 1, BENCH_CLOBBER(&v),                \
+        { s_upper(v.arr); BENCH_CLOBBER(&v); });                             \
+}
+
+#define BENCH_ZSETLEN(N)                                                     \
+static void bench_zsetlen_##N(void) {                                        \
+    VARCHAR(v, N);                                                           \
+    memset(v.arr, 'z', N - 1);                                               \
+    v.arr[N - 1] = '\0';                                                     \
+    BENCH_RUN("zsetlen", "strlen", N, N, BENCH_CLOBBER(&v),                  \
+        { v.len = strlen(v.arr); BENCH_CLOBBER(&v); });                      \
+    BENCH_RUN("zsetlen", "zv_zsetlen", N, N, BENCH_CLOBBER(&v),              \
+        { zv_zsetlen(v); BENCH_CLOBBER(&v); });                              \
+    BENCH_RUN("zsetlen", "zv_setlenz", N, N, BENCH_CLOBBER(&v),              \
+        { v.len = N - 1; zv_setlenz(v); BENCH_CLOBBER(&v); });               \
+}
+
+/* "GL-4409" plus its terminator needs 8 bytes, so skip the narrow widths. */
+#define SPRINTF_SIZES(X) X(20) X(64) X(256)
+
+#define BENCH_SPRINTF(N)                                                     \
+static void bench_sprintf_##N(void) {                                        \
+    VARCHAR(v, N);                                                           \
+    long amount = 4409;                                                      \
+    BENCH_RUN("sprintf", "sprintf+strlen", N, 0, BENCH_CLOBBER(&amount),     \
+        { snprintf(v.arr, sizeof v.arr, "%s-%ld", "GL", amount);             \
+          v.len = strlen(v.arr); BENCH_CLOBBER(&v); });                      \
+    BENCH_RUN("sprintf", "v_sprintf", N, 0, BENCH_CLOBBER(&amount),          \
+        { v_sprintf(v, "%s-%ld", "GL", amount); BENCH_CLOBBER(&v); });       \
+}
+
+BENCH_SIZES(BENCH_TRIM)
+BENCH_SIZES(BENCH_CASE)
+BENCH_SIZES(BENCH_ZSETLEN)
+SPRINTF_SIZES(BENCH_SPRINTF)
+
+#define CALL_TRIM(N)    bench_trim_##N();
+#define CALL_CASE(N)    bench_case_##N();
+#define CALL_ZSETLEN(N) bench_zsetlen_##N();
+#define CALL_SPRINTF(N) bench_sprintf_##N();
+
+int main(void) {
+    bench_header();
+    BENCH_SIZES(CALL_TRIM)
+    BENCH_SIZES(CALL_CASE)
+    BENCH_SIZES(CALL_ZSETLEN)
+    SPRINTF_SIZES(CALL_SPRINTF)
+    return 0;
+}
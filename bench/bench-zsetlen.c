@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vsuite/zvarchar.h"
+#include "bench.h"
+
+/*
+ * Compare the byte-at-a-time terminator scan that FIND_FIRST_NUL_BYTE used
+ * to expand to against the vector scan behind the macro today.  Field widths
+ * 3 to 64 are the ones declared by the GL interface; the larger sizes show
+ * the throughput of the SSE2 and AVX2 loops.
+ *
+ * Two shapes per size: "last" fills the field and terminates it in the
+ * last byte, "no-nul" has no terminator at all (the issue/002.txt case).
+ */
+
+static char *byte_find_nul(char *arr, size_t max_len) {
+    for (size_t i = 0; i < max_len; ++i)
+        if (arr[i] == '\0')
+            return arr + i;
+    return NULL;
+}
+
+int main(void) {
+    static const size_t sizes[] = { 3, 5, 6, 7, 15, 20, 64, 256, 4096, 32768 };
+    char *buf = malloc(32768);
+    if (!buf)
+        return 1;
+
+    bench_header();
+    for (size_t k = 0; k < sizeof sizes / sizeof sizes[0]; k++) {
+        size_t n = sizes[k];
+        for (int shape = 0; shape < 2; shape++) {
+            memset(buf, 'A', n);
+            if (shape == 0)
+                buf[n - 1] = '\0';
+            BENCH_RUN("findnul", shape ? "byte loop no-nul" : "byte loop last",
+                      n, n, BENCH_CLOBBER(buf),
+                      { char *p = byte_find_nul(buf, n); BENCH_CLOBBER(p); });
+            BENCH_RUN("findnul", shape ? "FIND_FIRST_NUL_BYTE no-nul"
+                                       : "FIND_FIRST_NUL_BYTE last",
+                      n, n, BENCH_CLOBBER(buf),
+                      { char *p = FIND_FIRST_NUL_BYTE(buf, n); BENCH_CLOBBER(p); });
+        }
+    }
+    free(buf);
+    return 0;
+}
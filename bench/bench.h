@@ -0,0 +1,219 @@
+#ifndef VSUITE_BENCH_H
+#define VSUITE_BENCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifdef __linux__
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Shared timing harness for the bench-* programs.
+ *
+ * Each measurement runs a statement in a tight loop and prints one row:
+ *
+ *     family  variant  size  ns/op  bytes/cycle
+ *
+ * ``variant`` is either the VSuite macro or the raw ``strcpy``/``strlen``
+ * code it replaces, so the two rows of a pair can be compared directly.
+ * Cycles come from the time stamp counter on x86 (a constant-rate clock, not
+ * core cycles); elsewhere bytes/cycle is reported as bytes/ns.
+ *
+ * With BENCH_PERF=1 in the environment each row also reports hardware
+ * counters per op, read with ``perf_event_open``: core cycles,
+ * instructions, branch misses, L1d read misses and last level cache read
+ * misses.  Only user-space events of the process are counted, which
+ * perf_event_paranoid up to 2 allows.  A counter that cannot be opened
+ * prints ``-``; when none can, a note goes to stderr and the rows keep the
+ * plain format.
+ */
+
+/* BENCH_SIZES() - VARCHAR widths timed by every family. */
+#define BENCH_SIZES(X) X(3) X(7) X(20) X(64) X(256) X(2000)
+
+/* Keep the compiler from hoisting or discarding work inside the loop. */
+#define BENCH_CLOBBER(p) __asm__ volatile("" : : "g"(p) : "memory")
+
+static inline double bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static inline unsigned long long bench_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (unsigned long long)bench_now_ns();
+#endif
+}
+
+/* Hardware counters reported with BENCH_PERF=1, in column order. */
+enum { BENCH_CYCLES, BENCH_INSNS, BENCH_BRMISS, BENCH_L1MISS, BENCH_LLCMISS,
+       BENCH_NPERF };
+
+/* bench_perf_t - Counter values; zero for counters that are not open. */
+typedef struct {
+    unsigned long long v[BENCH_NPERF];
+} bench_perf_t;
+
+/* Descriptors of the open counters, -1 if not; on is 1 with any open. */
+static int bench_perf_fd[BENCH_NPERF] = { -1, -1, -1, -1, -1 };
+static int bench_perf_on;
+
+/*
+ * bench_perf_init() - Open the counters when BENCH_PERF is set.  Returns
+ * nonzero when at least one is open.
+ */
+static inline int bench_perf_init(void)
+{
+    const char *env = getenv("BENCH_PERF");
+    if (!env || !*env || !strcmp(env, "0"))
+        return 0;
+#ifdef __linux__
+    static const struct { unsigned type; unsigned long long config; } ev[BENCH_NPERF] = {
+        [BENCH_CYCLES]  = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        [BENCH_INSNS]   = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        [BENCH_BRMISS]  = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+        [BENCH_L1MISS]  = { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                            PERF_COUNT_HW_CACHE_OP_READ << 8 |
+                            PERF_COUNT_HW_CACHE_RESULT_MISS << 16 },
+        [BENCH_LLCMISS] = { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL |
+                            PERF_COUNT_HW_CACHE_OP_READ << 8 |
+                            PERF_COUNT_HW_CACHE_RESULT_MISS << 16 },
+    };
+    int err = 0;
+    for (int i = 0; i < BENCH_NPERF; i++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof attr);
+        attr.size = sizeof attr;
+        attr.type = ev[i].type;
+        attr.config = ev[i].config;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                           PERF_FORMAT_TOTAL_TIME_RUNNING;
+        bench_perf_fd[i] = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        if (bench_perf_fd[i] >= 0)
+            bench_perf_on = 1;
+        else if (!err)
+            err = errno;
+    }
+    if (!bench_perf_on) {
+        char level[16] = "?";
+        FILE *f = fopen("/proc/sys/kernel/perf_event_paranoid", "r");
+        if (f) {
+            if (fscanf(f, "%15s", level) != 1)
+                strcpy(level, "?");
+            fclose(f);
+        }
+        fprintf(stderr, "bench: hardware counters unavailable: %s "
+                "(perf_event_paranoid %s)\n", strerror(err), level);
+    }
+#else
+    fprintf(stderr, "bench: hardware counters need Linux perf_event_open\n");
+#endif
+    return bench_perf_on;
+}
+
+/*
+ * bench_perf_read() - Current counter values, scaled up for the time a
+ * counter was multiplexed out.
+ */
+static inline void bench_perf_read(bench_perf_t *p)
+{
+    memset(p, 0, sizeof *p);
+#ifdef __linux__
+    for (int i = 0; bench_perf_on && i < BENCH_NPERF; i++) {
+        unsigned long long r[3];
+        if (bench_perf_fd[i] < 0 ||
+            read(bench_perf_fd[i], r, sizeof r) != (ssize_t)sizeof r)
+            continue;
+        p->v[i] = r[2] && r[2] < r[1] ? (unsigned long long)((double)r[0] * r[1] / r[2])
+                                      : r[0];
+    }
+#endif
+}
+
+/* Target roughly this much wall time per row. */
+#ifndef BENCH_TARGET_NS
+#define BENCH_TARGET_NS 20e6
+#endif
+
+static inline void bench_header(void)
+{
+    printf("%-10s %-28s %6s %10s %12s",
+           "family", "variant", "size", "ns/op", "bytes/cycle");
+    if (bench_perf_init())
+        printf(" %10s %10s %10s %10s %10s",
+               "cyc/op", "ins/op", "brmiss/op", "L1miss/op", "LLCmiss/op");
+    putchar('\n');
+}
+
+static inline void bench_report(const char *family, const char *variant,
+                                size_t size, size_t bytes, long reps,
+                                double ns, unsigned long long cycles,
+                                const bench_perf_t *p0, const bench_perf_t *p1)
+{
+    double per_op = ns / reps;
+    double bpc = cycles ? (double)bytes * reps / cycles : 0.0;
+    printf("%-10s %-28s %6zu %10.2f %12.3f",
+           family, variant, size, per_op, bpc);
+    for (int i = 0; bench_perf_on && i < BENCH_NPERF; i++) {
+        if (bench_perf_fd[i] < 0)
+            printf(" %10s", "-");
+        else
+            printf(" %10.2f", (double)(p1->v[i] - p0->v[i]) / reps);
+    }
+    putchar('\n');
+}
+
+/*
+ * BENCH_RUN() - Time @stmt and print a result row.
+ * @family:  Macro family (copy, cat, trim, ...).
+ * @variant: Label for the code being timed.
+ * @size:    Declared VARCHAR width.
+ * @bytes:   Payload bytes processed per execution of @stmt.
+ * @setup:   Statement run before every execution; it is timed too, so use
+ *           the same setup for both rows of a pair.
+ * @stmt:    Statement to time.
+ *
+ * A short calibration pass picks the repetition count so every row takes
+ * about BENCH_TARGET_NS regardless of size.  The counters are read outside
+ * the timed region and include @setup, like the timings.
+ */
+#define BENCH_RUN(family, variant, size, bytes, setup, stmt)               \
+    do {                                                                   \
+        long __reps = 1000;                                                \
+        double __t0 = bench_now_ns();                                      \
+        for (long __r = 0; __r < __reps; __r++) { setup; stmt; }           \
+        double __cal = bench_now_ns() - __t0;                              \
+        if (__cal > 0)                                                     \
+            __reps = (long)(__reps * (BENCH_TARGET_NS / __cal));           \
+        if (__reps < 1000)                                                 \
+            __reps = 1000;                                                 \
+        bench_perf_t __p0, __p1;                                           \
+        bench_perf_read(&__p0);                                            \
+        unsigned long long __c0 = bench_cycles();                          \
+        __t0 = bench_now_ns();                                             \
+        for (long __r = 0; __r < __reps; __r++) { setup; stmt; }           \
+        double __ns = bench_now_ns() - __t0;                               \
+        unsigned long long __c1 = bench_cycles();                          \
+        bench_perf_read(&__p1);                                            \
+        bench_report(family, variant, size, bytes, __reps, __ns,           \
+                     __c1 - __c0, &__p0, &__p1);                           \
+    } while (0)
+
+#endif /* VSUITE_BENCH_H */
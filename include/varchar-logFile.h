@@ -4,19 +4,40 @@
 #include <stdio.h>
 
 #include <vsuite.h>
+#include <vsuite/diag.h>
 
 /* Required log destination used by the debugging wrappers.
  * It might be stderr or an actual file.  It should be unbuffered to ensure
  * that messages are written immediately to preclude loss of information
  * in case of a crash.
+ *
+ * With VSUITE_LOG_ASYNC defined the messages are queued instead and written
+ * by a background thread (see <vsuite/logring.h>), which also flushes them
+ * at exit and on fatal signals; link with -pthread.  Call vs_log_flush()
+ * before writing to logFile directly.
+ *
+ * Every diagnostic site logs its first VS_DIAG_LIMIT occurrences in full and
+ * then only counts them; the counts are summarised at exit (see
+ * <vsuite/diag.h>).
  */
 extern FILE *logFile;
 
+#ifdef VSUITE_LOG_ASYNC
+#include <vsuite/logring.h>
+#define VARCHAR_LOG_WRITE(fmt, ...) vs_log_printf(logFile, fmt, ##__VA_ARGS__)
+#else
+#define VARCHAR_LOG_WRITE(fmt, ...) fprintf(logFile, fmt, ##__VA_ARGS__)
+#endif
+
+/* Each call site logs its first VS_DIAG_LIMIT messages, then only counts. */
+#define VARCHAR_LOG(fmt, ...) \
+    VS_DIAG_LIMITED(fmt, VARCHAR_LOG_WRITE(fmt, ##__VA_ARGS__))
+
 #define VARCHAR_v_valid(v)                                        \
     ({                                                            \
         size_t capacity = V_SIZE(v);                              \
         if ((v).len > capacity) {                                 \
-            fprintf(logFile,                                      \
+            VARCHAR_LOG(                                          \
                     "Line %d : v_valid(%s) overflow : .len %u > %lu c-string capacity\n\n", \
                     __LINE__, #v, (v).len, capacity);             \
         }                                                         \
@@ -27,12 +48,12 @@ extern FILE *logFile;
     ({                                                            \
         size_t capacity = ZV_CAPACITY(v);                         \
         if ((v).len > capacity) {                                 \
-            fprintf(logFile,                                      \
+            VARCHAR_LOG(                                          \
                     "Line %d : zv_valid(%s) overflow : .len %u > %lu c-string capacity\n\n", \
                     __LINE__, #v, (v).len, capacity);             \
         } else {                                                  \
             if (V_BUF(v)[(v).len] != '\0') {                      \
-                fprintf(logFile,                                  \
+                VARCHAR_LOG(                                      \
                     "Line %d : zv_valid(%s) : c-string not zero-byte terminated\n\n", \
                     __LINE__, #v);                                \
             }                                                     \
@@ -51,11 +72,11 @@ extern FILE *logFile;
 #define VARCHAR_SETLENZ(v) \
     do { \
         if ( !v_valid(v)) { \
-            fprintf(logFile,"Line %d : VARCHAR_SETLENZ:  %s : length %u exceeds allocated size %lu\n\n", \
+            VARCHAR_LOG("Line %d : VARCHAR_SETLENZ:  %s : length %u exceeds allocated size %lu\n\n", \
                 __LINE__, #v, (v).len, sizeof((v).arr)); \
         } else { \
             if ( !v_has_unused_capacity(v, 1)) { \
-                fprintf(logFile,"Line %d : VARCHAR_SETLENZ:  %s does not have an unused byte for the string terminator\n\n", \
+                VARCHAR_LOG("Line %d : VARCHAR_SETLENZ:  %s does not have an unused byte for the string terminator\n\n", \
                     __LINE__, #v); \
             } \
         } \
@@ -63,24 +84,8 @@ extern FILE *logFile;
     } while (0)
 
 /*
- * FIND_FIRST_NUL_BYTE() - Locate the first NUL in ``arr``.
- * @arr:     Character array to scan.
- * @max_len: Maximum number of bytes to examine.
- *
- * Returns a pointer to the first ``'\0'`` within the given range or ``NULL``
- * when none is present.
+ * FIND_FIRST_NUL_BYTE() is provided by <vsuite/zvarchar.h>.
  */
-#define FIND_FIRST_NUL_BYTE(arr,max_len)       \
-    ({                                         \
-        char * found = NULL;                   \
-        for (size_t i = 0; i < max_len; ++i) { \
-            if (arr[i] == '\0') {              \
-                found = arr + i;               \
-                break;                         \
-            }                                  \
-        }                                      \
-        found;                                 \
-    })
 
 /*
  * VARCHAR_ZSETLEN() - Determine the length of a NUL terminated VARCHAR.
@@ -93,15 +98,17 @@ extern FILE *logFile;
  */
 #define VARCHAR_ZSETLEN(v)                     \
     {                                          \
+        VS_PROFILE_BEGIN("VARCHAR_ZSETLEN");   \
         unsigned siz = sizeof((v).arr);        \
         char *nul = FIND_FIRST_NUL_BYTE((v).arr, siz); \
         if (nul == NULL) {                     \
-            fprintf(logFile, "Line %d : VARCHAR_ZSETLEN(%s) : No NUL byte found within %u sizeof(.arr) bytes : value '%s'\n",\
+            VARCHAR_LOG("Line %d : VARCHAR_ZSETLEN(%s) : No NUL byte found within %u sizeof(.arr) bytes : value '%s'\n",\
                     __LINE__, #v, siz, (v).arr); \
             nul = (v).arr + siz - 1; /* point to the last byte */ \
         }                                       \
         (v).len = (unsigned short)((unsigned long)nul - (unsigned long)(v).arr); \
         (v).arr[(v).len] = '\0';                  \
+        VS_PROFILE_END();                         \
     }
 
 /*
@@ -117,7 +124,7 @@ extern FILE *logFile;
         VARCHAR_v_valid(src);                                     \
         unsigned siz = V_SIZE(dst);                               \
         if (siz < (src).len) {                                    \
-            fprintf(logFile,                                      \
+            VARCHAR_LOG(                                          \
                     "Line %d : v_copy(%s, %s) overflow : destination capacity %u < %u source length\n\n", \
                     __LINE__, #dst, #src, siz, (src).len);        \
         }                                                         \
@@ -137,7 +144,7 @@ extern FILE *logFile;
         VARCHAR_zv_valid(src);                                    \
         unsigned cap = ZV_CAPACITY(dst);                          \
         if ( cap < (src).len) {                                   \
-            fprintf(logFile,                                      \
+            VARCHAR_LOG(                                          \
                     "Line %d : zv_copy(%s, %s) overflow : destination c-string capacity %u < %u source length\n\n", \
                     __LINE__, #dst, #src, cap, (src).len);        \
         }                                                         \
@@ -157,7 +164,7 @@ extern FILE *logFile;
         unsigned len = strlen(src);                               \
         unsigned cap = ZV_CAPACITY(dst);                          \
         if ( cap < len) {                                         \
-            fprintf(logFile,                                      \
+            VARCHAR_LOG(                                          \
                     "Line %d : zvp_copy(%s, %s) overflow : destination c-string capacity %u < %u source length\n\n", \
                     __LINE__, #dst, #src, cap, len);              \
         }                                                         \
@@ -180,7 +187,7 @@ extern FILE *logFile;
         unsigned capacity = ZV_CAPACITY(v);                        \
         int n = v_sprintf_fcn(V_BUF(v), capacity, &(v).len, fmt, ##__VA_ARGS__); \
         if (varchar_overflow > 0) {                                \
-            fprintf(logFile,                                       \
+            VARCHAR_LOG(                                           \
                     "Line %d : sprintf(%s,...) overflow : length %lu exceeds allocated size %lu\n\n", \
                     __LINE__, #v, V_SIZE(v)+varchar_overflow, V_SIZE(v)); \
         } \
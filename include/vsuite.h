@@ -11,4 +11,21 @@
 
 #include <vsuite/string.h>      // Fixed allocation C-string manipulation macros
 
+#include <vsuite/batch.h>       // Operations over Pro*C host arrays of VARCHAR
+#include <vsuite/column.h>      // Columnar (struct-of-arrays) VARCHAR buffers
+#include <vsuite/arena.h>       // Arena allocator and arena-backed dv_ conversions
+#include <vsuite/intern.h>      // String interning for low-cardinality codes
+#include <vsuite/number.h>      // Numeric parsing and formatting of VARCHAR
+#include <vsuite/builder.h>     // Typed append builder replacing v_sprintf
+#include <vsuite/concat.h>      // Multi-source VARCHAR concatenation
+#include <vsuite/search.h>      // Length-bounded byte and substring search
+#include <vsuite/charset.h>     // Precompiled sets for strspn/strcspn/strpbrk
+#include <vsuite/compare.h>     // Length-aware and case-insensitive comparison
+#include <vsuite/hash.h>        // 64-bit hashing of VARCHAR contents and keys
+#include <vsuite/map.h>         // Open-addressing hash map keyed by VARCHAR
+#include <vsuite/groupby.h>     // Hash group-by aggregation over VARCHAR keys
+#include <vsuite/diag.h>        // Per-call-site limits for diagnostics
+#include <vsuite/telemetry.h>   // Per-call-site overflow telemetry (VSUITE_TELEMETRY)
+#include <vsuite/profile.h>     // Per-call-site latency histograms (VSUITE_PROFILE)
+
 #endif /* VSUITE_H */
@@ -0,0 +1,205 @@
+#ifndef VSUITE_ARENA_H
+#define VSUITE_ARENA_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+#include <vsuite/varchar.h>
+
+/*
+ * Arena (bump) allocator for the dynamic conversions.
+ *
+ * Report code duplicates many fields per row and frees them all together.
+ * An arena hands out memory by advancing a pointer through a chunk and
+ * releases everything at once:
+ *
+ *     vs_arena_t *a = vs_arena_create(16384);
+ *     while (fetch_row()) {
+ *         char *name = dv_arena_dup(a, ename);
+ *         ...
+ *         vs_arena_reset(a);
+ *     }
+ *     printf("peak %zu bytes\n", vs_arena_high_water(a));
+ *     vs_arena_destroy(a);
+ *
+ * When a chunk runs out a new one is chained on; the next reset replaces
+ * the chain with a single chunk large enough for the peak so far, so a
+ * steady workload settles on one chunk and no mallocs per batch.
+ */
+
+/* Alignment of vs_arena_alloc() results. */
+#define VS_ARENA_ALIGN 16
+
+typedef struct vs_arena_chunk {
+    struct vs_arena_chunk *next;        /* older chunk */
+    size_t size;
+    char data[];
+} vs_arena_chunk_t;
+
+/*
+ * vs_arena_t - Arena state.
+ * @head:       Current chunk; older chunks follow ``next``.
+ * @ptr:        Next free byte of @head.
+ * @end:        One past the last byte of @head.
+ * @used:       Bytes handed out since the last reset, counting each aligned
+ *              block as if it needed the worst-case padding, so that a
+ *              chunk of this size always holds the same allocations.
+ * @high_water: Largest @used seen since the arena was created.
+ * @chunk_size: Size of the next chunk to allocate.
+ */
+typedef struct {
+    vs_arena_chunk_t *head;
+    char *ptr, *end;
+    size_t used;
+    size_t high_water;
+    size_t chunk_size;
+} vs_arena_t;
+
+/* vs_arena_new_chunk() - Chain a chunk of at least @n bytes onto @a. */
+static inline int vs_arena_new_chunk(vs_arena_t *a, size_t n)
+{
+    size_t size = n > a->chunk_size ? n : a->chunk_size;
+    vs_arena_chunk_t *c = malloc(sizeof *c + size);
+    if (!c)
+        return -1;
+    c->next = a->head;
+    c->size = size;
+    a->head = c;
+    a->ptr = c->data;
+    a->end = c->data + size;
+    return 0;
+}
+
+/*
+ * vs_arena_create() - Allocate an arena with a first chunk of @size bytes.
+ *
+ * Returns ``NULL`` on allocation failure.
+ */
+static inline vs_arena_t *vs_arena_create(size_t size)
+{
+    vs_arena_t *a = calloc(1, sizeof *a);
+    if (!a)
+        return NULL;
+    a->chunk_size = size ? size : 1;
+    if (vs_arena_new_chunk(a, 0) != 0) {
+        free(a);
+        return NULL;
+    }
+    return a;
+}
+
+/* vs_arena_free_chunks() - Release every chunk of @a. */
+static inline void vs_arena_free_chunks(vs_arena_t *a)
+{
+    vs_arena_chunk_t *c = a->head;
+    while (c) {
+        vs_arena_chunk_t *next = c->next;
+        free(c);
+        c = next;
+    }
+    a->head = NULL;
+    a->ptr = a->end = NULL;
+}
+
+/* vs_arena_destroy() - Release @a and everything allocated from it. */
+static inline void vs_arena_destroy(vs_arena_t *a)
+{
+    if (!a)
+        return;
+    vs_arena_free_chunks(a);
+    free(a);
+}
+
+/*
+ * vs_arena_reset() - Release every allocation at once, keeping the memory.
+ *
+ * If the last batch needed more than one chunk they are replaced by a single
+ * chunk the size of the high-water mark.
+ */
+static inline void vs_arena_reset(vs_arena_t *a)
+{
+    if (a->head && a->head->next) {
+        vs_arena_free_chunks(a);
+        if (a->high_water > a->chunk_size)
+            a->chunk_size = a->high_water;
+        (void)vs_arena_new_chunk(a, 0);     /* retried by the next alloc */
+    }
+    if (a->head) {
+        a->ptr = a->head->data;
+        a->end = a->head->data + a->head->size;
+    }
+    a->used = 0;
+}
+
+/*
+ * vs_arena_take() - Hand out @n bytes aligned to @align, a power of two.
+ * Chains a new chunk when the current one is full.
+ */
+static inline char *vs_arena_take(vs_arena_t *a, size_t n, size_t align)
+{
+    size_t pad = (size_t)(-(uintptr_t)a->ptr & (align - 1));
+    if (a->ptr == NULL || n + pad > (size_t)(a->end - a->ptr)) {
+        if (vs_arena_new_chunk(a, n + align - 1) != 0)
+            return NULL;
+        pad = (size_t)(-(uintptr_t)a->ptr & (align - 1));
+    }
+    char *p = a->ptr + pad;
+    a->ptr = p + n;
+    a->used += n + align - 1;
+    if (a->used > a->high_water)
+        a->high_water = a->used;
+    return p;
+}
+
+/*
+ * vs_arena_alloc() - Allocate @n bytes aligned to VS_ARENA_ALIGN.
+ *
+ * Returns ``NULL`` on allocation failure.  The memory stays valid until the
+ * next vs_arena_reset() or vs_arena_destroy().
+ */
+static inline void *vs_arena_alloc(vs_arena_t *a, size_t n)
+{
+    return vs_arena_take(a, n, VS_ARENA_ALIGN);
+}
+
+/* vs_arena_strndup() - Copy @n bytes of @s into @a with a terminator. */
+static inline char *vs_arena_strndup(vs_arena_t *a, const char *s, size_t n)
+{
+    char *d = vs_arena_take(a, n + 1, 1);
+    if (!d)
+        return NULL;
+    vs_copy(d, s, n, (size_t)-1);
+    d[n] = '\0';
+    return d;
+}
+
+/* vs_arena_used() - Bytes handed out since the last reset. */
+static inline size_t vs_arena_used(const vs_arena_t *a) { return a->used; }
+
+/*
+ * vs_arena_high_water() - Largest vs_arena_used() seen since creation.
+ *
+ * Creating the arena with this size lets every batch fit in one chunk.
+ */
+static inline size_t vs_arena_high_water(const vs_arena_t *a)
+{
+    return a->high_water;
+}
+
+/*
+ * dv_arena_dup() - dv_dup() into arena @a instead of ``malloc``.
+ *
+ * Returns a NUL terminated copy of @v, or ``NULL`` on allocation failure.
+ * The copy is released by vs_arena_reset(), not ``free``.
+ */
+#define dv_arena_dup(a, v) vs_arena_strndup((a), V_BUF(v), V_LEN(v))
+
+/*
+ * dp_arena_dup() - ``strdup`` of the C string @p into arena @a.
+ */
+#define dp_arena_dup(a, p) \
+    ({ const char *__p = (p); vs_arena_strndup((a), __p, strlen(__p)); })
+
+#endif /* VSUITE_ARENA_H */
@@ -0,0 +1,373 @@
+#ifndef VSUITE_BATCH_H
+#define VSUITE_BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <vsuite/varchar.h>
+#include <vsuite/simd.h>
+
+/*
+ * Host-array batch macros (``vb_`` prefix).
+ *
+ * Pro*C array fetches fill an array of VARCHAR structures, one element per
+ * row:
+ *
+ *     VARCHAR(names[1000], 21);
+ *     EXEC SQL FETCH c1 INTO :names;
+ *     vb_zsetlen(names, sqlca.sqlerrd[2]);
+ *
+ * Each macro runs one operation over the first @count elements of the
+ * array.  The element stride and width are compile-time constants, so the
+ * row kernel is chosen once for the whole loop.  Elements no wider than a
+ * vector are processed with a single load per row: the load may run into
+ * the next element, which is part of the same array, so only the last few
+ * rows fall back to the bounded per-row kernels.  Diagnostics are
+ * summarised once per call rather than once per row.
+ */
+
+#if defined(VS_HAVE_SSE2)
+#define VB_WIDE_MAX 16
+#elif defined(VS_SWAR_LE)
+#define VB_WIDE_MAX 8
+#else
+#define VB_WIDE_MAX 0
+#endif
+
+/*
+ * Narrowest element for which vb_rtrim() and vb_upper()/vb_lower() use the
+ * single-load kernels; below it the scalar per-row kernels are faster.
+ */
+#ifndef VB_WIDE_MIN
+#define VB_WIDE_MIN 4
+#endif
+
+/* Distance ahead of the current row to prefetch, in bytes. */
+#ifndef VB_PREFETCH_BYTES
+#define VB_PREFETCH_BYTES 512
+#endif
+
+/*
+ * VB_ARGS() - Expand a VARCHAR array into the base, stride, ``arr`` offset
+ * and width taken by the vb_*_fcn() kernels.  ``len`` is always the first
+ * member of a VARCHAR, so it sits at the start of each element.
+ */
+#define VB_ARGS(a) \
+    (char *)&(a)[0], sizeof((a)[0]), offsetof(typeof((a)[0]), arr), V_SIZE((a)[0])
+
+#define VB_LEN(row) (*(unsigned short *)(row))
+
+/*
+ * vb_prefetch() - Prefetch the row VB_PREFETCH_BYTES (or one stride) ahead.
+ * The address may lie past the array; prefetches never fault, and the
+ * integer arithmetic keeps the compiler from treating it as an access.
+ */
+static inline void vb_prefetch(const char *row, size_t stride)
+{
+    uintptr_t ahead = (uintptr_t)row +
+        (stride > VB_PREFETCH_BYTES ? stride : VB_PREFETCH_BYTES);
+    __builtin_prefetch((const void *)ahead, 1);
+}
+
+/*
+ * vb_wide_rows() - Number of leading rows whose VB_WIDE_MAX byte load from
+ * ``arr`` stays inside the first @count elements, or 0 when @size is outside
+ * [@min, VB_WIDE_MAX].
+ */
+static inline __attribute__((always_inline))
+size_t vb_wide_rows(size_t stride, size_t off, size_t size, size_t count,
+                    size_t min)
+{
+    size_t end = count * stride;
+    if (VB_WIDE_MAX == 0 || size < min || size > VB_WIDE_MAX ||
+        off + VB_WIDE_MAX > end)
+        return 0;
+    size_t n = (end - off - VB_WIDE_MAX) / stride + 1;
+    return n < count ? n : count;
+}
+
+static inline __attribute__((always_inline))
+uint64_t vb_low_bytes64(size_t n)
+{
+    return n >= 8 ? ~0ULL : (1ULL << (n * 8)) - 1;
+}
+
+/*
+ * Single-load row kernels.  Each reads VB_WIDE_MAX bytes from @p and only
+ * looks at, or writes, the first @size of them.
+ */
+#if VB_WIDE_MAX > 0
+
+/* vb_row_find_nul() - Offset of the first NUL in p[0..size), or @size. */
+static inline __attribute__((always_inline))
+size_t vb_row_find_nul(const char *p, size_t size)
+{
+#ifdef VS_HAVE_SSE2
+    __m128i x = _mm_loadu_si128((const __m128i *)p);
+    unsigned m = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_setzero_si128()));
+    m &= (1U << size) - 1;
+    return m ? (size_t)__builtin_ctz(m) : size;
+#else
+    uint64_t m = vs_zero_bytes64(vs_load64(p)) & vb_low_bytes64(size);
+    return m ? (size_t)(__builtin_ctzll(m) >> 3) : size;
+#endif
+}
+
+/* vb_row_rspan_space() - vs_rspan_space() of p[0..n). */
+static inline __attribute__((always_inline))
+size_t vb_row_rspan_space(const char *p, size_t n)
+{
+#ifdef VS_HAVE_SSE2
+    unsigned m = vs_nonspace_mask16(_mm_loadu_si128((const __m128i *)p));
+    m &= (1U << n) - 1;
+    return m ? (size_t)(32 - __builtin_clz(m)) : 0;
+#else
+    uint64_t m = ~vs_space_word(vs_load64(p)) & VS_HIGHS64 & vb_low_bytes64(n);
+    return m ? (size_t)((63 - __builtin_clzll(m)) >> 3) + 1 : 0;
+#endif
+}
+
+/*
+ * vb_row_case() - Convert p[0..n) like vs_case().  Only p[0..size) is
+ * stored back, so the next row's bytes are never rewritten, and rows that
+ * are already in the target case are not stored at all.
+ */
+static inline __attribute__((always_inline))
+void vb_row_case(char *p, size_t n, size_t size, unsigned char lo)
+{
+#ifdef VS_HAVE_SSE2
+    const __m128i idx = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                      8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i x = _mm_loadu_si128((const __m128i *)p);
+    __m128i y = vs_case_sse2_vec(x, _mm_set1_epi8((char)(0x80 - lo)),
+                                 _mm_set1_epi8((char)(-128 + 26)),
+                                 _mm_set1_epi8(0x20));
+    __m128i keep = _mm_cmpgt_epi8(_mm_set1_epi8((char)n), idx);
+    __m128i flip = _mm_and_si128(_mm_xor_si128(x, y), keep);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(flip, _mm_setzero_si128())) == 0xFFFF)
+        return;
+    char out[16];
+    _mm_storeu_si128((__m128i *)out, _mm_xor_si128(x, flip));
+    memcpy(p, out, size < sizeof out ? size : sizeof out);
+#else
+    uint64_t w = vs_load64(p);
+    uint64_t flip = (w ^ vs_case_word(w, lo)) & vb_low_bytes64(n);
+    if (flip == 0)
+        return;
+    uint64_t out = w ^ flip;
+    memcpy(p, &out, size < sizeof out ? size : sizeof out);
+#endif
+}
+
+#endif /* VB_WIDE_MAX > 0 */
+
+/* vb_zsetlen_fcn() - Kernel behind vb_zsetlen(). */
+static inline __attribute__((always_inline))
+size_t vb_zsetlen_fcn(char *base, size_t stride, size_t off, size_t size,
+                      size_t count, size_t *first)
+{
+    size_t i = 0, bad = 0;
+#if VB_WIDE_MAX > 0
+    for (size_t wide = vb_wide_rows(stride, off, size, count, 1); i < wide; i++) {
+        char *row = base + i * stride;
+        vb_prefetch(row, stride);
+        size_t pos = vb_row_find_nul(row + off, size);
+        if (pos == size) {
+            if (bad++ == 0)
+                *first = i;
+            pos = size - 1;
+        }
+        row[off + pos] = '\0';
+        VB_LEN(row) = (unsigned short)pos;
+    }
+#endif
+    for (; i < count; i++) {
+        char *row = base + i * stride;
+        char *nul = vs_find_nul(row + off, size);
+        if (nul == NULL) {
+            if (bad++ == 0)
+                *first = i;
+            nul = row + off + size - 1;
+        }
+        *nul = '\0';
+        VB_LEN(row) = (unsigned short)(nul - (row + off));
+    }
+    return bad;
+}
+
+/* vb_setlenz_fcn() - Kernel behind vb_setlenz(). */
+static inline __attribute__((always_inline))
+size_t vb_setlenz_fcn(char *base, size_t stride, size_t off, size_t size,
+                      size_t count, size_t *first)
+{
+    size_t bad = 0;
+    for (size_t i = 0; i < count; i++) {
+        char *row = base + i * stride;
+        vb_prefetch(row, stride);
+        size_t len = VB_LEN(row);
+        if (len >= size) {
+            if (bad++ == 0)
+                *first = i;
+            len = size - 1;
+            VB_LEN(row) = (unsigned short)len;
+        }
+        row[off + len] = '\0';
+    }
+    return bad;
+}
+
+/* vb_rtrim_fcn() - Kernel behind vb_rtrim(). */
+static inline __attribute__((always_inline))
+void vb_rtrim_fcn(char *base, size_t stride, size_t off, size_t size,
+                  size_t count)
+{
+    size_t i = 0;
+#if VB_WIDE_MAX > 0
+    for (size_t wide = vb_wide_rows(stride, off, size, count, VB_WIDE_MIN); i < wide; i++) {
+        char *row = base + i * stride;
+        size_t len = VB_LEN(row);
+        VB_LEN(row) = (unsigned short)
+            vb_row_rspan_space(row + off, len < size ? len : size);
+    }
+#endif
+    for (; i < count; i++) {
+        char *row = base + i * stride;
+        size_t len = VB_LEN(row);
+        VB_LEN(row) = (unsigned short)
+            vs_rspan_space(row + off, len < size ? len : size);
+    }
+}
+
+/* vb_case_fcn() - Kernel behind vb_upper() and vb_lower(). */
+static inline __attribute__((always_inline))
+void vb_case_fcn(char *base, size_t stride, size_t off, size_t size,
+                 size_t count, unsigned char lo)
+{
+    size_t i = 0;
+#if VB_WIDE_MAX > 0
+    for (size_t wide = vb_wide_rows(stride, off, size, count, VB_WIDE_MIN); i < wide; i++) {
+        char *row = base + i * stride;
+        size_t len = VB_LEN(row);
+        vb_row_case(row + off, len < size ? len : size, size, lo);
+    }
+#endif
+    for (; i < count; i++) {
+        char *row = base + i * stride;
+        size_t len = VB_LEN(row);
+        vs_case(row + off, len < size ? len : size, lo);
+    }
+}
+
+/*
+ * vb_zsetlen() - Apply zv_zsetlen() to @count elements of @a.
+ * @a:     Array of VARCHAR.
+ * @count: Number of elements to process.
+ *
+ * Each ``len`` is set to the offset of the element's first ``'\0'``.  An
+ * element without a terminator is cut to ``V_SIZE - 1`` bytes and
+ * terminated there.  Returns the number of such elements.
+ */
+#define vb_zsetlen(a, count)                                                 \
+    ({                                                                       \
+        size_t __first = 0, __cnt = (count);                                 \
+        size_t __bad = vb_zsetlen_fcn(VB_ARGS(a), __cnt, &__first);          \
+        if (__bad) {                                                         \
+            V_WARN("Line %d : vb_zsetlen(%s) : %zu of %zu elements have no NUL byte within %zu bytes, first at [%zu]", \
+                   __LINE__, #a, __bad, __cnt, V_SIZE((a)[0]), __first);     \
+        }                                                                    \
+        (void)__first;                                                       \
+        __bad;                                                               \
+    })
+
+/*
+ * vb_setlenz() - Apply zv_setlenz() to @count elements of @a.
+ *
+ * Each element is terminated at ``len``.  Elements whose ``len`` leaves no
+ * room for the terminator are truncated to ``V_SIZE - 1``.  Returns the
+ * number of truncated elements.
+ */
+#define vb_setlenz(a, count)                                                 \
+    ({                                                                       \
+        size_t __first = 0, __cnt = (count);                                 \
+        size_t __bad = vb_setlenz_fcn(VB_ARGS(a), __cnt, &__first);          \
+        if (__bad) {                                                         \
+            V_WARN("Line %d : vb_setlenz(%s) : %zu of %zu elements truncated to %zu bytes, first at [%zu]", \
+                   __LINE__, #a, __bad, __cnt, V_SIZE((a)[0]) - 1, __first); \
+        }                                                                    \
+        (void)__first;                                                       \
+        __bad;                                                               \
+    })
+
+/*
+ * vb_rtrim() - Apply v_rtrim() to @count elements of @a.
+ *
+ * Strips trailing whitespace from every element by shortening ``len``.
+ */
+#define vb_rtrim(a, count) vb_rtrim_fcn(VB_ARGS(a), (count))
+
+/*
+ * vb_upper() - Apply v_upper() to @count elements of @a.
+ */
+#define vb_upper(a, count) vb_case_fcn(VB_ARGS(a), (count), 'a')
+
+/*
+ * vb_lower() - Apply v_lower() to @count elements of @a.
+ */
+#define vb_lower(a, count) vb_case_fcn(VB_ARGS(a), (count), 'A')
+
+/*
+ * vb_valid() - Apply v_valid() to @count elements of @a.
+ *
+ * Returns the index of the first element whose ``len`` exceeds its capacity,
+ * or @count when every element is valid.  Only the ``len`` fields are read.
+ */
+#define vb_valid(a, count)                                                   \
+    ({                                                                       \
+        size_t __cnt = (count), __i = 0;                                     \
+        while (__i < __cnt && (a)[__i].len <= V_SIZE((a)[__i]))              \
+            __i++;                                                           \
+        __i;                                                                 \
+    })
+
+/*
+ * vb_copy() - Copy column @src into column @dst, element by element.
+ * @dst:   Destination VARCHAR array.
+ * @src:   Source VARCHAR array.
+ * @count: Number of elements to copy.
+ *
+ * Unlike v_copy(), each destination ``len`` is set to the number of bytes
+ * stored, since a column copy has no single return value to assign from.
+ * Elements that do not fit are truncated.  Returns the total number of bytes
+ * copied; the total number of bytes dropped is left in ``varchar_overflow``.
+ */
+#define vb_copy(dst, src, count) \
+    v_status_publish(vb_copy_st(dst, src, count))
+
+/* vb_copy_st() - vb_copy() reporting a v_status_t instead of varchar_overflow. */
+#define vb_copy_st(dst, src, count)                                          \
+    ({                                                                       \
+        size_t __cnt = (count), __bytes = 0, __ovf = 0, __req = 0;           \
+        for (size_t __i = 0; __i < __cnt; __i++) {                           \
+            vb_prefetch((const char *)&(src)[__i], sizeof((src)[0]));        \
+            size_t __n = (src)[__i].len;                                     \
+            if (__n > __req)                                                 \
+                __req = __n;                                                 \
+            if (__n > V_SIZE((dst)[__i])) {                                  \
+                __ovf += __n - V_SIZE((dst)[__i]);                           \
+                __n = V_SIZE((dst)[__i]);                                    \
+            }                                                                \
+            vs_copy(V_BUF((dst)[__i]), V_BUF((src)[__i]), __n,               \
+                    V_COPY_CAP((dst)[__i], (src)[__i]));                     \
+            (dst)[__i].len = (unsigned short)__n;                            \
+            __bytes += __n;                                                  \
+        }                                                                    \
+        if (__ovf) {                                                         \
+            V_WARN("Line %d : vb_copy(%s, %s) : overflow : %zu bytes dropped over %zu elements", \
+                   __LINE__, #dst, #src, __ovf, __cnt);                      \
+        }                                                                    \
+        VS_TELEMETRY("vb_copy", V_SIZE((dst)[0]), __req, __ovf);             \
+        (v_status_t){ __bytes, __ovf };                                      \
+    })
+
+#endif /* VSUITE_BATCH_H */
@@ -0,0 +1,186 @@
+#ifndef VSUITE_BUILDER_H
+#define VSUITE_BUILDER_H
+
+#include <stdint.h>
+#include <string.h>
+#include <stddef.h>
+
+#include <vsuite/varchar.h>
+#include <vsuite/zvarchar.h>
+#include <vsuite/number.h>
+#include <vsuite/simd.h>
+
+/*
+ * Typed append builder.
+ *
+ * Most v_sprintf() calls only join literals, VARCHARs and integers, yet
+ * ``vsnprintf`` parses the format string on every call.  A builder appends
+ * each piece with a call of the matching type and reports overflow once, for
+ * the whole chain, when it is finished:
+ *
+ *     v_builder_t b = v_build_begin(gl_post_desc);
+ *     v_build_lit(&b, "AP ");
+ *     v_build_v(&b, vendor_num);
+ *     v_build_char(&b, '/');
+ *     v_build_int_pad(&b, line_no, 4);
+ *     v_build_end(gl_post_desc, &b);
+ *
+ * Appends only store the bytes that fit and keep counting the rest, so the
+ * chain needs no checks of its own.  v_build_end() sets ``len`` and
+ * ``varchar_overflow``; zv_build_begin() and zv_build_end() keep room for
+ * the terminator and write it once, at the end.
+ */
+
+/*
+ * v_builder_t - Append state.
+ * @buf: Destination bytes.
+ * @cap: Bytes of @buf that may be written.
+ * @len: Length of everything appended so far, including what did not fit.
+ */
+typedef struct {
+    char *buf;
+    size_t cap;
+    size_t len;
+} v_builder_t;
+
+/* v_build_begin() - Start building into the VARCHAR @v from empty. */
+#define v_build_begin(v) ((v_builder_t){ V_BUF(v), V_SIZE(v), 0 })
+
+/* v_build_continue() - Start building after the current contents of @v. */
+#define v_build_continue(v) ((v_builder_t){ V_BUF(v), V_SIZE(v), V_LEN(v) })
+
+/*
+ * zv_build_begin() - Start building into the zero-terminated VARCHAR @v,
+ * keeping one byte for the terminator.
+ */
+#define zv_build_begin(v) \
+    ((v_builder_t){ V_BUF(v), V_SIZE(v) ? ZV_CAPACITY(v) : 0, 0 })
+
+/* zv_build_continue() - zv_build_begin() after the current contents of @v. */
+#define zv_build_continue(v)                                                 \
+    ({                                                                       \
+        v_builder_t __zb = zv_build_begin(v);                                \
+        __zb.len = V_LEN(v) < __zb.cap ? V_LEN(v) : __zb.cap;                \
+        __zb;                                                                \
+    })
+
+/*
+ * vs_build_put() - Append @n bytes of @s to @b.
+ * @cap: Upper bound on @n known at compile time, passed on to vs_copy().
+ *
+ * When everything fits this is one compare and an inlined copy.
+ */
+static inline __attribute__((always_inline))
+void vs_build_put(v_builder_t *b, const char *s, size_t n, size_t cap)
+{
+    size_t p = b->len;
+    b->len = p + n;
+    if (__builtin_expect(p + n <= b->cap, 1))
+        vs_copy(b->buf + p, s, n, cap);
+    else if (p < b->cap)
+        memcpy(b->buf + p, s, b->cap - p);
+}
+
+/* vs_build_num() - Append a number formatted as by vs_fmt_number(). */
+static inline void vs_build_num(v_builder_t *b, int neg, uint64_t mag,
+                                size_t width, size_t scale)
+{
+    size_t p = b->len < b->cap ? b->len : b->cap;
+    v_status_t st = vs_fmt_number(b->buf + p, b->cap - p, neg, mag, width,
+                                  scale);
+    b->len += st.bytes + st.overflow;
+}
+
+/* v_build_mem() - Append @n bytes of @s. */
+static inline void v_build_mem(v_builder_t *b, const char *s, size_t n)
+{
+    vs_build_put(b, s, n, (size_t)-1);
+}
+
+/* v_build_v() - Append the contents of the VARCHAR @v. */
+#define v_build_v(b, v) vs_build_put((b), V_BUF(v), V_LEN(v), V_SIZE(v))
+
+/* v_build_str() - Append the C string @s. */
+#define v_build_str(b, s) \
+    ({ const char *__s = (s); vs_build_put((b), __s, strlen(__s), (size_t)-1); })
+
+/*
+ * v_build_lit() - Append the string literal @lit.  Its length is a
+ * constant, so the copy is a few fixed moves.
+ */
+#define v_build_lit(b, lit) \
+    vs_build_put((b), "" lit, sizeof(lit) - 1, sizeof(lit) - 1)
+
+/* v_build_char() - Append the byte @c. */
+static inline void v_build_char(v_builder_t *b, char c)
+{
+    if (b->len < b->cap)
+        b->buf[b->len] = c;
+    b->len++;
+}
+
+/* v_build_int() - Append the decimal text of the signed integer @n. */
+#define v_build_int(b, n) \
+    ({ long long __x = (n); vs_build_num((b), __x < 0, vs_fmt_abs(__x), 0, 0); })
+
+/* v_build_uint() - Append the decimal text of the unsigned integer @n. */
+#define v_build_uint(b, n) \
+    vs_build_num((b), 0, (unsigned long long)(n), 0, 0)
+
+/* v_build_int_pad() - Append @n zero padded to @width, as v_from_int_pad(). */
+#define v_build_int_pad(b, n, width)                                         \
+    ({ long long __x = (n);                                                  \
+       vs_build_num((b), __x < 0, vs_fmt_abs(__x), (width), 0); })
+
+/* v_build_decimal() - Append the fixed-point @n, as v_from_decimal(). */
+#define v_build_decimal(b, n, scale)                                         \
+    ({ long long __x = (n);                                                  \
+       vs_build_num((b), __x < 0, vs_fmt_abs(__x), 0, (scale)); })
+
+/*
+ * v_build_end() - Finish the builder @b over the VARCHAR @v.
+ *
+ * Sets ``v.len`` to the bytes stored, records the bytes that did not fit in
+ * ``varchar_overflow`` and returns the stored length.
+ */
+#define v_build_end(v, b) v_status_publish(v_build_end_st(v, b))
+
+/* v_build_end_st() - v_build_end() reporting a v_status_t instead of varchar_overflow. */
+#define v_build_end_st(v, b) vs_build_end_st(v, b, "v_build_end", 0)
+
+/*
+ * vs_build_end_st() - Body of v_build_end_st() and zv_build_end_st().  @name
+ * labels the diagnostics; @term is 1 when the builder keeps a byte for the
+ * terminator, which the telemetry counts as required.
+ */
+#define vs_build_end_st(v, b, name, term)                                    \
+    ({                                                                       \
+        const v_builder_t *__b = (b);                                        \
+        size_t __n = __b->len, __ovf = 0;                                    \
+        if (__n > __b->cap) {                                                \
+            __ovf = __n - __b->cap;                                          \
+            V_WARN("Line %d : %s(%s, %s) : overflow : bytes required %zu > %zu capacity", \
+                   __LINE__, name, #v, #b, __n, __b->cap);                   \
+            __n = __b->cap;                                                  \
+        }                                                                    \
+        VS_TELEMETRY(name, V_SIZE(v), __n + __ovf + (term), __ovf);          \
+        (v).len = (unsigned short)__n;                                       \
+        (v_status_t){ __n, __ovf };                                          \
+    })
+
+/*
+ * zv_build_end() - v_build_end() for a builder from zv_build_begin(); also
+ * writes the terminator.
+ */
+#define zv_build_end(v, b) v_status_publish(zv_build_end_st(v, b))
+
+/* zv_build_end_st() - zv_build_end() reporting a v_status_t instead of varchar_overflow. */
+#define zv_build_end_st(v, b)                                                \
+    ({                                                                       \
+        v_status_t __st = vs_build_end_st(v, b, "zv_build_end", 1);          \
+        if (V_SIZE(v) > 0)                                                   \
+            V_BUF(v)[__st.bytes] = '\0';                                     \
+        __st;                                                                \
+    })
+
+#endif /* VSUITE_BUILDER_H */
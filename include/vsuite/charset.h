@@ -0,0 +1,242 @@
+#ifndef VSUITE_CHARSET_H
+#define VSUITE_CHARSET_H
+
+#include <stdint.h>
+#include <string.h>
+#include <stddef.h>
+
+#include <vsuite/varchar.h>
+#include <vsuite/string.h>
+#include <vsuite/search.h>
+#include <vsuite/simd.h>
+
+/*
+ * Precompiled character sets for v_strspn(), v_strcspn() and v_strpbrk().
+ *
+ * ``strspn`` and friends walk the set string again for every byte tested.
+ * A vs_charset_t is built once from the set and then answers membership
+ * with a bitmap lookup, or for 16 or 32 bytes at a time with two nibble
+ * shuffles:
+ *
+ *     static vs_charset_t blanks;
+ *     blanks = vs_charset(" \t");
+ *     size_t lead = v_strspn(gl_desc, &blanks);
+ *
+ * The v_ and zv_ forms scan ``len`` bytes; the s_ forms scan a fixed C
+ * string up to its terminator, bounded by its declared size.
+ */
+
+/*
+ * vs_charset_t - Membership tables for one set of bytes.
+ * @lo:   Byte ``b`` with ``b < 0x80`` is in the set when bit ``b >> 4`` of
+ *        ``lo[b & 15]`` is set.
+ * @hi:   The same for ``b >= 0x80``, bit ``(b >> 4) - 8``.
+ * @bits: 256-bit map, bit ``b`` set when ``b`` is in the set.
+ */
+typedef struct {
+    uint8_t lo[16];
+    uint8_t hi[16];
+    uint64_t bits[4];
+} vs_charset_t;
+
+/* vs_charset_add() - Add the byte @c to @cs. */
+static inline void vs_charset_add(vs_charset_t *cs, unsigned char c)
+{
+    if (c < 0x80)
+        cs->lo[c & 15] |= (uint8_t)(1u << (c >> 4));
+    else
+        cs->hi[c & 15] |= (uint8_t)(1u << ((c >> 4) - 8));
+    cs->bits[c >> 6] |= 1ULL << (c & 63);
+}
+
+/* vs_charset_has() - Nonzero when @c is in @cs. */
+static inline int vs_charset_has(const vs_charset_t *cs, unsigned char c)
+{
+    return (int)(cs->bits[c >> 6] >> (c & 63)) & 1;
+}
+
+/* vs_charset_make() - Set holding the @n bytes of @set; NUL is an ordinary byte. */
+static inline vs_charset_t vs_charset_make(const char *set, size_t n)
+{
+    vs_charset_t cs;
+    memset(&cs, 0, sizeof cs);
+    for (size_t i = 0; i < n; i++)
+        vs_charset_add(&cs, (unsigned char)set[i]);
+    return cs;
+}
+
+/* vs_charset() - Set holding the bytes of the C string @set. */
+#define vs_charset(set) \
+    ({ const char *__set = (set); vs_charset_make(__set, strlen(__set)); })
+
+/* v_charset() - Set holding the bytes of the VARCHAR @v. */
+#define v_charset(v) vs_charset_make((const char *)V_BUF(v), V_LEN(v))
+
+/*
+ * vs_span_scalar() - vs_span() through the bitmap.  Membership of up to 16
+ * bytes is gathered into a mask without branches, so a short field costs
+ * one unpredictable exit instead of one per byte.
+ */
+static inline size_t vs_span_scalar(const char *s, size_t n,
+                                    const vs_charset_t *cs, int in)
+{
+    size_t i = 0;
+    for (; i < n; i += 16) {
+        size_t k = n - i < 16 ? n - i : 16;
+        uint32_t m = 0;
+        for (size_t j = 0; j < k; j++)
+            m |= (uint32_t)vs_charset_has(cs, (unsigned char)s[i + j]) << j;
+        m = (in ? ~m : m) | 1u << k;
+        if ((size_t)__builtin_ctz(m) < k)
+            return i + __builtin_ctz(m);
+    }
+    return n;
+}
+
+#ifdef VS_HAVE_AVX2
+/*
+ * vs_charset_mask16() - Bit k set when byte k of @v is in the set.
+ *
+ * ``pshufb`` returns zero for index bytes with the high bit set, so looking
+ * up @lo with the byte itself and @hi with its high bit flipped selects the
+ * right table without masking the low nibble.  The high nibble then picks
+ * the bit to test.
+ */
+VS_TARGET_AVX2
+static inline unsigned vs_charset_mask16(__m128i v, __m128i lo, __m128i hi,
+                                         __m128i bit)
+{
+    __m128i row = _mm_or_si128(
+        _mm_shuffle_epi8(lo, v),
+        _mm_shuffle_epi8(hi, _mm_xor_si128(v, _mm_set1_epi8((char)0x80))));
+    __m128i sel = _mm_shuffle_epi8(
+        bit, _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0f)));
+    return (unsigned)_mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_and_si128(row, sel), sel));
+}
+
+/* vs_charset_mask32() - vs_charset_mask16() for 32 bytes at @s. */
+VS_TARGET_AVX2
+static inline unsigned vs_charset_mask32(const char *s, __m256i lo, __m256i hi,
+                                         __m256i bit)
+{
+    __m256i v = _mm256_loadu_si256((const __m256i *)s);
+    __m256i row = _mm256_or_si256(
+        _mm256_shuffle_epi8(lo, v),
+        _mm256_shuffle_epi8(hi,
+                            _mm256_xor_si256(v, _mm256_set1_epi8((char)0x80))));
+    __m256i sel = _mm256_shuffle_epi8(
+        bit, _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0f)));
+    return (unsigned)_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(_mm256_and_si256(row, sel), sel));
+}
+
+/*
+ * vs_span_avx2() - vs_span() for at least 4 bytes.
+ *
+ * Fields shorter than a vector are gathered with two overlapping 4 or 8
+ * byte loads, as in vs_find_nul_small(), and classified in one step.
+ * Longer ones are classified 32 or 16 bytes at a time, ending with one
+ * overlapping block anchored at ``s + n``.  Positions already tested are
+ * masked off the overlap.
+ */
+VS_TARGET_AVX2
+static inline size_t vs_span_avx2(const char *s, size_t n,
+                                  const vs_charset_t *cs, int in)
+{
+    const __m128i lo = _mm_loadu_si128((const __m128i *)cs->lo);
+    const __m128i hi = _mm_loadu_si128((const __m128i *)cs->hi);
+    const __m128i bit = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, (char)128,
+                                      1, 2, 4, 8, 16, 32, 64, (char)128);
+    const unsigned flip = in ? ~0u : 0;
+    size_t i = 0;
+    unsigned m;
+    if (n < 16) {
+        size_t w = n >= 8 ? 8 : 4;
+        __m128i v = w == 8
+            ? _mm_set_epi64x((long long)vs_load64(s + n - 8),
+                             (long long)vs_load64(s))
+            : _mm_set_epi32(0, 0, (int)vs_load32(s + n - 4),
+                            (int)vs_load32(s));
+        m = (vs_charset_mask16(v, lo, hi, bit) ^ flip) & ((1u << 2 * w) - 1);
+        if (m & ((1u << w) - 1))
+            return __builtin_ctz(m);
+        m &= ~0u << (3 * w - n);        /* high half starts at s + n - w */
+        return m ? n - 2 * w + __builtin_ctz(m) : n;
+    }
+    if (n >= 32) {
+        const __m256i lo2 = _mm256_broadcastsi128_si256(lo);
+        const __m256i hi2 = _mm256_broadcastsi128_si256(hi);
+        const __m256i bit2 = _mm256_broadcastsi128_si256(bit);
+        for (; i + 32 <= n; i += 32)
+            if ((m = vs_charset_mask32(s + i, lo2, hi2, bit2) ^ flip))
+                return i + __builtin_ctz(m);
+        if (i == n)
+            return n;
+        m = (vs_charset_mask32(s + n - 32, lo2, hi2, bit2) ^ flip)
+            & (~0u << (i - (n - 32)));
+        return m ? n - 32 + __builtin_ctz(m) : n;
+    }
+    m = (vs_charset_mask16(_mm_loadu_si128((const __m128i *)s), lo, hi, bit)
+         ^ flip) & 0xffffu;
+    if (m)
+        return __builtin_ctz(m);
+    m = (vs_charset_mask16(_mm_loadu_si128((const __m128i *)(s + n - 16)),
+                           lo, hi, bit) ^ flip) & (0xffffu << (32 - n));
+    return m ? n - 16 + __builtin_ctz(m) : n;
+}
+#endif
+
+/*
+ * vs_span() - Length of the leading run of ``s[0..n)`` whose bytes are in
+ * @cs (@in nonzero) or not in @cs (@in zero).
+ *
+ * With AVX2 buffers of 4 bytes or more are classified a vector at a time
+ * with the nibble tables; otherwise each byte is one bitmap lookup.
+ */
+static inline size_t vs_span(const char *s, size_t n, const vs_charset_t *cs,
+                             int in)
+{
+    in = !!in;
+#ifdef VS_HAVE_AVX2
+    if (n >= 4 && vs_cpu_has_avx2())
+        return vs_span_avx2(s, n, cs, in);
+#endif
+    return vs_span_scalar(s, n, cs, in);
+}
+
+/* vs_strpbrk() - Offset of the first byte of ``s[0..n)`` in @cs, or VS_NOT_FOUND. */
+static inline size_t vs_strpbrk(const char *s, size_t n, const vs_charset_t *cs)
+{
+    size_t i = vs_span(s, n, cs, 0);
+    return i < n ? i : VS_NOT_FOUND;
+}
+
+/* v_strspn() - Length of the leading run of @v made of bytes in the set @cs. */
+#define v_strspn(v, cs) vs_span((const char *)V_BUF(v), V_LEN(v), (cs), 1)
+
+/* v_strcspn() - Length of the leading run of @v made of bytes not in @cs. */
+#define v_strcspn(v, cs) vs_span((const char *)V_BUF(v), V_LEN(v), (cs), 0)
+
+/*
+ * v_strpbrk() - Index of the first byte of @v that is in @cs, or -1.
+ *
+ * Unlike ``strpbrk`` an index is returned, as for v_index().
+ */
+#define v_strpbrk(v, cs) \
+    vs_found(vs_strpbrk((const char *)V_BUF(v), V_LEN(v), (cs)))
+
+/* zv_strspn(), zv_strcspn(), zv_strpbrk() - The v_ forms; ``len`` bounds a zv string too. */
+#define zv_strspn(v, cs)  v_strspn(v, cs)
+#define zv_strcspn(v, cs) v_strcspn(v, cs)
+#define zv_strpbrk(v, cs) v_strpbrk(v, cs)
+
+/*
+ * s_strspn(), s_strcspn(), s_strpbrk() - The same for a fixed C string,
+ * scanning the bytes before its terminator and at most S_SIZE(s).
+ */
+#define s_strspn(s, cs)  vs_span((s), S_LEN(s), (cs), 1)
+#define s_strcspn(s, cs) vs_span((s), S_LEN(s), (cs), 0)
+#define s_strpbrk(s, cs) vs_found(vs_strpbrk((s), S_LEN(s), (cs)))
+
+#endif /* VSUITE_CHARSET_H */
@@ -0,0 +1,409 @@
+#ifndef VSUITE_COLUMN_H
+#define VSUITE_COLUMN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <vsuite/varchar.h>
+#include <vsuite/hash.h>
+#include <vsuite/simd.h>
+
+/*
+ * Columnar VARCHAR buffers (``vc_`` prefix).
+ *
+ * An array of VARCHAR puts each ``len`` next to its data, so a pass over the
+ * lengths alone touches every row's cache line.  A VCOLUMN keeps the lengths
+ * in one contiguous ``unsigned short`` array and the data in one pool with a
+ * fixed stride of the declared width:
+ *
+ *     VCOLUMN(names, 1000, 21);
+ *     vc_from_array(names, fetched, sqlca.sqlerrd[2]);
+ *     size_t bad = vc_valid(names);
+ *
+ * Column-wide operations scan ``len[]`` eight lengths per vector and only
+ * visit the data pool for rows that need it.  The bytes of a row past its
+ * ``len`` are unspecified, as in a VARCHAR.
+ */
+
+/**
+ * VCOLUMN() - Declare a columnar buffer of VARCHAR rows.
+ * @name: Name of the variable to declare.
+ * @rows: Number of rows the column can hold.
+ * @size: Width of each row in bytes, as for VARCHAR().
+ *
+ * ``count`` is the number of rows in use; ``len[i]`` and ``arr[i]`` are the
+ * length and data of row @i.
+ */
+#define VCOLUMN(name, rows, size) \
+    struct { size_t count; unsigned short len[rows]; char arr[rows][size]; } name
+
+/* VC_ROWS() - Number of rows a VCOLUMN can hold. */
+#define VC_ROWS(c)   (sizeof((c).len) / sizeof((c).len[0]))
+
+/* VC_SIZE() - Width of each row of a VCOLUMN. */
+#define VC_SIZE(c)   (sizeof((c).arr[0]))
+
+/* VC_BUF() - Data of row @i. */
+#define VC_BUF(c, i) ((c).arr[i])
+
+/* VC_LEN() - Length of row @i clamped to the row width, like V_LEN(). */
+#define VC_LEN(c, i) ((c).len[i] <= VC_SIZE(c) ? (size_t)(c).len[i] : VC_SIZE(c))
+
+/* VC_ARGS() - Lengths, pool, width and row count taken by the kernels. */
+#define VC_ARGS(c)   (c).len, (char *)&(c).arr, VC_SIZE(c), (c).count
+
+/* Narrowest row width for which vc_upper() may work row by row. */
+#ifndef VC_CASE_ROWWISE_MIN
+#define VC_CASE_ROWWISE_MIN 128
+#endif
+
+/* vc_init() - Empty a column. */
+#define vc_init(c)   ((void)((c).count = 0))
+
+/*
+ * vc_first_over_fcn() - Index of the first of @count lengths above @size,
+ * or @count when there is none.
+ */
+static inline size_t vc_first_over_fcn(const unsigned short *len, size_t count,
+                                       size_t size)
+{
+    size_t i = 0;
+    if (size >= 0xFFFF)
+        return count;
+#ifdef VS_HAVE_SSE2
+    const __m128i max = _mm_set1_epi16((short)size);
+    for (; i + 8 <= count; i += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(len + i));
+        unsigned m = (unsigned)_mm_movemask_epi8(
+            _mm_cmpeq_epi16(_mm_subs_epu16(x, max), _mm_setzero_si128()));
+        if (m != 0xFFFF)
+            return i + (__builtin_ctz(~m) >> 1);
+    }
+#endif
+    for (; i < count; i++)
+        if (len[i] > size)
+            return i;
+    return count;
+}
+
+/* vc_max_len_fcn() - Largest of @count lengths. */
+static inline size_t vc_max_len_fcn(const unsigned short *len, size_t count)
+{
+    size_t i = 0;
+    unsigned best = 0;
+#ifdef VS_HAVE_SSE2
+    /* There is no unsigned 16-bit max in SSE2; bias into the signed range. */
+    const __m128i bias = _mm_set1_epi16((short)0x8000);
+    __m128i acc = bias;
+    for (; i + 8 <= count; i += 8)
+        acc = _mm_max_epi16(acc, _mm_xor_si128(
+            _mm_loadu_si128((const __m128i *)(len + i)), bias));
+    acc = _mm_max_epi16(acc, _mm_srli_si128(acc, 8));
+    acc = _mm_max_epi16(acc, _mm_srli_si128(acc, 4));
+    acc = _mm_max_epi16(acc, _mm_srli_si128(acc, 2));
+    best = (unsigned)(_mm_cvtsi128_si32(acc) & 0xFFFF) ^ 0x8000;
+#endif
+    for (; i < count; i++)
+        if (len[i] > best)
+            best = len[i];
+    return best;
+}
+
+/* vc_total_len_fcn() - Sum of @count lengths, each clamped to @size. */
+static inline size_t vc_total_len_fcn(const unsigned short *len, size_t count,
+                                      size_t size)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++)
+        total += len[i] <= size ? len[i] : size;
+    return total;
+}
+
+/*
+ * vc_eq_fcn() - Compare every row with @lit[0..n).
+ * @match: Optional array of @count flags set to 1 for equal rows and 0
+ *         otherwise.
+ *
+ * Lengths are compared eight at a time; only rows of length @n have their
+ * data compared.  Returns the number of equal rows.
+ */
+static inline size_t vc_eq_fcn(const unsigned short *len, const char *pool,
+                               size_t size, size_t count, const char *lit,
+                               size_t n, unsigned char *match)
+{
+    size_t i = 0, hits = 0;
+    if (match)
+        memset(match, 0, count);
+    if (n > size)
+        return 0;
+#ifdef VS_HAVE_SSE2
+    const __m128i want = _mm_set1_epi16((short)n);
+    for (; i + 8 <= count; i += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(len + i));
+        unsigned m = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi16(x, want));
+        m &= 0x5555;                    /* one bit per length */
+        while (m) {
+            size_t r = i + (__builtin_ctz(m) >> 1);
+            m &= m - 1;
+            if (memcmp(pool + r * size, lit, n) == 0) {
+                hits++;
+                if (match)
+                    match[r] = 1;
+            }
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        if (len[i] == n && memcmp(pool + i * size, lit, n) == 0) {
+            hits++;
+            if (match)
+                match[i] = 1;
+        }
+    }
+    return hits;
+}
+
+/* vc_rtrim_fcn() - Kernel behind vc_rtrim(). */
+static inline void vc_rtrim_fcn(unsigned short *len, char *pool, size_t size,
+                                size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        size_t n = len[i] <= size ? len[i] : size;
+        len[i] = (unsigned short)vs_rspan_space(pool + i * size, n);
+    }
+}
+
+/*
+ * vc_valid() - Index of the first row whose ``len`` exceeds the row width,
+ * or ``count`` when every row is valid.  Only ``len[]`` is read.
+ */
+#define vc_valid(c) vc_first_over_fcn((c).len, (c).count, VC_SIZE(c))
+
+/* vc_max_len() - Length of the longest row, for sizing an export buffer. */
+#define vc_max_len(c) vc_max_len_fcn((c).len, (c).count)
+
+/* vc_total_len() - Total bytes held by the column. */
+#define vc_total_len(c) vc_total_len_fcn((c).len, (c).count, VC_SIZE(c))
+
+/*
+ * vc_eq() - Count the rows equal to the string literal @lit.
+ * @c:     VCOLUMN to scan.
+ * @lit:   String literal or char array; its terminator is not compared.
+ * @match: ``unsigned char`` array of at least ``count`` flags, or NULL.
+ */
+#define vc_eq(c, lit, match) \
+    vc_eq_fcn(VC_ARGS(c), (lit), sizeof(lit) - 1, (match))
+
+/*
+ * vc_eqp() - vc_eq() against a ``char *`` of @n bytes.
+ */
+#define vc_eqp(c, p, n, match) vc_eq_fcn(VC_ARGS(c), (p), (n), (match))
+
+/*
+ * vc_rtrim() - Apply v_rtrim() to every row.
+ */
+#define vc_rtrim(c) vc_rtrim_fcn((c).len, (char *)&(c).arr, VC_SIZE(c), (c).count)
+
+/*
+ * vc_case_fcn() - Kernel behind vc_upper() and vc_lower().
+ *
+ * Narrow columns, and wide ones that are at least half full, are converted
+ * as one buffer, bytes past each ``len`` included.  Otherwise each row is
+ * converted on its own so the unused tail of wide rows is never read.
+ */
+static inline __attribute__((always_inline))
+void vc_case_fcn(const unsigned short *len, char *pool, size_t size,
+                 size_t count, unsigned char lo)
+{
+    if (size < VC_CASE_ROWWISE_MIN ||
+        2 * vc_total_len_fcn(len, count, size) >= count * size) {
+        vs_case(pool, count * size, lo);
+        return;
+    }
+    for (size_t i = 0; i < count; i++)
+        vs_case(pool + i * size, len[i] <= size ? len[i] : size, lo);
+}
+
+/*
+ * vc_upper() - Apply v_upper() to every row.
+ *
+ * Bytes past a row's ``len`` may be converted too.
+ */
+#define vc_upper(c) vc_case_fcn(VC_ARGS(c), 'a')
+
+/* vc_lower() - Apply v_lower() to every row; see vc_upper(). */
+#define vc_lower(c) vc_case_fcn(VC_ARGS(c), 'A')
+
+/*
+ * vc_hash_fcn() - Kernel behind vc_hash() and vc_casehash().
+ *
+ * Reads ``len[]`` and the pool at its fixed stride; each row is hashed as
+ * v_hash() would hash it, with @fold constant so the loop is specialised.
+ */
+static inline __attribute__((always_inline))
+size_t vc_hash_fcn(const unsigned short *len, const char *pool, size_t size,
+                   size_t count, uint64_t *out, int fold)
+{
+    for (size_t i = 0; i < count; i++)
+        out[i] = vs_hash_fcn(pool + i * size, len[i] <= size ? len[i] : size,
+                             VS_HASH_SEED, fold);
+    return count;
+}
+
+/*
+ * vc_hash() - Store v_hash() of every row in @out[0..count).
+ *
+ * Returns the number of rows hashed.  The values equal v_hash() of the same
+ * rows held as VARCHARs, so they can be probed against a vs_map_t.
+ */
+#define vc_hash(c, out) vc_hash_fcn(VC_ARGS(c), (out), 0)
+
+/* vc_casehash() - vc_hash() ignoring ASCII case, like v_casehash(). */
+#define vc_casehash(c, out) vc_hash_fcn(VC_ARGS(c), (out), 1)
+
+/*
+ * vc_from_array() - Load @rows elements of the VARCHAR array @a into @c.
+ *
+ * Replaces the contents of @c.  Rows wider than the column are truncated and
+ * elements beyond VC_ROWS() are dropped.  Returns the number of bytes
+ * stored; the number dropped is left in ``varchar_overflow``.
+ */
+#define vc_from_array(c, a, rows) \
+    v_status_publish(vc_from_array_st(c, a, rows))
+
+/* vc_from_array_st() - vc_from_array() reporting a v_status_t. */
+#define vc_from_array_st(c, a, rows)                                         \
+    ({                                                                       \
+        size_t __cnt = (rows), __rows = __cnt, __bytes = 0, __ovf = 0;       \
+        size_t __req = 0;                                                    \
+        if (__rows > VC_ROWS(c))                                             \
+            __rows = VC_ROWS(c);                                             \
+        for (size_t __i = 0; __i < __cnt; __i++) {                           \
+            size_t __n = V_LEN((a)[__i]);                                    \
+            if (__n > __req)                                                 \
+                __req = __n;                                                 \
+            if (__i >= __rows) {                                             \
+                __ovf += __n;                                                \
+                continue;                                                    \
+            }                                                                \
+            if (__n > VC_SIZE(c)) {                                          \
+                __ovf += __n - VC_SIZE(c);                                   \
+                __n = VC_SIZE(c);                                            \
+            }                                                                \
+            vs_copy(VC_BUF(c, __i), V_BUF((a)[__i]), __n,                    \
+                    V_SIZE((a)[0]) < VC_SIZE(c) ? V_SIZE((a)[0]) : VC_SIZE(c)); \
+            (c).len[__i] = (unsigned short)__n;                              \
+            __bytes += __n;                                                  \
+        }                                                                    \
+        (c).count = __rows;                                                  \
+        if (__ovf) {                                                         \
+            V_WARN("Line %d : vc_from_array(%s, %s) : overflow : %zu bytes dropped over %zu elements", \
+                   __LINE__, #c, #a, __ovf, __cnt);                          \
+        }                                                                    \
+        VS_TELEMETRY("vc_from_array", VC_SIZE(c), __req, __ovf);             \
+        (v_status_t){ __bytes, __ovf };                                      \
+    })
+
+/*
+ * vc_to_array() - Store every row of @c into the VARCHAR array @a.
+ *
+ * @a must have at least ``count`` elements.  Each ``len`` is set; rows wider
+ * than the elements are truncated.  Returns the number of bytes stored; the
+ * number dropped is left in ``varchar_overflow``.
+ */
+#define vc_to_array(a, c) v_status_publish(vc_to_array_st(a, c))
+
+/* vc_to_array_st() - vc_to_array() reporting a v_status_t. */
+#define vc_to_array_st(a, c)                                                 \
+    ({                                                                       \
+        size_t __cnt = (c).count, __bytes = 0, __ovf = 0, __req = 0;         \
+        for (size_t __i = 0; __i < __cnt; __i++) {                           \
+            size_t __n = VC_LEN(c, __i);                                     \
+            if (__n > __req)                                                 \
+                __req = __n;                                                 \
+            if (__n > V_SIZE((a)[__i])) {                                    \
+                __ovf += __n - V_SIZE((a)[__i]);                             \
+                __n = V_SIZE((a)[__i]);                                      \
+            }                                                                \
+            vs_copy(V_BUF((a)[__i]), VC_BUF(c, __i), __n,                    \
+                    V_SIZE((a)[0]) < VC_SIZE(c) ? V_SIZE((a)[0]) : VC_SIZE(c)); \
+            (a)[__i].len = (unsigned short)__n;                              \
+            __bytes += __n;                                                  \
+        }                                                                    \
+        if (__ovf) {                                                         \
+            V_WARN("Line %d : vc_to_array(%s, %s) : overflow : %zu bytes dropped over %zu rows", \
+                   __LINE__, #a, #c, __ovf, __cnt);                          \
+        }                                                                    \
+        VS_TELEMETRY("vc_to_array", V_SIZE((a)[0]), __req, __ovf);           \
+        (v_status_t){ __bytes, __ovf };                                      \
+    })
+
+/*
+ * vc_get() - Copy row @i of @c into the VARCHAR @v, like v_copy().
+ *
+ * Sets ``v.len`` and returns the number of bytes copied; the number dropped
+ * is left in ``varchar_overflow``.
+ */
+#define vc_get(v, c, i) v_status_publish(vc_get_st(v, c, i))
+
+/* vc_get_st() - vc_get() reporting a v_status_t instead of varchar_overflow. */
+#define vc_get_st(v, c, i)                                                   \
+    ({                                                                       \
+        size_t __r = (i), __n = VC_LEN(c, __r), __ovf = 0;                   \
+        if (__n > V_SIZE(v)) {                                               \
+            __ovf = __n - V_SIZE(v);                                         \
+            V_WARN("Line %d : vc_get(%s, %s, %zu) : overflow : %zu bytes dropped", \
+                   __LINE__, #v, #c, __r, __ovf);                            \
+            __n = V_SIZE(v);                                                 \
+        }                                                                    \
+        VS_TELEMETRY("vc_get", V_SIZE(v), __n + __ovf, __ovf);               \
+        vs_copy(V_BUF(v), VC_BUF(c, __r), __n,                               \
+                V_SIZE(v) < VC_SIZE(c) ? V_SIZE(v) : VC_SIZE(c));            \
+        (v).len = (unsigned short)__n;                                       \
+        (v_status_t){ __n, __ovf };                                          \
+    })
+
+/*
+ * vc_append() - Add the VARCHAR @v as a new row of @c.
+ *
+ * Returns the index of the new row, or -1 when the column is full.  A value
+ * wider than the column is truncated and the bytes dropped are left in
+ * ``varchar_overflow``; when the column is full all of ``V_LEN(v)`` is.
+ */
+#define vc_append(c, v)                                                      \
+    ({                                                                       \
+        long __row = -1;                                                     \
+        if ((c).count < VC_ROWS(c)) {                                        \
+            __row = (long)(c).count;                                         \
+            (void)v_status_publish(vc_append_st(c, v));                      \
+        } else {                                                             \
+            V_WARN("Line %d : vc_append(%s, %s) : column full at %zu rows",  \
+                   __LINE__, #c, #v, VC_ROWS(c));                            \
+            (void)v_status_publish(((v_status_t){ 0, V_LEN(v) }));           \
+        }                                                                    \
+        __row;                                                               \
+    })
+
+/*
+ * vc_append_st() - Add @v as row ``count`` of @c, which must not be full,
+ * reporting a v_status_t.
+ */
+#define vc_append_st(c, v)                                                   \
+    ({                                                                       \
+        size_t __n = V_LEN(v), __ovf = 0;                                    \
+        if (__n > VC_SIZE(c)) {                                              \
+            __ovf = __n - VC_SIZE(c);                                        \
+            V_WARN("Line %d : vc_append(%s, %s) : overflow : %zu bytes dropped", \
+                   __LINE__, #c, #v, __ovf);                                 \
+            __n = VC_SIZE(c);                                                \
+        }                                                                    \
+        VS_TELEMETRY("vc_append", VC_SIZE(c), __n + __ovf, __ovf);           \
+        size_t __at = (c).count++;                                           \
+        vs_copy(VC_BUF(c, __at), V_BUF(v), __n,                              \
+                V_SIZE(v) < VC_SIZE(c) ? V_SIZE(v) : VC_SIZE(c));            \
+        (c).len[__at] = (unsigned short)__n;                                 \
+        (v_status_t){ __n, __ovf };                                          \
+    })
+
+#endif /* VSUITE_COLUMN_H */
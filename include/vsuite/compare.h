@@ -0,0 +1,254 @@
+#ifndef VSUITE_COMPARE_H
+#define VSUITE_COMPARE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <stddef.h>
+
+#include <vsuite/varchar.h>
+#include <vsuite/fixed.h>
+#include <vsuite/string.h>
+#include <vsuite/simd.h>
+
+/*
+ * Length-aware comparison.
+ *
+ * ``strcmp`` on a VARCHAR needs a terminator first and stops at the first
+ * embedded NUL.  These compare ``len`` bytes: the ordering is ``memcmp``
+ * over the common prefix, then the shorter value first.  The ``_eq`` forms
+ * return as soon as the lengths differ and compare short values with a
+ * couple of overlapping word loads:
+ *
+ *     if (vf_eq(doc_type, "AP"))
+ *         ...
+ *
+ * The ``case`` forms fold ASCII ``'A'..'Z'`` to lower case, a vector at a
+ * time, as ``strcasecmp`` does in the "C" locale.
+ */
+
+/* vs_fold() - ASCII lower case of @c. */
+static inline int vs_fold(unsigned char c)
+{
+    return c + (((unsigned)(c - 'A') < 26u) << 5);
+}
+
+/* vs_fold_diff() - Difference of the folded bytes at offset @i. */
+static inline int vs_fold_diff(const char *a, const char *b, size_t i)
+{
+    return vs_fold((unsigned char)a[i]) - vs_fold((unsigned char)b[i]);
+}
+
+/*
+ * vs_mem_eq() - Nonzero when ``a[0..n)`` equals ``b[0..n)``.
+ *
+ * Up to 16 bytes (32 with SSE2) are compared with two overlapping loads
+ * from each side and no loop; longer values go to ``memcmp``.
+ */
+static inline int vs_mem_eq(const char *a, const char *b, size_t n)
+{
+    if (n >= 8) {
+        if (n <= 16)
+            return ((vs_load64(a) ^ vs_load64(b)) |
+                    (vs_load64(a + n - 8) ^ vs_load64(b + n - 8))) == 0;
+#ifdef VS_HAVE_SSE2
+        if (n <= 32) {
+            __m128i x = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)a),
+                                       _mm_loadu_si128((const __m128i *)b));
+            __m128i y = _mm_cmpeq_epi8(
+                _mm_loadu_si128((const __m128i *)(a + n - 16)),
+                _mm_loadu_si128((const __m128i *)(b + n - 16)));
+            return _mm_movemask_epi8(_mm_and_si128(x, y)) == 0xffff;
+        }
+#endif
+        return memcmp(a, b, n) == 0;
+    }
+    if (n >= 4)
+        return ((vs_load32(a) ^ vs_load32(b)) |
+                (vs_load32(a + n - 4) ^ vs_load32(b + n - 4))) == 0;
+    if (n == 0)
+        return 1;
+    /* 0, n/2 and n-1 cover every byte of a 1 to 3 byte value */
+    return ((a[0] ^ b[0]) | (a[n / 2] ^ b[n / 2]) | (a[n - 1] ^ b[n - 1])) == 0;
+}
+
+/* vs_cmp() - Order ``a[0..an)`` against ``b[0..bn)``; <0, 0 or >0. */
+static inline int vs_cmp(const char *a, size_t an, const char *b, size_t bn)
+{
+    int r = memcmp(a, b, an < bn ? an : bn);
+    return r ? r : (an > bn) - (an < bn);
+}
+
+/* vs_eq() - Nonzero when the two values have the same length and bytes. */
+static inline int vs_eq(const char *a, size_t an, const char *b, size_t bn)
+{
+    return an == bn && vs_mem_eq(a, b, an);
+}
+
+#ifdef VS_SWAR_LE
+/*
+ * vs_casecmp_word() - Folded compare of two little-endian words: 0, or the
+ * folded difference at the lowest differing byte.
+ */
+static inline int vs_casecmp_word(uint64_t x, uint64_t y)
+{
+    uint64_t fx = vs_case_word(x, 'A'), fy = vs_case_word(y, 'A');
+    uint64_t d = fx ^ fy;
+    if (!d)
+        return 0;
+    unsigned k = (unsigned)__builtin_ctzll(d) & ~7u;
+    return (int)((fx >> k) & 0xff) - (int)((fy >> k) & 0xff);
+}
+#endif
+
+/*
+ * vs_casecmp_small() - vs_casecmp_n() with 8-byte words.  A 4 to 7 byte
+ * value is packed into one word from two overlapping loads; the last word
+ * of a longer one overlaps bytes already found equal.
+ */
+static inline int vs_casecmp_small(const char *a, const char *b, size_t n)
+{
+#ifdef VS_SWAR_LE
+    int r;
+    if (n >= 8) {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+            if ((r = vs_casecmp_word(vs_load64(a + i), vs_load64(b + i))))
+                return r;
+        return i < n ? vs_casecmp_word(vs_load64(a + n - 8),
+                                       vs_load64(b + n - 8)) : 0;
+    }
+    if (n >= 4)
+        return vs_casecmp_word(
+            vs_load32(a) | (uint64_t)vs_load32(a + n - 4) << 32,
+            vs_load32(b) | (uint64_t)vs_load32(b + n - 4) << 32);
+#endif
+    for (size_t i = 0; i < n; i++) {
+        int r = vs_fold_diff(a, b, i);
+        if (r)
+            return r;
+    }
+    return 0;
+}
+
+#ifdef VS_HAVE_SSE2
+static inline int vs_casecmp_sse2(const char *a, const char *b, size_t n)
+{
+    const __m128i bias  = _mm_set1_epi8((char)(0x80 - 'A'));
+    const __m128i limit = _mm_set1_epi8((char)(-128 + 26));
+    const __m128i flip  = _mm_set1_epi8(0x20);
+    size_t i = 0;
+    for (;;) {
+        if (i + 16 > n)
+            i = n - 16;
+        __m128i x = vs_case_sse2_vec(_mm_loadu_si128((const __m128i *)(a + i)),
+                                     bias, limit, flip);
+        __m128i y = vs_case_sse2_vec(_mm_loadu_si128((const __m128i *)(b + i)),
+                                     bias, limit, flip);
+        unsigned m = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) ^ 0xffffu;
+        if (m)
+            return vs_fold_diff(a, b, i + __builtin_ctz(m));
+        if (i + 16 >= n)
+            return 0;
+        i += 16;
+    }
+}
+#endif
+
+#ifdef VS_HAVE_AVX2
+VS_TARGET_AVX2
+static inline int vs_casecmp_avx2(const char *a, const char *b, size_t n)
+{
+    const __m256i bias  = _mm256_set1_epi8((char)(0x80 - 'A'));
+    const __m256i limit = _mm256_set1_epi8((char)(-128 + 26));
+    const __m256i flip  = _mm256_set1_epi8(0x20);
+    size_t i = 0;
+    for (;;) {
+        if (i + 32 > n)
+            i = n - 32;
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i *)(b + i));
+        x = _mm256_xor_si256(x, _mm256_and_si256(
+                _mm256_cmpgt_epi8(limit, _mm256_add_epi8(x, bias)), flip));
+        y = _mm256_xor_si256(y, _mm256_and_si256(
+                _mm256_cmpgt_epi8(limit, _mm256_add_epi8(y, bias)), flip));
+        unsigned m = ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y));
+        if (m)
+            return vs_fold_diff(a, b, i + __builtin_ctz(m));
+        if (i + 32 >= n)
+            return 0;
+        i += 32;
+    }
+}
+#endif
+
+/*
+ * vs_casecmp_n() - Compare ``a[0..n)`` and ``b[0..n)`` with ASCII letters
+ * folded to lower case.  Returns the folded difference at the first
+ * mismatch, or 0.  Locale independent.
+ */
+static inline int vs_casecmp_n(const char *a, const char *b, size_t n)
+{
+#ifdef VS_HAVE_SSE2
+    if (n >= 16) {
+#ifdef VS_HAVE_AVX2
+        if (n >= VS_AVX2_MIN && vs_cpu_has_avx2())
+            return vs_casecmp_avx2(a, b, n);
+#endif
+        return vs_casecmp_sse2(a, b, n);
+    }
+#endif
+    return vs_casecmp_small(a, b, n);
+}
+
+/* vs_casecmp() - vs_cmp() ignoring ASCII case. */
+static inline int vs_casecmp(const char *a, size_t an, const char *b, size_t bn)
+{
+    int r = vs_casecmp_n(a, b, an < bn ? an : bn);
+    return r ? r : (an > bn) - (an < bn);
+}
+
+/* vs_caseeq() - vs_eq() ignoring ASCII case. */
+static inline int vs_caseeq(const char *a, size_t an, const char *b, size_t bn)
+{
+    return an == bn && vs_casecmp_n(a, b, an) == 0;
+}
+
+/*
+ * v_cmp() - Compare the VARCHARs @a and @b.
+ *
+ * Returns <0, 0 or >0 as ``memcmp`` over the common length, then the shorter
+ * value first.  Embedded NUL bytes are compared like any other byte.
+ */
+#define v_cmp(a, b) vs_cmp(V_BUF(a), V_LEN(a), V_BUF(b), V_LEN(b))
+
+/* v_eq() - Nonzero when @a and @b hold the same bytes; lengths first. */
+#define v_eq(a, b) vs_eq(V_BUF(a), V_LEN(a), V_BUF(b), V_LEN(b))
+
+/* v_casecmp() - v_cmp() ignoring ASCII case. */
+#define v_casecmp(a, b) vs_casecmp(V_BUF(a), V_LEN(a), V_BUF(b), V_LEN(b))
+
+/* v_caseeq() - v_eq() ignoring ASCII case. */
+#define v_caseeq(a, b) vs_caseeq(V_BUF(a), V_LEN(a), V_BUF(b), V_LEN(b))
+
+/*
+ * vf_cmp() - Compare the VARCHAR @v with the fixed C string or literal @f,
+ * whose length is taken up to its terminator and at most F_SIZE(f).
+ */
+#define vf_cmp(v, f) vs_cmp(V_BUF(v), V_LEN(v), (f), S_LEN(f))
+
+/* vf_eq(), vf_casecmp(), vf_caseeq() - The v_ forms against a fixed C string. */
+#define vf_eq(v, f)      vs_eq(V_BUF(v), V_LEN(v), (f), S_LEN(f))
+#define vf_casecmp(v, f) vs_casecmp(V_BUF(v), V_LEN(v), (f), S_LEN(f))
+#define vf_caseeq(v, f)  vs_caseeq(V_BUF(v), V_LEN(v), (f), S_LEN(f))
+
+/* vp_cmp(), vp_eq(), vp_casecmp(), vp_caseeq() - The v_ forms against a ``char *``. */
+#define vp_cmp(v, p) \
+    ({ const char *__p = (p); vs_cmp(V_BUF(v), V_LEN(v), __p, strlen(__p)); })
+#define vp_eq(v, p) \
+    ({ const char *__p = (p); vs_eq(V_BUF(v), V_LEN(v), __p, strlen(__p)); })
+#define vp_casecmp(v, p) \
+    ({ const char *__p = (p); vs_casecmp(V_BUF(v), V_LEN(v), __p, strlen(__p)); })
+#define vp_caseeq(v, p) \
+    ({ const char *__p = (p); vs_caseeq(V_BUF(v), V_LEN(v), __p, strlen(__p)); })
+
+#endif /* VSUITE_COMPARE_H */
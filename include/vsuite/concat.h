@@ -0,0 +1,162 @@
+#ifndef VSUITE_CONCAT_H
+#define VSUITE_CONCAT_H
+
+#include <string.h>
+#include <stddef.h>
+
+#include <vsuite/varchar.h>
+#include <vsuite/zvarchar.h>
+#include <vsuite/simd.h>
+
+/*
+ * Multi-source concatenation.
+ *
+ * A composite key built with a chain of v_strcat() or zv_strcat() calls
+ * recomputes the free space, resets ``varchar_overflow`` and, for zv,
+ * rewrites the terminator once per part.  v_concat_many() adds up the source
+ * lengths first, decides truncation once and copies the parts back to back:
+ *
+ *     v_concat_many(key, entity, resp_org, nat_acct);
+ *
+ * Up to VS_CONCAT_MAX sources are accepted.
+ */
+
+#define VS_CONCAT_MAX 8
+
+/* VS_NARGS() - Number of arguments, 1 to VS_CONCAT_MAX. */
+#define VS_NARGS(...) VS_NARGS_(__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define VS_NARGS_(_1, _2, _3, _4, _5, _6, _7, _8, n, ...) n
+
+#define VS_PASTE(a, b)  VS_PASTE_(a, b)
+#define VS_PASTE_(a, b) a##b
+
+/*
+ * VS_FOREACH() - Expand @m(arg, k) for each argument, with no separator.
+ * @k counts down from the number of arguments to 1.
+ */
+#define VS_FOREACH(m, ...) \
+    VS_PASTE(VS_FOREACH_, VS_NARGS(__VA_ARGS__))(m, __VA_ARGS__)
+#define VS_FOREACH_1(m, a)      m(a, 1)
+#define VS_FOREACH_2(m, a, ...) m(a, 2) VS_FOREACH_1(m, __VA_ARGS__)
+#define VS_FOREACH_3(m, a, ...) m(a, 3) VS_FOREACH_2(m, __VA_ARGS__)
+#define VS_FOREACH_4(m, a, ...) m(a, 4) VS_FOREACH_3(m, __VA_ARGS__)
+#define VS_FOREACH_5(m, a, ...) m(a, 5) VS_FOREACH_4(m, __VA_ARGS__)
+#define VS_FOREACH_6(m, a, ...) m(a, 6) VS_FOREACH_5(m, __VA_ARGS__)
+#define VS_FOREACH_7(m, a, ...) m(a, 7) VS_FOREACH_6(m, __VA_ARGS__)
+#define VS_FOREACH_8(m, a, ...) m(a, 8) VS_FOREACH_7(m, __VA_ARGS__)
+
+/*
+ * vs_concat_slow() - Store as much of @count parts as fits in @dst[0..cap).
+ * @src:   Start of each part.
+ * @len:   Length of each part.
+ * @total: Sum of @len, already known to exceed @cap.
+ */
+static inline v_status_t vs_concat_slow(char *dst, size_t cap,
+                                        const char *const *src,
+                                        const size_t *len, size_t count,
+                                        size_t total)
+{
+    size_t pos = 0;
+    for (size_t i = 0; i < count && pos < cap; i++) {
+        size_t n = len[i] < cap - pos ? len[i] : cap - pos;
+        memmove(dst + pos, src[i], n);
+        pos += n;
+    }
+    return (v_status_t){ pos, total - pos };
+}
+
+/*
+ * Per-source pieces of vs_concat_parts().  The lengths are read once into
+ * ``__len``; the constant index keeps them in registers across the copies.
+ */
+#define VS_CONCAT_BUF(v, k) (const char *)V_BUF(v),
+#define VS_CONCAT_LEN(v, k) V_LEN(v),
+#define VS_CONCAT_PUT(v, k)                                                  \
+    vs_copy(__cd, V_BUF(v), __len[__cn - k],                                 \
+            V_SIZE(v) < __ccap ? V_SIZE(v) : __ccap);                        \
+    __cd += __len[__cn - k];
+
+/*
+ * vs_concat_parts() - Store the VARCHARs in ``...`` back to back in
+ * @dst[0..cap) and return a v_status_t.
+ *
+ * The lengths are added up first.  When the parts fit, which is the common
+ * case, each is copied with the vs_copy() kernel for its declared size, one
+ * after another with no further checks.  Otherwise the leading bytes are
+ * kept and the rest counted as overflow.
+ */
+#define vs_concat_parts(dst, cap, ...)                                       \
+    ({                                                                       \
+        char *__cd = (dst);                                                  \
+        size_t __ccap = (cap), __ctotal = 0;                                 \
+        const size_t __len[] = { VS_FOREACH(VS_CONCAT_LEN, __VA_ARGS__) };   \
+        const size_t __cn = sizeof __len / sizeof __len[0];                  \
+        for (size_t __i = 0; __i < __cn; __i++)                              \
+            __ctotal += __len[__i];                                          \
+        v_status_t __cs = { __ctotal, 0 };                                   \
+        if (__builtin_expect(__ctotal <= __ccap, 1)) {                       \
+            VS_FOREACH(VS_CONCAT_PUT, __VA_ARGS__)                           \
+        } else {                                                             \
+            const char *const __src[] =                                      \
+                { VS_FOREACH(VS_CONCAT_BUF, __VA_ARGS__) };                  \
+            __cs = vs_concat_slow(__cd, __ccap, __src, __len, __cn, __ctotal); \
+        }                                                                    \
+        __cs;                                                                \
+    })
+
+/*
+ * v_concat_many() - Set @dest to the concatenation of the VARCHARs in ``...``.
+ * @dest: Destination VARCHAR.
+ * @...:  One to VS_CONCAT_MAX source VARCHARs.
+ *
+ * Sets ``dest.len`` and returns it.  When the parts do not fit, the leading
+ * bytes are kept and the rest is recorded in ``varchar_overflow``.  @dest may
+ * be passed as the first source to append to it, but not as a later one.
+ */
+#define v_concat_many(dest, ...) \
+    v_status_publish(v_concat_many_st(dest, __VA_ARGS__))
+
+/* v_concat_many_st() - v_concat_many() reporting a v_status_t instead of varchar_overflow. */
+#define v_concat_many_st(dest, ...)                                          \
+    ({                                                                       \
+        v_status_t __cst = vs_concat_parts(V_BUF(dest), V_SIZE(dest),        \
+                                           __VA_ARGS__);                     \
+        if (__cst.overflow) {                                                \
+            V_WARN("Line %d : v_concat_many(%s, %s) : overflow : bytes required %zu > %zu capacity", \
+                   __LINE__, #dest, #__VA_ARGS__,                            \
+                   __cst.bytes + __cst.overflow, V_SIZE(dest));              \
+        }                                                                    \
+        VS_TELEMETRY("v_concat_many", V_SIZE(dest),                          \
+                     __cst.bytes + __cst.overflow, __cst.overflow);          \
+        (dest).len = (unsigned short)__cst.bytes;                            \
+        __cst;                                                               \
+    })
+
+/*
+ * zv_concat_many() - v_concat_many() keeping room for the terminator, which
+ * is written once after the last part.
+ */
+#define zv_concat_many(dest, ...) \
+    v_status_publish(zv_concat_many_st(dest, __VA_ARGS__))
+
+/* zv_concat_many_st() - zv_concat_many() reporting a v_status_t instead of varchar_overflow. */
+#define zv_concat_many_st(dest, ...)                                         \
+    ({                                                                       \
+        v_status_t __cst = { 0, 0 };                                         \
+        if (V_SIZE(dest) > 0) {                                              \
+            __cst = vs_concat_parts(V_BUF(dest), ZV_CAPACITY(dest),          \
+                                    __VA_ARGS__);                            \
+            V_BUF(dest)[__cst.bytes] = '\0';                                 \
+        }                                                                    \
+        if (__cst.overflow) {                                                \
+            V_WARN("Line %d : zv_concat_many(%s, %s) : overflow : bytes required %zu > %zu capacity", \
+                   __LINE__, #dest, #__VA_ARGS__,                            \
+                   __cst.bytes + __cst.overflow, V_SIZE(dest));              \
+        }                                                                    \
+        VS_TELEMETRY("zv_concat_many", V_SIZE(dest),                         \
+                     __cst.bytes + __cst.overflow + 1, __cst.overflow);      \
+        (dest).len = (unsigned short)__cst.bytes;                            \
+        __cst;                                                               \
+    })
+
+#endif /* VSUITE_CONCAT_H */
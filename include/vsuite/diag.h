@@ -0,0 +1,132 @@
+#ifndef VSUITE_DIAG_H
+#define VSUITE_DIAG_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Per-call-site limits for diagnostics.
+ *
+ * A conversion bug usually fires the same message for every row of a run.
+ * VS_DIAG_LIMITED() gives each call site a static record: the first
+ * VS_DIAG_LIMIT occurrences are logged in full, later ones are only
+ * counted.  Once a site is over its limit the check costs one relaxed
+ * increment and one branch that always goes the same way.
+ *
+ * Sites register themselves on their first occurrence.  At exit the sites
+ * that suppressed anything are listed on ``vs_diag_out`` (stderr by
+ * default); vs_diag_report() lists every site on demand.
+ *
+ * V_WARN_STDERR and V_WARN_SINK (see varchar.h) and the varchar-logFile.h
+ * diagnostics are limited this way.
+ */
+
+/* Occurrences logged in full per site; 0 logs none, only counts. */
+#ifndef VS_DIAG_LIMIT
+#define VS_DIAG_LIMIT 10
+#endif
+
+/*
+ * vs_diag_site_t - Static record of one diagnostic call site.
+ * @what:  Format string of the message, used to label the summary.
+ * @file:  __FILE__ of the site.
+ * @line:  __LINE__ of the site.
+ * @count: Occurrences so far.
+ * @next:  Next registered site.
+ */
+typedef struct vs_diag_site {
+    const char *what;
+    const char *file;
+    int line;
+    uint64_t count;
+    struct vs_diag_site *next;
+} vs_diag_site_t;
+
+/* Registered sites, newest first; weak so all translation units share it. */
+vs_diag_site_t *vs_diag_sites __attribute__((weak));
+
+/* Stream for the summary printed at exit; ``NULL`` means stderr. */
+FILE *vs_diag_out __attribute__((weak));
+
+int vs_diag_hooked __attribute__((weak));
+
+/*
+ * vs_diag_report() - List the registered sites on @f: occurrences and how
+ * many were not logged.  With @all zero only sites over the limit.
+ * Returns the number of sites listed.
+ */
+static inline size_t vs_diag_report(FILE *f, int all)
+{
+    size_t listed = 0;
+    for (vs_diag_site_t *s = __atomic_load_n(&vs_diag_sites, __ATOMIC_ACQUIRE);
+         s; s = s->next) {
+        uint64_t n = __atomic_load_n(&s->count, __ATOMIC_RELAXED);
+        uint64_t dropped = n > VS_DIAG_LIMIT ? n - VS_DIAG_LIMIT : 0;
+        if (!all && !dropped)
+            continue;
+        if (listed++ == 0)
+            fprintf(f, "Diagnostics by call site (first %d logged):\n",
+                    VS_DIAG_LIMIT);
+        fprintf(f, "%s:%d : %llu occurrences, %llu not logged : %.*s\n",
+                s->file, s->line, (unsigned long long)n,
+                (unsigned long long)dropped,
+                (int)strcspn(s->what, "\n"), s->what);
+    }
+    return listed;
+}
+
+/* vs_diag_at_exit() - Summary of the suppressing sites, run by ``atexit``. */
+static inline void vs_diag_at_exit(void)
+{
+    FILE *f = vs_diag_out ? vs_diag_out : stderr;
+    if (vs_diag_report(f, 0))
+        fflush(f);
+}
+
+/* vs_diag_register() - Link @s into the site list on its first occurrence. */
+static __attribute__((noinline, cold, unused))
+void vs_diag_register(vs_diag_site_t *s)
+{
+    vs_diag_site_t *head = __atomic_load_n(&vs_diag_sites, __ATOMIC_RELAXED);
+    do {
+        s->next = head;
+    } while (!__atomic_compare_exchange_n(&vs_diag_sites, &head, s, 1,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    if (!__atomic_exchange_n(&vs_diag_hooked, 1, __ATOMIC_ACQ_REL))
+        atexit(vs_diag_at_exit);
+}
+
+/*
+ * vs_diag_hit() - Count an occurrence at @s; nonzero when it should be
+ * logged.
+ */
+static inline int vs_diag_hit(vs_diag_site_t *s)
+{
+    uint64_t n = __atomic_fetch_add(&s->count, 1, __ATOMIC_RELAXED);
+    if (__builtin_expect(n >= VS_DIAG_LIMIT, 1)) {
+        if (n == 0)
+            vs_diag_register(s);
+        return 0;
+    }
+    if (n == 0)
+        vs_diag_register(s);
+    return 1;
+}
+
+/*
+ * VS_DIAG_LIMITED() - Run @stmt, which logs the message @fmt, only for the
+ * first VS_DIAG_LIMIT occurrences at this call site.
+ *
+ *     VS_DIAG_LIMITED(fmt, fprintf(log, fmt, __LINE__, ...));
+ */
+#define VS_DIAG_LIMITED(fmt, stmt)                                           \
+    do {                                                                     \
+        static vs_diag_site_t __vs_site = { (fmt), __FILE__, __LINE__, 0, NULL }; \
+        if (vs_diag_hit(&__vs_site)) {                                       \
+            stmt;                                                            \
+        }                                                                    \
+    } while (0)
+
+#endif /* VSUITE_DIAG_H */
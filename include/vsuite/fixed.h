@@ -21,52 +21,67 @@
  * The destination length is updated only when the literal fits completely.
  * Otherwise ``vdst.len`` is cleared to zero so callers can detect overflow.
  */
-#define vf_copy(vdst, csrc)                                          \
+#define vf_copy(vdst, csrc) \
+    v_status_publish(vf_copy_st(vdst, csrc))
+
+/* vf_copy_st() - vf_copy() reporting a v_status_t instead of varchar_overflow. */
+#define vf_copy_st(vdst, csrc)                                       \
     ({                                                               \
+        VS_PROFILE_BEGIN("vf_copy");                                 \
         if (!f_valid(csrc)) {                                        \
             V_WARN("Line %d : vf_copy(%s, %s) : src buffer is overflowed : bytes used %zu > %zu capacity", \
                 __LINE__, #vdst, #csrc, strlen(csrc), F_SIZE(csrc)); \
         }                                                            \
-        varchar_overflow = 0;                                        \
+        size_t __ovf = 0;                                            \
         size_t siz = V_SIZE(vdst);                                   \
         size_t __n = strlen(csrc);                                   \
         if (__n > siz) {                                             \
-            varchar_overflow = __n - siz;                            \
+            __ovf = __n - siz;                                       \
             V_WARN("Line %d : vp_copy(%s, %s) : overflow : bytes required %zu > %zu capacity", \
                 __LINE__, #vdst, #csrc, __n, siz);                   \
-            __n = siz;                                               \
+            __n = 0;                                                 \
         }                                                            \
-        memmove(V_BUF(vdst), csrc, __n);                             \
-        __n;                                                         \
+        VS_TELEMETRY("vf_copy", V_SIZE(vdst), __ovf ? siz + __ovf : __n, __ovf); \
+        vs_copy(V_BUF(vdst), csrc, __n, V_SIZE(vdst));               \
+        (vdst).len = __n;                                            \
+        VS_PROFILE_END();                                            \
+        (v_status_t){ __n, __ovf };                                  \
     })
 
 /*
  * zvf_copy() - Copy a constant C string and always NUL terminate the result.
  *
- * The macro behaves like vf_copy() but ensures the destination is terminated
- * even when truncation occurs.  Callers should verify capacity beforehand when
- * possible.
+ * The macro behaves like vf_copy() but ensures the destination is terminated,
+ * including when it is cleared on overflow.  Callers should verify capacity
+ * beforehand when possible.
  */
-#define zvf_copy(vdst, csrc)                                         \
+#define zvf_copy(vdst, csrc) \
+    v_status_publish(zvf_copy_st(vdst, csrc))
+
+/* zvf_copy_st() - zvf_copy() reporting a v_status_t instead of varchar_overflow. */
+#define zvf_copy_st(vdst, csrc)                                      \
     ({                                                               \
+        VS_PROFILE_BEGIN("zvf_copy");                                \
         if (!f_valid(csrc)) {                                        \
             V_WARN("Line %d : zvf_copy(%s, %s) : src buffer is overflowed : bytes used %zu > %zu capacity", \
                 __LINE__, #vdst, #csrc, strlen(csrc), F_SIZE(csrc)); \
         }                                                            \
-        varchar_overflow = 0;                                        \
+        size_t __ovf = 0;                                            \
         size_t __cap = ZV_CAPACITY(vdst);                            \
         size_t __n = strlen(csrc);                                   \
         if (__n > __cap) {                                           \
-            varchar_overflow = __n - __cap;                          \
+            __ovf = __n - __cap;                                     \
             V_WARN("Line %d : zv_copy(%s, %s) : overflow : bytes required %zu > %zu capacity", \
                   __LINE__, #vdst, #csrc, __n, V_SIZE(vdst));        \
-            __n = __cap;                                             \
+            __n = 0;                                                 \
         }                                                            \
-        memmove(V_BUF(dest), V_BUF(src), __n);                       \
-        (dest).len = __n;                                            \
-        if (V_SIZE(dest) > 0)                                        \
-            V_BUF(dest)[__n] = '\0';                                 \
-        __n;                                                         \
+        VS_TELEMETRY("zvf_copy", V_SIZE(vdst), (__ovf ? __cap + __ovf : __n) + 1, __ovf); \
+        vs_copy(V_BUF(vdst), csrc, __n, V_SIZE(vdst));               \
+        (vdst).len = __n;                                            \
+        if (V_SIZE(vdst) > 0)                                        \
+            V_BUF(vdst)[__n] = '\0';                                 \
+        VS_PROFILE_END();                                            \
+        (v_status_t){ __n, __ovf };                                  \
     })
 
 /*
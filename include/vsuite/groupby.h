@@ -0,0 +1,464 @@
+#ifndef VSUITE_GROUPBY_H
+#define VSUITE_GROUPBY_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+#include <vsuite/varchar.h>
+#include <vsuite/arena.h>
+#include <vsuite/batch.h>
+#include <vsuite/concat.h>
+#include <vsuite/compare.h>
+#include <vsuite/hash.h>
+#include <vsuite/simd.h>
+
+/*
+ * Client-side group-by aggregation.
+ *
+ * Summing amounts by (entity, resp_org, nat_acct, ...) before an insert
+ * otherwise needs a round trip to the database or a scan of every group
+ * per row.  A vs_group_t hashes the key columns of each row, finds or adds
+ * the group and adds the row's values to its sums:
+ *
+ *     vs_group_t *g = vs_group_create(3, 1, 1000);
+ *     int64_t *sum = v_group_row(g, entity, resp_org, nat_acct);
+ *     sum[0] += amount_cents;
+ *     ...
+ *     for (size_t id = 0; id < vs_group_count(g); id++) {
+ *         v_group_key(out_acct, g, id, 2);
+ *         total = vs_group_sums(g, id)[0];
+ *         ...
+ *     }
+ *
+ * or a host array fetch at a time with vb_group_add().  Values are 64-bit
+ * integers, such as amounts scaled by v_to_decimal(), so sums are exact and
+ * independent of row order.  Groups get dense ids in first-seen order.
+ *
+ * Memory grows with the number of groups, never with the number of rows:
+ * each group costs its key bytes plus two bytes per key column, 8 bytes per
+ * value column and 32 to 48 bytes of table, index and row count, with the
+ * arrays at most twice their need; vs_group_bytes() reports the total.
+ * Passing the expected number of groups to vs_group_create() skips the
+ * growth steps.
+ */
+
+/* Most key columns a group-by accepts. */
+#define VS_GROUP_KEYS_MAX 16
+
+/*
+ * vs_group_col_t - One key column of a host array, as taken by vb_group_add().
+ * Build it with VB_GROUP_COL().
+ */
+typedef struct {
+    const char *base;
+    size_t stride;
+    size_t arr_off;
+    size_t cap;
+} vs_group_col_t;
+
+/* VB_GROUP_COL() - Describe the VARCHAR host array @a as a key column. */
+#define VB_GROUP_COL(a) ((vs_group_col_t){ VB_ARGS(a) })
+
+/*
+ * vs_group_t - Aggregation state.
+ * @nkeys: Key columns per row.
+ * @nvals: Value columns per row.
+ * @slots: Open-addressing table of ``(hash >> 32) << 32 | (id + 1)``; zero
+ *         marks an empty slot.  The stored hash bits reject most mismatches
+ *         without touching the group's key.
+ * @mask:  Number of slots minus one; the table is a power of two.
+ * @shift: ``64 - log2(slots)``: a key's home slot is the top bits of its
+ *         hash, which the slot itself holds, so growing never rereads keys.
+ * @keys:  Encoded key of each group: per column, a 2-byte length and the
+ *         bytes.
+ * @sums:  @nvals sums per group.
+ * @rows:  Rows added to each group.
+ * @count: Number of groups.
+ * @cap:   Groups the arrays have room for.
+ * @arena: Storage for the encoded keys.
+ */
+typedef struct {
+    size_t nkeys;
+    size_t nvals;
+    uint64_t *slots;
+    size_t mask;
+    unsigned shift;
+    const char **keys;
+    int64_t *sums;
+    uint64_t *rows;
+    size_t count;
+    size_t cap;
+    vs_arena_t *arena;
+} vs_group_t;
+
+/* vs_group_destroy() - Release @g and every group. */
+static inline void vs_group_destroy(vs_group_t *g)
+{
+    if (!g)
+        return;
+    free(g->slots);
+    free(g->keys);
+    free(g->sums);
+    free(g->rows);
+    vs_arena_destroy(g->arena);
+    free(g);
+}
+
+/* vs_group_reserve() - Make room for @cap groups in the per-group arrays. */
+static inline int vs_group_reserve(vs_group_t *g, size_t cap)
+{
+    const char **keys = realloc(g->keys, cap * sizeof *keys);
+    if (!keys)
+        return -1;
+    g->keys = keys;
+    int64_t *sums = realloc(g->sums, cap * (g->nvals ? g->nvals : 1) * sizeof *sums);
+    if (!sums)
+        return -1;
+    g->sums = sums;
+    uint64_t *rows = realloc(g->rows, cap * sizeof *rows);
+    if (!rows)
+        return -1;
+    g->rows = rows;
+    g->cap = cap;
+    return 0;
+}
+
+/*
+ * vs_group_create() - Allocate a group-by over @nkeys key columns and
+ * @nvals value columns, sized for about @expected groups.
+ *
+ * Returns ``NULL`` on allocation failure or when @nkeys is 0 or more than
+ * VS_GROUP_KEYS_MAX.
+ */
+static inline vs_group_t *vs_group_create(size_t nkeys, size_t nvals,
+                                          size_t expected)
+{
+    if (nkeys == 0 || nkeys > VS_GROUP_KEYS_MAX)
+        return NULL;
+    vs_group_t *g = calloc(1, sizeof *g);
+    if (!g)
+        return NULL;
+    g->nkeys = nkeys;
+    g->nvals = nvals;
+    size_t nslots = 16;
+    g->shift = 60;
+    while (nslots < 2 * expected && g->shift > 32) {
+        nslots *= 2;
+        g->shift--;
+    }
+    g->mask = nslots - 1;
+    g->slots = calloc(nslots, sizeof *g->slots);
+    size_t chunk = expected * (nkeys * 8 + 8);
+    g->arena = vs_arena_create(chunk > 4096 ? chunk : 4096);
+    if (!g->slots || !g->arena ||
+        vs_group_reserve(g, expected ? expected : 8) != 0) {
+        vs_group_destroy(g);
+        return NULL;
+    }
+    return g;
+}
+
+/* vs_group_count() - Number of groups in @g. */
+static inline size_t vs_group_count(const vs_group_t *g) { return g->count; }
+
+/* vs_group_sums() - The nvals sums of group @id. */
+static inline const int64_t *vs_group_sums(const vs_group_t *g, size_t id)
+{
+    return &g->sums[id * g->nvals];
+}
+
+/* vs_group_rows() - Number of rows added to group @id. */
+static inline uint64_t vs_group_rows(const vs_group_t *g, size_t id)
+{
+    return g->rows[id];
+}
+
+/* vs_group_key() - Key column @k of group @id; its length is stored in *@len. */
+static inline const char *vs_group_key(const vs_group_t *g, size_t id,
+                                       size_t k, size_t *len)
+{
+    const char *p = g->keys[id];
+    for (size_t i = 0; i < k; i++)
+        p += 2 + vs_load16(p);
+    *len = vs_load16(p);
+    return p + 2;
+}
+
+/* vs_group_bytes() - Heap bytes held by @g. */
+static inline size_t vs_group_bytes(const vs_group_t *g)
+{
+    return (g->mask + 1) * sizeof *g->slots +
+           g->cap * (sizeof *g->keys + g->nvals * sizeof *g->sums +
+                     sizeof *g->rows) +
+           vs_arena_used(g->arena);
+}
+
+/* vs_group_hash() - Hash of the key columns ``buf[k][0..len[k])``. */
+static inline uint64_t vs_group_hash(const char *const *buf, const size_t *len,
+                                     size_t nkeys)
+{
+    uint64_t h = VS_HASH_SEED;
+    for (size_t k = 0; k < nkeys; k++)
+        h = vs_hash(buf[k], len[k], h);
+    return h;
+}
+
+/* vs_group_key_eq() - Nonzero when the encoded key @p holds the given columns. */
+static inline int vs_group_key_eq(const char *p, const char *const *buf,
+                                  const size_t *len, size_t nkeys)
+{
+    for (size_t k = 0; k < nkeys; k++) {
+        size_t n = vs_load16(p);
+        if (n != len[k] || !vs_mem_eq(p + 2, buf[k], n))
+            return 0;
+        p += 2 + n;
+    }
+    return 1;
+}
+
+/*
+ * vs_group_grow() - Double the table.  Each slot already holds the top 32
+ * bits of its hash, so the slots are moved without reading any key.
+ */
+static inline int vs_group_grow(vs_group_t *g)
+{
+    if (g->shift == 32)
+        return -1;
+    size_t nslots = 2 * (g->mask + 1);
+    unsigned shift = g->shift - 1;
+    uint64_t *slots = calloc(nslots, sizeof *slots);
+    if (!slots)
+        return -1;
+    for (size_t j = 0; j <= g->mask; j++) {
+        uint64_t s = g->slots[j];
+        if (!s)
+            continue;
+        size_t i = (size_t)(s >> shift);
+        while (slots[i])
+            i = (i + 1) & (nslots - 1);
+        slots[i] = s;
+    }
+    free(g->slots);
+    g->slots = slots;
+    g->mask = nslots - 1;
+    g->shift = shift;
+    return 0;
+}
+
+/*
+ * vs_group_insert() - Add the group of a key that vs_group_row_hashed()
+ * did not find; @i is the empty slot its probe ended on.
+ */
+static inline int64_t *vs_group_insert(vs_group_t *g, const char *const *buf,
+                                       const size_t *len, uint64_t h, size_t i)
+{
+    uint64_t tag = (h >> 32) << 32;
+    size_t size = 0;
+    for (size_t k = 0; k < g->nkeys; k++) {
+        if (len[k] > UINT16_MAX)
+            return NULL;
+        size += 2 + len[k];
+    }
+    if (g->count >= UINT32_MAX - 1)
+        return NULL;
+    if (g->count == g->cap && vs_group_reserve(g, 2 * g->cap) != 0)
+        return NULL;
+    if (2 * (g->count + 1) > g->mask + 1) {
+        if (vs_group_grow(g) != 0)
+            return NULL;
+        for (i = (size_t)(h >> g->shift); g->slots[i]; i = (i + 1) & g->mask)
+            ;
+    }
+    char *p = vs_arena_take(g->arena, size, 1);
+    if (!p)
+        return NULL;
+    g->keys[g->count] = p;
+    for (size_t k = 0; k < g->nkeys; k++) {
+        uint16_t n = (uint16_t)len[k];
+        memcpy(p, &n, 2);
+        memcpy(p + 2, buf[k], n);
+        p += 2 + n;
+    }
+    size_t id = g->count++;
+    g->slots[i] = tag | (id + 1);
+    g->rows[id] = 1;
+    int64_t *sums = &g->sums[id * g->nvals];
+    for (size_t v = 0; v < g->nvals; v++)
+        sums[v] = 0;
+    return sums;
+}
+
+/*
+ * vs_group_row_hashed() - vs_group_row() with the hash already computed.
+ * Always inlined so that a constant @nkeys unrolls the key compare.
+ */
+static inline __attribute__((always_inline))
+int64_t *vs_group_row_hashed(vs_group_t *g, const char *const *buf,
+                             const size_t *len, size_t nkeys, uint64_t h)
+{
+    uint64_t tag = (h >> 32) << 32;
+    size_t i = (size_t)(h >> g->shift);
+    for (;;) {
+        uint64_t s = g->slots[i];
+        if (s == 0)
+            return vs_group_insert(g, buf, len, h, i);
+        if ((s & ~(uint64_t)UINT32_MAX) == tag) {
+            size_t id = (uint32_t)s - 1;
+            if (vs_group_key_eq(g->keys[id], buf, len, nkeys)) {
+                g->rows[id]++;
+                return &g->sums[id * g->nvals];
+            }
+        }
+        i = (i + 1) & g->mask;
+    }
+}
+
+/*
+ * vs_group_row() - Sums of the group of the key columns
+ * ``buf[k][0..len[k])``, adding the group if it is new.
+ * @nkeys: Number of columns passed; must match the group-by.
+ *
+ * Counts the row and returns the group's nvals sums for the caller to add
+ * to; a new group starts at zero.  The pointer is valid until the next
+ * group is added.  Returns ``NULL`` on allocation failure, on a column
+ * count mismatch or for a column longer than a VARCHAR can be.
+ */
+static inline int64_t *vs_group_row(vs_group_t *g, const char *const *buf,
+                                    const size_t *len, size_t nkeys)
+{
+    if (nkeys != g->nkeys)
+        return NULL;
+    return vs_group_row_hashed(g, buf, len, nkeys,
+                               vs_group_hash(buf, len, nkeys));
+}
+
+/*
+ * v_group_row() - vs_group_row() with the VARCHAR key columns in ``...``.
+ *
+ *     int64_t *s = v_group_row(g, entity, resp_org, nat_acct);
+ *     if (s) { s[0] += debit; s[1] += credit; }
+ */
+#define v_group_row(g, ...)                                                  \
+    ({                                                                       \
+        const char *const __gbuf[] =                                         \
+            { VS_FOREACH(VS_CONCAT_BUF, __VA_ARGS__) };                      \
+        const size_t __glen[] = { VS_FOREACH(VS_CONCAT_LEN, __VA_ARGS__) };  \
+        vs_group_row((g), __gbuf, __glen, sizeof __glen / sizeof __glen[0]); \
+    })
+
+/*
+ * vb_group_add_n() - vb_group_add() for @nkeys key columns.  Always inlined
+ * so that the common small counts get an unrolled hash and compare.
+ */
+static inline __attribute__((always_inline))
+int vb_group_add_n(vs_group_t *g, const vs_group_col_t *cols,
+                   const int64_t *const *vals, size_t nrows, size_t nkeys)
+{
+    enum { AHEAD = 8 };
+    const char *buf[AHEAD][VS_GROUP_KEYS_MAX];
+    size_t len[AHEAD][VS_GROUP_KEYS_MAX];
+    uint64_t hash[AHEAD];
+    for (size_t r = 0; r < nrows; r += AHEAD) {
+        size_t n = nrows - r < AHEAD ? nrows - r : AHEAD;
+        for (size_t j = 0; j < n; j++) {
+            for (size_t k = 0; k < nkeys; k++) {
+                const char *row = cols[k].base + (r + j) * cols[k].stride;
+                len[j][k] = VB_LEN(row) < cols[k].cap ? VB_LEN(row) : cols[k].cap;
+                buf[j][k] = row + cols[k].arr_off;
+            }
+            hash[j] = vs_group_hash(buf[j], len[j], nkeys);
+            __builtin_prefetch(&g->slots[(size_t)(hash[j] >> g->shift)]);
+        }
+        for (size_t j = 0; j < n; j++) {
+            int64_t *sums = vs_group_row_hashed(g, buf[j], len[j], nkeys, hash[j]);
+            if (!sums)
+                return -1;
+            for (size_t v = 0; v < g->nvals; v++)
+                sums[v] += vals[v][r + j];
+        }
+    }
+    return 0;
+}
+
+/*
+ * vb_group_add() - Add @nrows rows given as key columns and value columns.
+ * @cols:  g->nkeys key columns, from VB_GROUP_COL().
+ * @vals:  g->nvals arrays of @nrows values; may be ``NULL`` when nvals is 0.
+ *
+ * Keys are hashed a batch of rows ahead and their table slots prefetched,
+ * so the cache misses of neighbouring rows overlap.  Returns 0, or -1 on
+ * allocation failure, after adding the rows before the failing one.
+ */
+static inline int vb_group_add(vs_group_t *g, const vs_group_col_t *cols,
+                               const int64_t *const *vals, size_t nrows)
+{
+    switch (g->nkeys) {
+    case 1:  return vb_group_add_n(g, cols, vals, nrows, 1);
+    case 2:  return vb_group_add_n(g, cols, vals, nrows, 2);
+    case 3:  return vb_group_add_n(g, cols, vals, nrows, 3);
+    default: return vb_group_add_n(g, cols, vals, nrows, g->nkeys);
+    }
+}
+
+/*
+ * v_group_key() - Copy key column @k of group @id into the VARCHAR @v.
+ *
+ * Like v_copy(), truncates to the capacity of @v and records the bytes that
+ * did not fit in ``varchar_overflow``.  Sets ``v.len`` and returns it.
+ */
+#define v_group_key(v, g, id, k) v_status_publish(v_group_key_st(v, g, id, k))
+
+/* v_group_key_st() - v_group_key() reporting a v_status_t instead of varchar_overflow. */
+#define v_group_key_st(v, g, id, k)                                          \
+    ({                                                                       \
+        size_t __n, __ovf = 0;                                               \
+        const char *__s = vs_group_key((g), (id), (k), &__n);                \
+        if (__n > V_SIZE(v)) {                                               \
+            __ovf = __n - V_SIZE(v);                                         \
+            V_WARN("Line %d : v_group_key(%s, %s, %s, %s) : overflow : %zu bytes dropped", \
+                   __LINE__, #v, #g, #id, #k, __ovf);                        \
+            __n = V_SIZE(v);                                                 \
+        }                                                                    \
+        vs_copy(V_BUF(v), __s, __n, V_SIZE(v));                              \
+        (v).len = (unsigned short)__n;                                       \
+        (v_status_t){ __n, __ovf };                                          \
+    })
+
+/*
+ * vb_group_keys() - Fill the VARCHAR host array @dst with key column @k of
+ * groups 0 .. min(@count, groups) - 1, ready for an array insert.
+ *
+ * Each element's ``len`` is set.  Returns the total bytes stored; the bytes
+ * dropped by truncation are left in ``varchar_overflow``.
+ */
+#define vb_group_keys(dst, count, g, k) \
+    v_status_publish(vb_group_keys_st(dst, count, g, k))
+
+/* vb_group_keys_st() - vb_group_keys() reporting a v_status_t instead of varchar_overflow. */
+#define vb_group_keys_st(dst, count, g, k)                                   \
+    ({                                                                       \
+        const vs_group_t *__g = (g);                                         \
+        size_t __cnt = (count), __bytes = 0, __ovf = 0;                      \
+        if (__cnt > vs_group_count(__g))                                     \
+            __cnt = vs_group_count(__g);                                     \
+        for (size_t __i = 0; __i < __cnt; __i++) {                           \
+            size_t __n;                                                      \
+            const char *__s = vs_group_key(__g, __i, (k), &__n);             \
+            if (__n > V_SIZE((dst)[__i])) {                                  \
+                __ovf += __n - V_SIZE((dst)[__i]);                           \
+                __n = V_SIZE((dst)[__i]);                                    \
+            }                                                                \
+            vs_copy(V_BUF((dst)[__i]), __s, __n, V_SIZE((dst)[__i]));        \
+            (dst)[__i].len = (unsigned short)__n;                            \
+            __bytes += __n;                                                  \
+        }                                                                    \
+        if (__ovf) {                                                         \
+            V_WARN("Line %d : vb_group_keys(%s, %s, %s, %s) : overflow : %zu bytes dropped over %zu elements", \
+                   __LINE__, #dst, #count, #g, #k, __ovf, __cnt);            \
+        }                                                                    \
+        (v_status_t){ __bytes, __ovf };                                      \
+    })
+
+#endif /* VSUITE_GROUPBY_H */
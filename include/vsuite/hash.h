@@ -0,0 +1,186 @@
+#ifndef VSUITE_HASH_H
+#define VSUITE_HASH_H
+
+#include <stdint.h>
+#include <string.h>
+#include <stddef.h>
+
+#include <vsuite/varchar.h>
+#include <vsuite/concat.h>
+#include <vsuite/simd.h>
+
+/*
+ * Non-cryptographic hashing of VARCHAR contents.
+ *
+ * v_hash() reads ``len`` bytes as 64-bit words and mixes them with a wide
+ * multiply, in the style of wyhash.  Values of 8 bytes or less, the common
+ * code column, are one overlapping word and one multiply.  v_casehash()
+ * folds ASCII letters as it loads, so it agrees with v_caseeq().
+ *
+ * Every hash takes a seed, and a hash is a good seed for the next field, so
+ * a record key can be hashed field by field without building the
+ * concatenated string:
+ *
+ *     uint64_t h = v_hash_fields(entity, resp_org, nat_acct);
+ *
+ * The values are not stable across releases; do not store them.
+ */
+
+#define VS_HASH_SEED 0x243F6A8885A308D3ULL
+
+#define VS_HASH_K0 0xA0761D6478BD642FULL
+#define VS_HASH_K1 0xE7037ED1A0B428DBULL
+#define VS_HASH_K2 0x8EBC6AF09C88C6E3ULL
+
+/* vs_hash_mum() - Fold the 128-bit product of @a and @b into 64 bits. */
+static inline uint64_t vs_hash_mum(uint64_t a, uint64_t b)
+{
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 r = (unsigned __int128)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+#else
+    uint64_t lo = a * b;
+    uint64_t hi = (a >> 32) * (b >> 32) +
+                  (((a >> 32) * (uint32_t)b + (uint32_t)a * (b >> 32)) >> 32);
+    return lo ^ hi;
+#endif
+}
+
+/* vs_hash_word() - Load 8 bytes at @p, folding ASCII letters when @fold. */
+static inline uint64_t vs_hash_word(const char *p, int fold)
+{
+    uint64_t w = vs_load64(p);
+    return fold ? vs_case_word(w, 'A') : w;
+}
+
+/*
+ * vs_hash_short() - Word holding all of a 0 to 8 byte value: two
+ * overlapping 4-byte loads, or the first, middle and last bytes.
+ */
+static inline uint64_t vs_hash_short(const char *s, size_t n, int fold)
+{
+    uint64_t w;
+    if (n >= 4)
+        w = vs_load32(s) | (uint64_t)vs_load32(s + n - 4) << 32;
+    else if (n > 0)
+        w = (uint64_t)(unsigned char)s[0] |
+            (uint64_t)(unsigned char)s[n >> 1] << 8 |
+            (uint64_t)(unsigned char)s[n - 1] << 16;
+    else
+        w = 0;
+    return fold ? vs_case_word(w, 'A') : w;
+}
+
+/*
+ * vs_hash_fcn() - Hash @n bytes of @s with @seed.
+ * @fold: Nonzero to fold ASCII ``'A'..'Z'`` to lower case first.
+ *
+ * Inputs over 48 bytes run three independent lanes of 16 bytes; the last
+ * 16 bytes are read with an overlapping load, so there is no byte loop.
+ */
+static inline __attribute__((always_inline))
+uint64_t vs_hash_fcn(const char *s, size_t n, uint64_t seed, int fold)
+{
+    uint64_t a, b;
+    seed ^= vs_hash_mum(seed ^ VS_HASH_K0, VS_HASH_K1);
+    if (__builtin_expect(n <= 8, 1)) {
+        a = vs_hash_short(s, n, fold);
+        b = 0;
+    } else if (n <= 16) {
+        a = vs_hash_word(s, fold);
+        b = vs_hash_word(s + n - 8, fold);
+    } else {
+        const char *p = s;
+        size_t left = n;
+        if (left > 48) {
+            uint64_t s1 = seed, s2 = seed;
+            do {
+                seed = vs_hash_mum(vs_hash_word(p, fold) ^ VS_HASH_K1,
+                                   vs_hash_word(p + 8, fold) ^ seed);
+                s1 = vs_hash_mum(vs_hash_word(p + 16, fold) ^ VS_HASH_K2,
+                                 vs_hash_word(p + 24, fold) ^ s1);
+                s2 = vs_hash_mum(vs_hash_word(p + 32, fold) ^ VS_HASH_K0,
+                                 vs_hash_word(p + 40, fold) ^ s2);
+                p += 48;
+                left -= 48;
+            } while (left > 48);
+            seed ^= s1 ^ s2;
+        }
+        while (left > 16) {
+            seed = vs_hash_mum(vs_hash_word(p, fold) ^ VS_HASH_K1,
+                               vs_hash_word(p + 8, fold) ^ seed);
+            p += 16;
+            left -= 16;
+        }
+        a = vs_hash_word(s + n - 16, fold);
+        b = vs_hash_word(s + n - 8, fold);
+    }
+    a ^= VS_HASH_K1;
+    b ^= seed;
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 r = (unsigned __int128)a * b;
+    a = (uint64_t)r;
+    b = (uint64_t)(r >> 64);
+#else
+    a = vs_hash_mum(a, b);
+    b = vs_hash_mum(b, VS_HASH_K2);
+#endif
+    return vs_hash_mum(a ^ VS_HASH_K0 ^ n, b ^ VS_HASH_K1);
+}
+
+/* vs_hash() - Hash @n bytes of @s, continuing from @seed. */
+static inline uint64_t vs_hash(const char *s, size_t n, uint64_t seed)
+{
+    return vs_hash_fcn(s, n, seed, 0);
+}
+
+/* vs_casehash() - vs_hash() with ASCII letters folded to lower case. */
+static inline uint64_t vs_casehash(const char *s, size_t n, uint64_t seed)
+{
+    return vs_hash_fcn(s, n, seed, 1);
+}
+
+/* vs_hash_u64() - Hash the integer @x, continuing from @seed. */
+static inline uint64_t vs_hash_u64(uint64_t x, uint64_t seed)
+{
+    seed ^= vs_hash_mum(seed ^ VS_HASH_K0, VS_HASH_K1);
+    return vs_hash_mum(vs_hash_mum(x ^ VS_HASH_K1, seed ^ VS_HASH_K2) ^
+                       VS_HASH_K0, VS_HASH_K1 ^ 8);
+}
+
+/* v_hash() - Hash the contents of the VARCHAR @v. */
+#define v_hash(v) vs_hash(V_BUF(v), V_LEN(v), VS_HASH_SEED)
+
+/* v_casehash() - v_hash() ignoring ASCII case; equal for v_caseeq() values. */
+#define v_casehash(v) vs_casehash(V_BUF(v), V_LEN(v), VS_HASH_SEED)
+
+/*
+ * v_hash_seed() - Hash @v continuing from @seed, usually the hash of the
+ * previous field.  The length is mixed in, so ("AB", "C") and ("A", "BC")
+ * hash differently.
+ */
+#define v_hash_seed(v, seed) vs_hash(V_BUF(v), V_LEN(v), (seed))
+
+/* v_casehash_seed() - v_hash_seed() ignoring ASCII case. */
+#define v_casehash_seed(v, seed) vs_casehash(V_BUF(v), V_LEN(v), (seed))
+
+#define VS_HASH_FIELD(v, k)     __hf = v_hash_seed(v, __hf);
+#define VS_CASEHASH_FIELD(v, k) __hf = v_casehash_seed(v, __hf);
+
+/* v_hash_fields() - Hash one to VS_CONCAT_MAX VARCHARs as one composite key. */
+#define v_hash_fields(...)                                                   \
+    ({                                                                       \
+        uint64_t __hf = VS_HASH_SEED;                                        \
+        VS_FOREACH(VS_HASH_FIELD, __VA_ARGS__)                               \
+        __hf;                                                                \
+    })
+
+/* v_casehash_fields() - v_hash_fields() ignoring ASCII case. */
+#define v_casehash_fields(...)                                               \
+    ({                                                                       \
+        uint64_t __hf = VS_HASH_SEED;                                        \
+        VS_FOREACH(VS_CASEHASH_FIELD, __VA_ARGS__)                           \
+        __hf;                                                                \
+    })
+
+#endif /* VSUITE_HASH_H */
@@ -0,0 +1,275 @@
+#ifndef VSUITE_INTERN_H
+#define VSUITE_INTERN_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+#include <vsuite/varchar.h>
+#include <vsuite/arena.h>
+
+/*
+ * String interning for low-cardinality code columns.
+ *
+ * Columns such as entity, resp_org or rpt_class hold a few dozen distinct
+ * values across millions of rows.  An intern pool maps each distinct value
+ * to a dense ``uint32_t`` id and keeps one canonical, NUL terminated copy:
+ *
+ *     vs_intern_t *orgs = vs_intern_create(64);
+ *     uint32_t id = v_intern(orgs, resp_org);
+ *     if (id == row->perf_org_id) ...          (integer compare)
+ *     puts(vs_intern_str(orgs, id));
+ *
+ * Ids count up from zero in insertion order, so they can index arrays.
+ * Canonical strings live in an arena and never move while the pool exists.
+ */
+
+/* Returned when a value is not in the pool, or could not be added. */
+#define VS_INTERN_NONE UINT32_MAX
+
+typedef struct {
+    const char *str;
+    uint32_t len;
+    uint32_t hash;
+} vs_intern_entry_t;
+
+/*
+ * vs_intern_t - Intern pool.
+ * @slots:   Open-addressing table of ``id + 1``; zero marks an empty slot.
+ * @mask:    Number of slots minus one; the table is a power of two.
+ * @entries: Canonical values indexed by id.
+ * @count:   Number of ids handed out.
+ * @cap:     Allocated length of @entries.
+ * @strings: Storage for the canonical copies.
+ */
+typedef struct {
+    uint32_t *slots;
+    size_t mask;
+    vs_intern_entry_t *entries;
+    size_t count;
+    size_t cap;
+    vs_arena_t *strings;
+} vs_intern_t;
+
+/*
+ * vs_intern_word() - The first @n < 8 bytes of @s as one word, read with at
+ * most two loads.  Every byte is included, so equal-length values are equal
+ * exactly when their words are.
+ */
+static inline uint64_t vs_intern_word(const char *s, size_t n)
+{
+    if (n >= 4)
+        return vs_load32(s) | (uint64_t)vs_load32(s + n - 4) << 32;
+    if (n > 0)
+        return (uint64_t)(unsigned char)s[0] |
+               (uint64_t)(unsigned char)s[n >> 1] << 8 |
+               (uint64_t)(unsigned char)s[n - 1] << 16;
+    return 0;
+}
+
+/*
+ * vs_intern_hash() - Hash @n bytes of @s for the intern table.
+ *
+ * Codes are short, so the bytes are read as whole words: overlapping loads
+ * cover the tail, and each word is folded in with a multiply.
+ */
+static inline uint32_t vs_intern_hash(const char *s, size_t n)
+{
+    uint64_t h = 0x9E3779B97F4A7C15ULL ^ n, w;
+    if (n >= 8) {
+        const char *last = s + n - 8;
+        for (; s < last; s += 8) {
+            h = (h ^ vs_load64(s)) * 0xFF51AFD7ED558CCDULL;
+            h ^= h >> 32;
+        }
+        w = vs_load64(last);
+    } else {
+        w = vs_intern_word(s, n);
+    }
+    h = (h ^ w) * 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 29;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    return (uint32_t)(h >> 32);
+}
+
+/* vs_intern_eq() - Compare two values of @n bytes. */
+static inline int vs_intern_eq(const char *a, const char *b, size_t n)
+{
+    if (n < 8)
+        return vs_intern_word(a, n) == vs_intern_word(b, n);
+    return memcmp(a, b, n) == 0;
+}
+
+/*
+ * vs_intern_create() - Allocate a pool sized for about @expected values.
+ *
+ * The pool grows past @expected as needed.  Returns ``NULL`` on allocation
+ * failure.
+ */
+static inline vs_intern_t *vs_intern_create(size_t expected)
+{
+    vs_intern_t *p = calloc(1, sizeof *p);
+    if (!p)
+        return NULL;
+    size_t nslots = 16;
+    while (nslots < 2 * expected)
+        nslots *= 2;
+    p->mask = nslots - 1;
+    p->cap = expected ? expected : 8;
+    p->slots = calloc(nslots, sizeof *p->slots);
+    p->entries = malloc(p->cap * sizeof *p->entries);
+    p->strings = vs_arena_create(p->cap * 16);
+    if (!p->slots || !p->entries || !p->strings) {
+        free(p->slots);
+        free(p->entries);
+        vs_arena_destroy(p->strings);
+        free(p);
+        return NULL;
+    }
+    return p;
+}
+
+/* vs_intern_destroy() - Release @p and every canonical string. */
+static inline void vs_intern_destroy(vs_intern_t *p)
+{
+    if (!p)
+        return;
+    free(p->slots);
+    free(p->entries);
+    vs_arena_destroy(p->strings);
+    free(p);
+}
+
+/* vs_intern_count() - Number of distinct values in @p. */
+static inline size_t vs_intern_count(const vs_intern_t *p) { return p->count; }
+
+/* vs_intern_str() - Canonical NUL terminated copy of value @id. */
+static inline const char *vs_intern_str(const vs_intern_t *p, uint32_t id)
+{
+    return p->entries[id].str;
+}
+
+/* vs_intern_len() - Length of value @id. */
+static inline size_t vs_intern_len(const vs_intern_t *p, uint32_t id)
+{
+    return p->entries[id].len;
+}
+
+/*
+ * vs_intern_find() - Slot holding @s[0..n), or the empty slot where it
+ * would go.
+ */
+static inline uint32_t *vs_intern_find(const vs_intern_t *p, const char *s,
+                                       size_t n, uint32_t hash)
+{
+    size_t i = hash & p->mask;
+    for (;;) {
+        uint32_t *slot = &p->slots[i];
+        if (*slot == 0)
+            return slot;
+        const vs_intern_entry_t *e = &p->entries[*slot - 1];
+        if (e->hash == hash && e->len == n && vs_intern_eq(e->str, s, n))
+            return slot;
+        i = (i + 1) & p->mask;
+    }
+}
+
+/* vs_intern_grow() - Double the table, rehashing the stored hashes. */
+static inline int vs_intern_grow(vs_intern_t *p)
+{
+    size_t nslots = 2 * (p->mask + 1);
+    uint32_t *slots = calloc(nslots, sizeof *slots);
+    if (!slots)
+        return -1;
+    for (size_t id = 0; id < p->count; id++) {
+        size_t i = p->entries[id].hash & (nslots - 1);
+        while (slots[i])
+            i = (i + 1) & (nslots - 1);
+        slots[i] = (uint32_t)id + 1;
+    }
+    free(p->slots);
+    p->slots = slots;
+    p->mask = nslots - 1;
+    return 0;
+}
+
+/*
+ * vs_intern_lookup() - Id of @s[0..n), or VS_INTERN_NONE when it has not
+ * been interned.  Never modifies the pool.
+ */
+static inline uint32_t vs_intern_lookup(const vs_intern_t *p, const char *s,
+                                        size_t n)
+{
+    uint32_t slot = *vs_intern_find(p, s, n, vs_intern_hash(s, n));
+    return slot ? slot - 1 : VS_INTERN_NONE;
+}
+
+/*
+ * vs_intern() - Id of @s[0..n), adding it to the pool if it is new.
+ *
+ * Returns VS_INTERN_NONE on allocation failure or when the value is longer
+ * than a VARCHAR can be.
+ */
+static inline uint32_t vs_intern(vs_intern_t *p, const char *s, size_t n)
+{
+    uint32_t hash = vs_intern_hash(s, n);
+    uint32_t *slot = vs_intern_find(p, s, n, hash);
+    if (*slot)
+        return *slot - 1;
+    if (n > UINT16_MAX || p->count >= VS_INTERN_NONE - 1)
+        return VS_INTERN_NONE;
+    if (p->count == p->cap) {
+        vs_intern_entry_t *e = realloc(p->entries, 2 * p->cap * sizeof *e);
+        if (!e)
+            return VS_INTERN_NONE;
+        p->entries = e;
+        p->cap *= 2;
+    }
+    if (2 * (p->count + 1) > p->mask + 1) {
+        /* Past half full probing slows down; a failed grow is tolerated
+         * while one slot stays empty to end the probe loop. */
+        if (vs_intern_grow(p) != 0 && p->count + 2 > p->mask + 1)
+            return VS_INTERN_NONE;
+        slot = vs_intern_find(p, s, n, hash);
+    }
+    const char *str = vs_arena_strndup(p->strings, s, n);
+    if (!str)
+        return VS_INTERN_NONE;
+    uint32_t id = (uint32_t)p->count++;
+    p->entries[id] = (vs_intern_entry_t){ str, (uint32_t)n, hash };
+    *slot = id + 1;
+    return id;
+}
+
+/* v_intern() - Intern the VARCHAR @v in pool @p; see vs_intern(). */
+#define v_intern(p, v) vs_intern((p), V_BUF(v), V_LEN(v))
+
+/* v_intern_lookup() - Id of the VARCHAR @v without adding it. */
+#define v_intern_lookup(p, v) vs_intern_lookup((p), V_BUF(v), V_LEN(v))
+
+/*
+ * v_intern_get() - Copy value @id of pool @p into the VARCHAR @v.
+ *
+ * Like v_copy(), truncates to the capacity of @v and records the bytes that
+ * did not fit in ``varchar_overflow``.  Sets ``v.len`` and returns it.
+ */
+#define v_intern_get(v, p, id) v_status_publish(v_intern_get_st(v, p, id))
+
+/* v_intern_get_st() - v_intern_get() reporting a v_status_t instead of varchar_overflow. */
+#define v_intern_get_st(v, p, id)                                            \
+    ({                                                                       \
+        const vs_intern_entry_t *__e = &(p)->entries[(id)];                  \
+        size_t __n = __e->len, __ovf = 0;                                    \
+        if (__n > V_SIZE(v)) {                                               \
+            __ovf = __n - V_SIZE(v);                                         \
+            V_WARN("Line %d : v_intern_get(%s, %s, %s) : overflow : %zu bytes dropped", \
+                   __LINE__, #v, #p, #id, __ovf);                            \
+            __n = V_SIZE(v);                                                 \
+        }                                                                    \
+        vs_copy(V_BUF(v), __e->str, __n, V_SIZE(v));                         \
+        (v).len = (unsigned short)__n;                                       \
+        (v_status_t){ __n, __ovf };                                          \
+    })
+
+#endif /* VSUITE_INTERN_H */
@@ -0,0 +1,427 @@
+#ifndef VSUITE_LOGRING_H
+#define VSUITE_LOGRING_H
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * Asynchronous diagnostics.
+ *
+ * With ``logFile`` unbuffered every diagnostic is one ``write(2)`` on the
+ * thread that hit it.  vs_log_printf() instead formats the message into a
+ * slot of a lock-free ring and returns; a background thread copies ready
+ * slots into one buffer and writes it with a single call.
+ *
+ * The ring is shared by every translation unit of the process.  It is
+ * drained at ``exit`` and, when the default action of SIGSEGV, SIGBUS,
+ * SIGFPE, SIGILL, SIGABRT, SIGTERM or SIGINT would kill the process, by a
+ * handler that writes the published messages before re-raising the signal,
+ * so a crash loses at most the message being formatted.
+ *
+ * varchar-logFile.h routes its diagnostics here when VSUITE_LOG_ASYNC is
+ * defined.  Link with ``-pthread``.
+ */
+
+/* Bytes per ring slot; longer messages are cut and end in "...\n". */
+#ifndef VS_LOG_SLOT
+#define VS_LOG_SLOT 512
+#endif
+
+/* Slots in the ring started on first use; a power of two. */
+#ifndef VS_LOG_SLOTS
+#define VS_LOG_SLOTS 4096
+#endif
+
+/*
+ * Producers wake the drain thread once per this many messages; otherwise it
+ * polls every VS_LOG_IDLE_MS, which bounds how long a message waits.
+ */
+#ifndef VS_LOG_WAKE
+#define VS_LOG_WAKE 64
+#endif
+
+#ifndef VS_LOG_IDLE_MS
+#define VS_LOG_IDLE_MS 10
+#endif
+
+/* Largest single write of the drain thread. */
+#ifndef VS_LOG_WRITE
+#define VS_LOG_WRITE 65536
+#endif
+
+/*
+ * vs_log_slot_t - One message.
+ * @seq:  Ring position the slot is free for, or that position + 1 once the
+ *        message is published.
+ * @len:  Bytes of @data to write.
+ * @data: The formatted message.
+ */
+typedef struct {
+    uint64_t seq;
+    uint32_t len;
+    char data[VS_LOG_SLOT - 12];
+} vs_log_slot_t;
+
+enum { VS_LOG_OFF, VS_LOG_STARTING, VS_LOG_RUNNING, VS_LOG_STOPPED };
+
+/*
+ * vs_log_ring_t - Process-wide ring state.
+ * @state:     One of VS_LOG_OFF .. VS_LOG_STOPPED.
+ * @tail:      Next position producers claim.
+ * @head:      Next position to write; advanced only after the write.
+ * @draining:  Nonzero while a drainer owns @head.
+ * @sleeping:  Nonzero while the drain thread waits for work.
+ * @truncated: Messages cut to the slot size.
+ * @registered: Nonzero once the ``atexit`` and ``fork`` hooks are in place.
+ */
+typedef struct {
+    int state;
+    int fd;
+    vs_log_slot_t *slots;
+    uint64_t mask;
+    uint64_t tail;
+    uint64_t head;
+    int draining;
+    int sleeping;
+    int stop;
+    size_t truncated;
+    int registered;
+    char *buf;
+    pthread_t thread;
+    pthread_mutex_t mu;
+    pthread_cond_t cv;
+    struct sigaction old[32];
+} vs_log_ring_t;
+
+/* Weak, so every translation unit that includes this header shares it. */
+vs_log_ring_t vs_log_state __attribute__((weak));
+
+#define VS_LOG_LOAD(p)     __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define VS_LOG_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+static const int vs_log_signals[] = {
+    SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT, SIGTERM, SIGINT
+};
+
+/* vs_log_write_all() - write(2) all of @n bytes, retrying short writes. */
+static inline void vs_log_write_all(int fd, const char *p, size_t n)
+{
+    while (n > 0) {
+        ssize_t w = write(fd, p, n);
+        if (w < 0) {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        p += w;
+        n -= (size_t)w;
+    }
+}
+
+/* vs_log_release() - Hand slots [@from, @to) back to the producers. */
+static inline void vs_log_release(vs_log_ring_t *r, uint64_t from, uint64_t to)
+{
+    for (uint64_t p = from; p < to; p++)
+        VS_LOG_STORE(&r->slots[p & r->mask].seq, p + r->mask + 1);
+    VS_LOG_STORE(&r->head, to);
+}
+
+/*
+ * vs_log_drain() - Write the published messages at the head of the ring,
+ * up to VS_LOG_WRITE bytes.  Slots are freed only after the write, so a
+ * crash during it still finds them.  Returns the number of messages.
+ */
+static inline size_t vs_log_drain(vs_log_ring_t *r)
+{
+    int zero = 0;
+    if (!__atomic_compare_exchange_n(&r->draining, &zero, 1, 0,
+                                     __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        return 0;
+    uint64_t head = r->head, pos = head;
+    size_t n = 0;
+    for (;;) {
+        vs_log_slot_t *s = &r->slots[pos & r->mask];
+        if (VS_LOG_LOAD(&s->seq) != pos + 1 || n + s->len > VS_LOG_WRITE)
+            break;
+        memcpy(r->buf + n, s->data, s->len);
+        n += s->len;
+        pos++;
+    }
+    if (n)
+        vs_log_write_all(r->fd, r->buf, n);
+    vs_log_release(r, head, pos);
+    VS_LOG_STORE(&r->draining, 0);
+    return (size_t)(pos - head);
+}
+
+/* vs_log_thread() - Drain thread: write while there is work, else wait. */
+static inline void *vs_log_thread(void *arg)
+{
+    vs_log_ring_t *r = arg;
+    for (;;) {
+        if (vs_log_drain(r))
+            continue;
+        if (VS_LOG_LOAD(&r->stop)) {
+            while (VS_LOG_LOAD(&r->head) != VS_LOG_LOAD(&r->tail))
+                if (!vs_log_drain(r))
+                    sched_yield();
+            return NULL;
+        }
+        __atomic_store_n(&r->sleeping, 1, __ATOMIC_SEQ_CST);
+        uint64_t head = VS_LOG_LOAD(&r->head);
+        if (VS_LOG_LOAD(&r->slots[head & r->mask].seq) == head + 1 ||
+            VS_LOG_LOAD(&r->stop)) {
+            __atomic_store_n(&r->sleeping, 0, __ATOMIC_SEQ_CST);
+            continue;
+        }
+        /* the timeout also covers a wakeup lost between check and wait */
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += VS_LOG_IDLE_MS * 1000 * 1000;
+        if (ts.tv_nsec >= 1000000000) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000;
+        }
+        pthread_mutex_lock(&r->mu);
+        pthread_cond_timedwait(&r->cv, &r->mu, &ts);
+        pthread_mutex_unlock(&r->mu);
+        __atomic_store_n(&r->sleeping, 0, __ATOMIC_SEQ_CST);
+    }
+}
+
+/* vs_log_wake() - Signal the drain thread if it is waiting. */
+static inline void vs_log_wake(vs_log_ring_t *r)
+{
+    if (__atomic_load_n(&r->sleeping, __ATOMIC_SEQ_CST)) {
+        pthread_mutex_lock(&r->mu);
+        pthread_cond_signal(&r->cv);
+        pthread_mutex_unlock(&r->mu);
+    }
+}
+
+/*
+ * vs_log_on_signal() - Fatal signal handler: write every published message
+ * with write(2), restore the previous action and re-raise.
+ *
+ * The drain thread is given a moment to finish a write in progress; if it
+ * does not, the ring is written anyway, which may repeat a few messages.
+ * A child of ``fork`` keeps the handler but not the ring until it logs, so
+ * only a running or stopped ring is written.
+ */
+static inline void vs_log_on_signal(int sig)
+{
+    vs_log_ring_t *r = &vs_log_state;
+    int state = VS_LOG_LOAD(&r->state);
+    if ((state != VS_LOG_RUNNING && state != VS_LOG_STOPPED) || !r->slots)
+        goto reraise;
+    for (long spin = 0; spin < 10000000 && VS_LOG_LOAD(&r->draining); spin++)
+        ;
+    for (uint64_t pos = VS_LOG_LOAD(&r->head);; pos++) {
+        vs_log_slot_t *s = &r->slots[pos & r->mask];
+        if (VS_LOG_LOAD(&s->seq) != pos + 1)
+            break;
+        vs_log_write_all(r->fd, s->data, s->len);
+    }
+reraise:
+    sigaction(sig, &r->old[sig], NULL);
+    raise(sig);                         /* delivered when the handler returns */
+}
+
+/*
+ * vs_log_stop() - Write everything logged so far and stop the drain thread.
+ *
+ * Registered with ``atexit`` by vs_log_start().  Later messages are written
+ * synchronously; the ring is not restarted.
+ */
+static inline void vs_log_stop(void)
+{
+    vs_log_ring_t *r = &vs_log_state;
+    int running = VS_LOG_RUNNING;
+    if (!__atomic_compare_exchange_n(&r->state, &running, VS_LOG_STOPPED, 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        return;
+    VS_LOG_STORE(&r->stop, 1);
+    pthread_mutex_lock(&r->mu);
+    pthread_cond_signal(&r->cv);
+    pthread_mutex_unlock(&r->mu);
+    pthread_join(r->thread, NULL);
+    while (vs_log_drain(r))             /* raced with the thread's exit */
+        ;
+}
+
+/*
+ * vs_log_atfork_child() - The drain thread does not survive ``fork``: the
+ * child starts its own ring on first use.  Messages still queued belong to
+ * the parent, which writes them.
+ */
+static inline void vs_log_atfork_child(void)
+{
+    vs_log_ring_t *r = &vs_log_state;
+    free(r->slots);
+    free(r->buf);
+    r->slots = NULL;
+    r->buf = NULL;
+    r->stop = r->draining = r->sleeping = 0;
+    r->state = VS_LOG_OFF;
+}
+
+/*
+ * vs_log_start() - Start the ring, writing to the file descriptor @fd.
+ * @slots: Ring size, rounded up to a power of two; 0 for VS_LOG_SLOTS.
+ *
+ * Starts the drain thread, registers vs_log_stop() with ``atexit`` and
+ * installs the fatal signal handler where the default action is in place.
+ * Returns 0, or -1 when the ring cannot be allocated or was already
+ * started.  vs_log_printf() starts it on first use.
+ */
+static inline int vs_log_start(int fd, size_t slots)
+{
+    vs_log_ring_t *r = &vs_log_state;
+    int off = VS_LOG_OFF;
+    if (!__atomic_compare_exchange_n(&r->state, &off, VS_LOG_STARTING, 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        return -1;
+    size_t n = 2;
+    while (n < (slots ? slots : VS_LOG_SLOTS))
+        n *= 2;
+    r->slots = malloc(n * sizeof *r->slots);
+    r->buf = malloc(VS_LOG_WRITE);
+    if (!r->slots || !r->buf) {
+        free(r->slots);
+        free(r->buf);
+        VS_LOG_STORE(&r->state, VS_LOG_OFF);
+        return -1;
+    }
+    for (size_t i = 0; i < n; i++)
+        r->slots[i].seq = i;
+    r->mask = n - 1;
+    r->fd = fd;
+    r->head = r->tail = 0;
+    pthread_mutex_init(&r->mu, NULL);
+    pthread_cond_init(&r->cv, NULL);
+    if (pthread_create(&r->thread, NULL, vs_log_thread, r) != 0) {
+        free(r->slots);
+        free(r->buf);
+        VS_LOG_STORE(&r->state, VS_LOG_OFF);
+        return -1;
+    }
+    if (!r->registered) {              /* once per process; fork keeps them */
+        r->registered = 1;
+        atexit(vs_log_stop);
+        pthread_atfork(NULL, NULL, vs_log_atfork_child);
+        for (size_t i = 0; i < sizeof vs_log_signals / sizeof vs_log_signals[0]; i++) {
+            int sig = vs_log_signals[i];
+            struct sigaction sa;
+            memset(&sa, 0, sizeof sa);
+            sa.sa_handler = vs_log_on_signal;
+            sigemptyset(&sa.sa_mask);
+            if (sigaction(sig, NULL, &r->old[sig]) == 0 &&
+                r->old[sig].sa_handler == SIG_DFL)
+                sigaction(sig, &sa, NULL);
+        }
+    }
+    VS_LOG_STORE(&r->state, VS_LOG_RUNNING);
+    return 0;
+}
+
+/*
+ * vs_log_flush() - Wait until every message logged before the call has
+ * been written.  Use it before writing to the log file directly.
+ */
+static inline void vs_log_flush(void)
+{
+    vs_log_ring_t *r = &vs_log_state;
+    if (VS_LOG_LOAD(&r->state) != VS_LOG_RUNNING)
+        return;
+    uint64_t target = VS_LOG_LOAD(&r->tail);
+    while (VS_LOG_LOAD(&r->head) < target) {
+        vs_log_wake(r);
+        sched_yield();
+    }
+}
+
+/* vs_log_truncated() - Number of messages cut to fit a slot. */
+static inline size_t vs_log_truncated(void)
+{
+    return __atomic_load_n(&vs_log_state.truncated, __ATOMIC_RELAXED);
+}
+
+/*
+ * vs_log_vprintf() - vs_log_printf() with a ``va_list``.
+ */
+static inline int vs_log_vprintf(FILE *f, const char *fmt, va_list ap)
+{
+    vs_log_ring_t *r = &vs_log_state;
+    int state = VS_LOG_LOAD(&r->state);
+    if (__builtin_expect(state != VS_LOG_RUNNING, 0)) {
+        if (state == VS_LOG_OFF) {
+            fflush(f);
+            vs_log_start(fileno(f), 0);
+        }
+        while ((state = VS_LOG_LOAD(&r->state)) == VS_LOG_STARTING)
+            sched_yield();
+    }
+    if (state != VS_LOG_RUNNING || fileno(f) != r->fd)
+        return vfprintf(f, fmt, ap);
+
+    uint64_t pos = __atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+    vs_log_slot_t *s;
+    for (;;) {
+        s = &r->slots[pos & r->mask];
+        int64_t diff = (int64_t)(VS_LOG_LOAD(&s->seq) - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&r->tail, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        } else if (diff < 0) {
+            vs_log_wake(r);             /* full: wait for the drain thread */
+            sched_yield();
+            pos = __atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+        } else {
+            pos = __atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    int n = vsnprintf(s->data, sizeof s->data, fmt, ap);
+    if (n < 0) {
+        s->len = 0;
+    } else if ((size_t)n >= sizeof s->data) {
+        memcpy(s->data + sizeof s->data - 5, "...\n", 4);
+        s->len = sizeof s->data - 1;
+        __atomic_fetch_add(&r->truncated, 1, __ATOMIC_RELAXED);
+    } else {
+        s->len = (uint32_t)n;
+    }
+    VS_LOG_STORE(&s->seq, pos + 1);
+    if ((pos & (VS_LOG_WAKE - 1)) == VS_LOG_WAKE - 1)
+        vs_log_wake(r);
+    return n;
+}
+
+/*
+ * vs_log_printf() - Queue a ``printf`` style message for the file @f.
+ *
+ * Starts the ring on @f's descriptor on first use.  Messages for any other
+ * stream, or logged after vs_log_stop(), are written with ``vfprintf``.
+ * Blocks only when the ring is full.  Returns the formatted length.
+ */
+static inline __attribute__((format(printf, 2, 3)))
+int vs_log_printf(FILE *f, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vs_log_vprintf(f, fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+#endif /* VSUITE_LOGRING_H */
@@ -0,0 +1,465 @@
+#ifndef VSUITE_MAP_H
+#define VSUITE_MAP_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+#include <vsuite/varchar.h>
+#include <vsuite/arena.h>
+#include <vsuite/batch.h>
+#include <vsuite/hash.h>
+#include <vsuite/simd.h>
+
+/*
+ * Open-addressing hash map keyed by VARCHAR contents.
+ *
+ * Lookup tables keyed by account or organisation code are usually linked
+ * lists or sorted arrays of C strings.  A vs_map_t keeps one control byte
+ * per slot, holding 7 bits of the key's hash, in a separate array.  A lookup
+ * tests 16 control bytes with one vector compare and only visits the slots
+ * whose byte matches:
+ *
+ *     vs_map_t *accts = vs_map_create(n_rows);
+ *     vb_map_build(accts, acct_num, n_rows);      (value = row index)
+ *     void **row = v_map_find(accts, gl_acct);
+ *     if (row) ... desc[vs_map_row(*row)] ...
+ *
+ * Keys of up to VS_MAP_INLINE bytes are stored in the slot, zero padded, and
+ * compared as two words, so a hit costs the control group and one slot.
+ * Longer keys are copied into an arena owned by the map.  Values are opaque
+ * pointers.
+ */
+
+/* Keys up to this length are stored in the slot itself. */
+#define VS_MAP_INLINE 16
+
+/* Control bytes tested per probe step. */
+#define VS_MAP_GROUP 16
+
+#define VS_MAP_EMPTY   0x80
+#define VS_MAP_DELETED 0xFE
+
+/*
+ * vs_map_slot_t - One entry.
+ * @key:   Key bytes zero padded when @len <= VS_MAP_INLINE.  Otherwise
+ *         ``key[0]`` points to the arena copy and ``key[1]`` holds its first
+ *         8 bytes, to reject most mismatches without following the pointer.
+ * @len:   Key length.
+ * @value: Caller's value.
+ */
+typedef struct {
+    uint64_t key[2];
+    size_t len;
+    void *value;
+} vs_map_slot_t;
+
+/*
+ * vs_map_t - Map state.
+ * @ctrl:        One byte per slot: VS_MAP_EMPTY, VS_MAP_DELETED or the low
+ *               7 bits of the key's hash.  The first VS_MAP_GROUP - 1 bytes
+ *               are repeated past the end so a group load never wraps.
+ * @slots:       Entries.
+ * @mask:        Number of slots minus one; the table is a power of two.
+ * @count:       Keys stored.
+ * @growth_left: Empty slots that may still be filled before the table is
+ *               rebuilt, keeping the load at most 7/8.
+ * @keys:        Storage for long keys; created on first use.
+ */
+typedef struct {
+    uint8_t *ctrl;
+    vs_map_slot_t *slots;
+    size_t mask;
+    size_t count;
+    size_t growth_left;
+    vs_arena_t *keys;
+} vs_map_t;
+
+/* vs_map_row() - Row index stored as a value by vb_map_build(). */
+#define vs_map_row(value) ((size_t)(uintptr_t)(value))
+
+/* vs_map_match() - Bit k set when control byte k of the group at @g is @c. */
+static inline uint32_t vs_map_match(const uint8_t *g, uint8_t c)
+{
+#ifdef VS_HAVE_SSE2
+    __m128i x = _mm_loadu_si128((const __m128i *)g);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8((char)c)));
+#else
+    uint32_t m = 0;
+    for (int k = 0; k < VS_MAP_GROUP; k++)
+        m |= (uint32_t)(g[k] == c) << k;
+    return m;
+#endif
+}
+
+/* vs_map_match_free() - Bit k set when slot k of the group is empty or deleted. */
+static inline uint32_t vs_map_match_free(const uint8_t *g)
+{
+#ifdef VS_HAVE_SSE2
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)g));
+#else
+    uint32_t m = 0;
+    for (int k = 0; k < VS_MAP_GROUP; k++)
+        m |= (uint32_t)(g[k] >> 7) << k;
+    return m;
+#endif
+}
+
+/*
+ * vs_map_inline_key() - The key @s[0..n) zero padded to two words, as
+ * stored in a slot.  Only meaningful for n <= VS_MAP_INLINE.
+ */
+static inline void vs_map_inline_key(const char *s, size_t n, uint64_t w[2])
+{
+#ifdef VS_SWAR_LE
+    if (n >= 8) {
+        w[0] = vs_load64(s);
+        w[1] = n > 8 ? vs_load64(s + n - 8) >> (8 * (16 - n)) : 0;
+    } else if (n >= 4) {
+        w[0] = vs_load32(s);
+        if (n > 4)
+            w[0] |= (uint64_t)(vs_load32(s + n - 4) >> (8 * (8 - n))) << 32;
+        w[1] = 0;
+    } else {
+        w[0] = 0;
+        for (size_t i = 0; i < n; i++)
+            w[0] |= (uint64_t)(unsigned char)s[i] << (8 * i);
+        w[1] = 0;
+    }
+#else
+    w[0] = w[1] = 0;
+    memcpy(w, s, n);
+#endif
+}
+
+/* vs_map_key() - Bytes of the key stored in @slot. */
+static inline const char *vs_map_key(const vs_map_slot_t *slot)
+{
+    return slot->len <= VS_MAP_INLINE ? (const char *)slot->key
+                                      : (const char *)(uintptr_t)slot->key[0];
+}
+
+/* vs_map_set_ctrl() - Set control byte @i and its copy past the end. */
+static inline void vs_map_set_ctrl(vs_map_t *m, size_t i, uint8_t c)
+{
+    m->ctrl[i] = c;
+    if (i < VS_MAP_GROUP - 1)
+        m->ctrl[m->mask + 1 + i] = c;
+}
+
+/* vs_map_alloc() - Give @m an empty table of @nslots, a power of two >= VS_MAP_GROUP. */
+static inline int vs_map_alloc(vs_map_t *m, size_t nslots)
+{
+    uint8_t *ctrl = malloc(nslots + VS_MAP_GROUP - 1);
+    vs_map_slot_t *slots = malloc(nslots * sizeof *slots);
+    if (!ctrl || !slots) {
+        free(ctrl);
+        free(slots);
+        return -1;
+    }
+    memset(ctrl, VS_MAP_EMPTY, nslots + VS_MAP_GROUP - 1);
+    m->ctrl = ctrl;
+    m->slots = slots;
+    m->mask = nslots - 1;
+    m->count = 0;
+    m->growth_left = nslots - nslots / 8;
+    return 0;
+}
+
+/* vs_map_slots_for() - Table size holding @n keys under the 7/8 load limit. */
+static inline size_t vs_map_slots_for(size_t n)
+{
+    size_t nslots = VS_MAP_GROUP;
+    while (nslots - nslots / 8 < n)
+        nslots *= 2;
+    return nslots;
+}
+
+/*
+ * vs_map_create() - Allocate a map sized for @expected keys.
+ *
+ * The map grows past @expected as needed.  Returns ``NULL`` on allocation
+ * failure.
+ */
+static inline vs_map_t *vs_map_create(size_t expected)
+{
+    vs_map_t *m = calloc(1, sizeof *m);
+    if (!m)
+        return NULL;
+    if (vs_map_alloc(m, vs_map_slots_for(expected)) != 0) {
+        free(m);
+        return NULL;
+    }
+    return m;
+}
+
+/* vs_map_destroy() - Release @m and its long keys; the values are not touched. */
+static inline void vs_map_destroy(vs_map_t *m)
+{
+    if (!m)
+        return;
+    free(m->ctrl);
+    free(m->slots);
+    vs_arena_destroy(m->keys);
+    free(m);
+}
+
+/* vs_map_count() - Number of keys in @m. */
+static inline size_t vs_map_count(const vs_map_t *m) { return m->count; }
+
+/*
+ * vs_map_lookup() - Slot holding @s[0..n) with hash @hash, or ``NULL``.
+ *
+ * Groups are probed with growing steps of VS_MAP_GROUP slots, which visits
+ * every group of a power-of-two table.  The probe ends at the first group
+ * with an empty slot.
+ */
+static inline vs_map_slot_t *vs_map_lookup(const vs_map_t *m, const char *s,
+                                           size_t n, uint64_t hash)
+{
+    uint64_t w[2] = { 0, 0 };
+    uint64_t head = n > VS_MAP_INLINE ? vs_load64(s) : 0;
+    size_t pos = (size_t)(hash >> 7) & m->mask, step = 0;
+    uint8_t h2 = (uint8_t)(hash & 0x7F);
+    if (n <= VS_MAP_INLINE)
+        vs_map_inline_key(s, n, w);
+    for (;;) {
+        const uint8_t *g = m->ctrl + pos;
+        uint32_t hit = vs_map_match(g, h2);
+        while (hit) {
+            vs_map_slot_t *slot = &m->slots[(pos + __builtin_ctz(hit)) & m->mask];
+            if (slot->len == n) {
+                if (n <= VS_MAP_INLINE) {
+                    if (((slot->key[0] ^ w[0]) | (slot->key[1] ^ w[1])) == 0)
+                        return slot;
+                } else if (slot->key[1] == head &&
+                           memcmp((const char *)(uintptr_t)slot->key[0], s, n) == 0) {
+                    return slot;
+                }
+            }
+            hit &= hit - 1;
+        }
+        if (vs_map_match(g, VS_MAP_EMPTY))
+            return NULL;
+        step += VS_MAP_GROUP;
+        pos = (pos + step) & m->mask;
+    }
+}
+
+/* vs_map_free_slot() - First empty or deleted slot on the probe path of @hash. */
+static inline size_t vs_map_free_slot(const vs_map_t *m, uint64_t hash)
+{
+    size_t pos = (size_t)(hash >> 7) & m->mask, step = 0;
+    for (;;) {
+        uint32_t free_ = vs_map_match_free(m->ctrl + pos);
+        if (free_)
+            return (pos + __builtin_ctz(free_)) & m->mask;
+        step += VS_MAP_GROUP;
+        pos = (pos + step) & m->mask;
+    }
+}
+
+/*
+ * vs_map_rehash() - Move every key into a fresh table of @nslots.  Keys
+ * are rehashed from their bytes; deleted slots are dropped.
+ */
+static inline int vs_map_rehash(vs_map_t *m, size_t nslots)
+{
+    vs_map_t old = *m;
+    if (vs_map_alloc(m, nslots) != 0) {
+        *m = old;
+        return -1;
+    }
+    for (size_t i = 0; i <= old.mask; i++) {
+        if (old.ctrl[i] & 0x80)
+            continue;
+        const vs_map_slot_t *slot = &old.slots[i];
+        uint64_t hash = vs_hash(vs_map_key(slot), slot->len, VS_HASH_SEED);
+        size_t j = vs_map_free_slot(m, hash);
+        vs_map_set_ctrl(m, j, (uint8_t)(hash & 0x7F));
+        m->slots[j] = *slot;
+    }
+    m->count = old.count;
+    m->growth_left -= old.count;
+    free(old.ctrl);
+    free(old.slots);
+    return 0;
+}
+
+/*
+ * vs_map_insert_hashed() - vs_map_insert() with the hash already computed.
+ */
+static inline void **vs_map_insert_hashed(vs_map_t *m, const char *s, size_t n,
+                                          uint64_t hash)
+{
+    vs_map_slot_t *slot = vs_map_lookup(m, s, n, hash);
+    if (slot)
+        return &slot->value;
+    if (m->growth_left == 0) {
+        /* mostly deleted slots: rebuild at the same size, else double */
+        size_t nslots = m->mask + 1;
+        if (m->count >= (nslots - nslots / 8) / 2)
+            nslots *= 2;
+        if (vs_map_rehash(m, nslots) != 0)
+            return NULL;
+    }
+    size_t i = vs_map_free_slot(m, hash);
+    slot = &m->slots[i];
+    if (n <= VS_MAP_INLINE) {
+        vs_map_inline_key(s, n, slot->key);
+    } else {
+        if (!m->keys && !(m->keys = vs_arena_create(4096)))
+            return NULL;
+        char *copy = vs_arena_strndup(m->keys, s, n);
+        if (!copy)
+            return NULL;
+        slot->key[0] = (uintptr_t)copy;
+        slot->key[1] = vs_load64(s);
+    }
+    if (m->ctrl[i] == VS_MAP_EMPTY)
+        m->growth_left--;
+    vs_map_set_ctrl(m, i, (uint8_t)(hash & 0x7F));
+    slot->len = n;
+    slot->value = NULL;
+    m->count++;
+    return &slot->value;
+}
+
+/*
+ * vs_map_insert() - Value cell for the key @s[0..n), adding the key with a
+ * ``NULL`` value if it is new.
+ *
+ * Returns ``NULL`` on allocation failure.  The cell stays valid until the
+ * next insert, which may move the table.
+ */
+static inline void **vs_map_insert(vs_map_t *m, const char *s, size_t n)
+{
+    return vs_map_insert_hashed(m, s, n, vs_hash(s, n, VS_HASH_SEED));
+}
+
+/* vs_map_put() - Set the value of @s[0..n) to @value; 0 or -1 on allocation failure. */
+static inline int vs_map_put(vs_map_t *m, const char *s, size_t n, void *value)
+{
+    void **cell = vs_map_insert(m, s, n);
+    if (!cell)
+        return -1;
+    *cell = value;
+    return 0;
+}
+
+/* vs_map_find() - Value cell of @s[0..n), or ``NULL`` when the key is absent. */
+static inline void **vs_map_find(const vs_map_t *m, const char *s, size_t n)
+{
+    vs_map_slot_t *slot = vs_map_lookup(m, s, n, vs_hash(s, n, VS_HASH_SEED));
+    return slot ? &slot->value : NULL;
+}
+
+/* vs_map_get() - Value of @s[0..n), or ``NULL`` when the key is absent. */
+static inline void *vs_map_get(const vs_map_t *m, const char *s, size_t n)
+{
+    void **cell = vs_map_find(m, s, n);
+    return cell ? *cell : NULL;
+}
+
+/*
+ * vs_map_erase() - Remove @s[0..n); returns 1 if it was present.
+ *
+ * The slot is marked deleted and reused by later inserts.  A long key's
+ * copy stays in the arena until the map is destroyed.
+ */
+static inline int vs_map_erase(vs_map_t *m, const char *s, size_t n)
+{
+    vs_map_slot_t *slot = vs_map_lookup(m, s, n, vs_hash(s, n, VS_HASH_SEED));
+    if (!slot)
+        return 0;
+    vs_map_set_ctrl(m, (size_t)(slot - m->slots), VS_MAP_DELETED);
+    m->count--;
+    return 1;
+}
+
+/*
+ * vs_map_next() - Next entry at or after slot *@it, or ``NULL`` at the end.
+ *
+ *     size_t it = 0;
+ *     for (vs_map_slot_t *e; (e = vs_map_next(m, &it)); )
+ *         use(vs_map_key(e), e->len, e->value);
+ *
+ * The order is unspecified.  Inserting during a walk invalidates it.
+ */
+static inline vs_map_slot_t *vs_map_next(const vs_map_t *m, size_t *it)
+{
+    for (size_t i = *it; i <= m->mask; i++) {
+        if (!(m->ctrl[i] & 0x80)) {
+            *it = i + 1;
+            return &m->slots[i];
+        }
+    }
+    *it = m->mask + 1;
+    return NULL;
+}
+
+/*
+ * vb_map_build_fcn() - Insert each row of a VARCHAR host array with its
+ * row index as the value; the first row wins when keys repeat.
+ *
+ * The table is sized once for @count keys.  Hashes are computed a group of
+ * rows ahead and their control bytes prefetched, so the cache misses of
+ * neighbouring rows overlap instead of following one another.
+ */
+static inline int vb_map_build_fcn(vs_map_t *m, const char *base,
+                                   size_t stride, size_t arr_off, size_t cap,
+                                   size_t count)
+{
+    enum { AHEAD = 8 };
+    uint64_t hash[AHEAD];
+    if (vs_map_slots_for(m->count + count) > m->mask + 1 &&
+        vs_map_rehash(m, vs_map_slots_for(m->count + count)) != 0)
+        return -1;
+    for (size_t i = 0; i < count; i += AHEAD) {
+        size_t k = count - i < AHEAD ? count - i : AHEAD;
+        for (size_t j = 0; j < k; j++) {
+            const char *row = base + (i + j) * stride;
+            size_t n = VB_LEN(row) < cap ? VB_LEN(row) : cap;
+            hash[j] = vs_hash(row + arr_off, n, VS_HASH_SEED);
+            size_t pos = (size_t)(hash[j] >> 7) & m->mask;
+            __builtin_prefetch(m->ctrl + pos);
+            __builtin_prefetch(&m->slots[pos]);
+        }
+        for (size_t j = 0; j < k; j++) {
+            const char *row = base + (i + j) * stride;
+            size_t n = VB_LEN(row) < cap ? VB_LEN(row) : cap;
+            size_t before = m->count;
+            void **cell = vs_map_insert_hashed(m, row + arr_off, n, hash[j]);
+            if (!cell)
+                return -1;
+            if (m->count != before)
+                *cell = (void *)(uintptr_t)(i + j);
+        }
+    }
+    return 0;
+}
+
+/* v_map_insert() - vs_map_insert() with the VARCHAR @v as key. */
+#define v_map_insert(m, v) vs_map_insert((m), V_BUF(v), V_LEN(v))
+
+/* v_map_put() - vs_map_put() with the VARCHAR @v as key. */
+#define v_map_put(m, v, value) vs_map_put((m), V_BUF(v), V_LEN(v), (value))
+
+/* v_map_find() - vs_map_find() with the VARCHAR @v as key. */
+#define v_map_find(m, v) vs_map_find((m), V_BUF(v), V_LEN(v))
+
+/* v_map_get() - vs_map_get() with the VARCHAR @v as key. */
+#define v_map_get(m, v) vs_map_get((m), V_BUF(v), V_LEN(v))
+
+/* v_map_erase() - vs_map_erase() with the VARCHAR @v as key. */
+#define v_map_erase(m, v) vs_map_erase((m), V_BUF(v), V_LEN(v))
+
+/*
+ * vb_map_build() - Add the first @count rows of the VARCHAR host array @a
+ * to @m, each mapped to its row index (read back with vs_map_row()).
+ * Returns 0, or -1 on allocation failure.
+ */
+#define vb_map_build(m, a, count) vb_map_build_fcn((m), VB_ARGS(a), (count))
+
+#endif /* VSUITE_MAP_H */
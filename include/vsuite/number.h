@@ -0,0 +1,475 @@
+#ifndef VSUITE_NUMBER_H
+#define VSUITE_NUMBER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <limits.h>
+#include <string.h>
+
+#include <vsuite/varchar.h>
+#include <vsuite/simd.h>
+
+/*
+ * Numeric conversion straight from and to VARCHAR data.
+ *
+ * The parsers take ``(arr, len)`` directly, so a field never has to be
+ * terminated or copied before conversion, and they do not depend on the
+ * locale.  They accept what Oracle's TO_NUMBER accepts for plain numbers:
+ * optional blanks around the value, an optional sign, and decimal digits with
+ * at most one ``'.'``.  Anything else is reported through a v_num_status_t
+ * when the field is read, not later as ORA-01722.
+ *
+ * Digit runs are converted eight at a time with SWAR arithmetic when eight
+ * bytes can be read from the buffer.
+ *
+ * The formatters write digits two at a time from a table of digit pairs and
+ * set ``len`` and the overflow status themselves, so building a numeric
+ * field never goes through v_sprintf() and ``vsnprintf``.
+ */
+
+/*
+ * v_num_status_t - Result of a numeric conversion.
+ * @V_NUM_OK:      The whole field is a valid number.
+ * @V_NUM_EMPTY:   The field is empty or blank.
+ * @V_NUM_INVALID: The field contains something other than a number.
+ * @V_NUM_RANGE:   The number does not fit the result type; the result is
+ *                 clamped like strtol().
+ */
+typedef enum {
+    V_NUM_OK = 0,
+    V_NUM_EMPTY,
+    V_NUM_INVALID,
+    V_NUM_RANGE
+} v_num_status_t;
+
+/*
+ * vs_digit_run8() - Number of leading ASCII digits in the word @w, 0 to 8.
+ *
+ * A byte is a digit when its high nibble is 3 both before and after adding
+ * 6.  A carry out of a non-digit byte can only disturb the bytes after it,
+ * which the count never looks at.
+ */
+static inline unsigned vs_digit_run8(uint64_t w)
+{
+    uint64_t nd = ((w & 0xF0F0F0F0F0F0F0F0ULL) ^ 0x3030303030303030ULL) |
+                  (((w + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) ^
+                   0x3030303030303030ULL);
+    nd |= nd >> 1;
+    nd |= nd >> 2;
+    nd &= 0x1010101010101010ULL;        /* bit 4 of each non-digit byte */
+    return nd ? (unsigned)__builtin_ctzll(nd) >> 3 : 8;
+}
+
+/*
+ * vs_parse8() - Value of the eight digit bytes of @w, first byte most
+ * significant, after subtracting ``'0'`` from each.
+ */
+static inline uint32_t vs_parse8(uint64_t w)
+{
+    w = (w * 10) + (w >> 8);
+    w &= 0x00FF00FF00FF00FFULL;
+    w = (w * 100) + (w >> 16);
+    w &= 0x0000FFFF0000FFFFULL;
+    w = (w * 10000) + (w >> 32);
+    return (uint32_t)w;
+}
+
+static const uint64_t vs_pow10_u64[20] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+    10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+    100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL,
+    10000000000000000000ULL,
+};
+
+/*
+ * vs_scan_digits() - Accumulate the digit run at @s[*i..n) into @acc.
+ * @cap:  Bytes readable from @s; at least @n.  Eight byte loads are used
+ *        while they stay below @cap, bytes at or past @n are ignored.
+ * @ovf:  Set when @acc overflows; scanning continues so the run is still
+ *        consumed.
+ *
+ * Returns the number of digits consumed.
+ */
+static inline size_t vs_scan_digits(const char *s, size_t n, size_t cap,
+                                    size_t *i, uint64_t *acc, int *ovf)
+{
+    size_t start = *i, p = *i;
+    uint64_t v = *acc;
+#ifdef VS_SWAR_LE
+    while (p + 8 <= cap && p < n) {
+        uint64_t w = vs_load64(s + p);
+        unsigned k = vs_digit_run8(w);
+        if (k > n - p)
+            k = (unsigned)(n - p);
+        if (k == 0)
+            break;
+        /* Borrows from non-digit bytes only reach the bytes after them,
+         * which the shift discards. */
+        uint64_t d = w - 0x3030303030303030ULL;
+        if (k < 8)
+            d <<= 8 * (8 - k);
+        uint64_t chunk = vs_parse8(d);
+        if (__builtin_mul_overflow(v, vs_pow10_u64[k], &v) ||
+            __builtin_add_overflow(v, chunk, &v))
+            *ovf = 1;
+        p += k;
+        if (k < 8)
+            break;
+    }
+#endif
+    for (; p < n && (unsigned char)(s[p] - '0') < 10; p++) {
+        if (__builtin_mul_overflow(v, 10, &v) ||
+            __builtin_add_overflow(v, (uint64_t)(s[p] - '0'), &v))
+            *ovf = 1;
+    }
+    *i = p;
+    *acc = v;
+    return p - start;
+}
+
+/*
+ * vs_parse_number() - Shared front end of the parsers.
+ * @scale: Number of fraction digits to keep, or -1 to reject a ``'.'``.
+ * @neg:   Set for a leading ``'-'``.
+ * @mag:   Magnitude, scaled by 10^@scale; fraction digits past @scale are
+ *         rounded half away from zero.
+ */
+static inline v_num_status_t vs_parse_number(const char *s, size_t n,
+                                             size_t cap, int scale, int *neg,
+                                             uint64_t *mag)
+{
+    size_t i = 0, digits = 0;
+    uint64_t v = 0;
+    int ovf = 0;
+
+    *neg = 0;
+    *mag = 0;
+    while (i < n && vs_is_space((unsigned char)s[i]))
+        i++;
+    while (n > i && vs_is_space((unsigned char)s[n - 1]))
+        n--;
+    if (i == n)
+        return V_NUM_EMPTY;
+    if (s[i] == '+' || s[i] == '-')
+        *neg = s[i++] == '-';
+
+    digits = vs_scan_digits(s, n, cap, &i, &v, &ovf);
+    if (scale >= 0) {
+        size_t frac = 0;
+        if (i < n && s[i] == '.') {
+            size_t keep, start = ++i;
+            keep = n - i < (size_t)scale ? n - i : (size_t)scale;
+            frac = vs_scan_digits(s, start + keep, cap, &i, &v, &ovf);
+            if (frac == keep && i < n && (unsigned char)(s[i] - '0') < 10) {
+                int up = s[i] >= '5';
+                while (i < n && (unsigned char)(s[i] - '0') < 10)
+                    i++;
+                if (up && __builtin_add_overflow(v, 1, &v))
+                    ovf = 1;
+            }
+            digits += i - start;
+        }
+        if (__builtin_mul_overflow(v, vs_pow10_u64[scale - frac], &v))
+            ovf = 1;
+    }
+    if (digits == 0 || i != n)
+        return V_NUM_INVALID;
+    *mag = v;
+    return ovf ? V_NUM_RANGE : V_NUM_OK;
+}
+
+/*
+ * vs_to_long() - Parse @s[0..n) as a signed integer into @out.
+ * @cap: Bytes readable from @s, at least @n.
+ *
+ * On V_NUM_RANGE @out is LONG_MIN or LONG_MAX; on other errors it is 0.
+ */
+static inline v_num_status_t vs_to_long(const char *s, size_t n, size_t cap,
+                                        long *out)
+{
+    int neg;
+    uint64_t mag;
+    v_num_status_t st = vs_parse_number(s, n, cap, -1, &neg, &mag);
+    if (st == V_NUM_OK && mag > (uint64_t)LONG_MAX + neg)
+        st = V_NUM_RANGE;
+    if (st == V_NUM_RANGE)
+        *out = neg ? LONG_MIN : LONG_MAX;
+    else if (st != V_NUM_OK)
+        *out = 0;
+    else
+        *out = neg ? (long)(0 - mag) : (long)mag;
+    return st;
+}
+
+/*
+ * vs_to_ulong() - Parse @s[0..n) as an unsigned integer into @out.
+ *
+ * A negative value other than zero is out of range.  On V_NUM_RANGE @out is
+ * 0 for a negative value and ULONG_MAX otherwise.
+ */
+static inline v_num_status_t vs_to_ulong(const char *s, size_t n, size_t cap,
+                                         unsigned long *out)
+{
+    int neg;
+    uint64_t mag;
+    v_num_status_t st = vs_parse_number(s, n, cap, -1, &neg, &mag);
+    if (neg && (st == V_NUM_RANGE || (st == V_NUM_OK && mag != 0))) {
+        *out = 0;
+        return V_NUM_RANGE;
+    }
+    if (st == V_NUM_OK && mag > ULONG_MAX)
+        st = V_NUM_RANGE;
+    *out = st == V_NUM_OK ? (unsigned long)mag
+         : st == V_NUM_RANGE ? ULONG_MAX : 0;
+    return st;
+}
+
+/*
+ * vs_to_decimal() - Parse @s[0..n) as a fixed-point number.
+ * @scale: Fraction digits in the result, 0 to 18.
+ * @out:   The value times 10^@scale, so "440.9" with scale 2 gives 44090.
+ *
+ * Extra fraction digits are rounded half away from zero.  Range errors and
+ * other failures set @out as vs_to_long() does.
+ */
+static inline v_num_status_t vs_to_decimal(const char *s, size_t n, size_t cap,
+                                           unsigned scale, long *out)
+{
+    int neg;
+    uint64_t mag;
+    v_num_status_t st;
+    if (scale > 18) {
+        *out = 0;
+        return V_NUM_RANGE;
+    }
+    st = vs_parse_number(s, n, cap, (int)scale, &neg, &mag);
+    if (st == V_NUM_OK && mag > (uint64_t)LONG_MAX + neg)
+        st = V_NUM_RANGE;
+    if (st == V_NUM_RANGE)
+        *out = neg ? LONG_MIN : LONG_MAX;
+    else if (st != V_NUM_OK)
+        *out = 0;
+    else
+        *out = neg ? (long)(0 - mag) : (long)mag;
+    return st;
+}
+
+/*
+ * v_to_long() - Parse the VARCHAR @v as a ``long``.
+ * @v:   Source VARCHAR.
+ * @out: Pointer to the result.
+ *
+ * Returns a v_num_status_t.  ``v.arr`` is read as a whole, so the digits are
+ * converted eight at a time even near the end of the value.
+ */
+#define v_to_long(v, out) \
+    VS_PROFILE_EXPR("v_to_long", vs_to_long(V_BUF(v), V_LEN(v), V_SIZE(v), (out)))
+
+/* v_to_ulong() - Parse the VARCHAR @v as an ``unsigned long``. */
+#define v_to_ulong(v, out) \
+    VS_PROFILE_EXPR("v_to_ulong", vs_to_ulong(V_BUF(v), V_LEN(v), V_SIZE(v), (out)))
+
+/*
+ * v_to_decimal() - Parse the VARCHAR @v as a fixed-point ``long`` with
+ * @scale fraction digits; see vs_to_decimal().
+ */
+#define v_to_decimal(v, scale, out) \
+    VS_PROFILE_EXPR("v_to_decimal",                                          \
+                    vs_to_decimal(V_BUF(v), V_LEN(v), V_SIZE(v), (scale), (out)))
+
+/* Two ASCII digits for each value 0 to 99. */
+static const char vs_digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/*
+ * vs_fmt_u64() - Write the decimal digits of @v so that they end at @end.
+ *
+ * Writes at most 20 bytes before @end and returns how many.  Values that fit
+ * in 32 bits are divided in 32-bit arithmetic, which is cheaper.
+ */
+static inline size_t vs_fmt_u64(char *end, uint64_t v)
+{
+    char *p = end;
+    while (v > UINT32_MAX) {
+        unsigned r = (unsigned)(v % 100);
+        v /= 100;
+        p -= 2;
+        memcpy(p, vs_digit_pairs + 2 * r, 2);
+    }
+    uint32_t w = (uint32_t)v;
+    while (w >= 100) {
+        unsigned r = w % 100;
+        w /= 100;
+        p -= 2;
+        memcpy(p, vs_digit_pairs + 2 * r, 2);
+    }
+    if (w >= 10) {
+        p -= 2;
+        memcpy(p, vs_digit_pairs + 2 * w, 2);
+    } else {
+        *--p = (char)('0' + w);
+    }
+    return (size_t)(end - p);
+}
+
+/*
+ * vs_fmt_put() - Append @n bytes of @src, or @n zeros when @src is ``NULL``,
+ * at offset *@pos of @dst.  Only the bytes below @cap are stored, but *@pos
+ * always advances by @n so that it ends up as the length required.
+ */
+static inline void vs_fmt_put(char *dst, size_t cap, size_t *pos,
+                              const char *src, size_t n)
+{
+    size_t p = *pos;
+    if (p < cap) {
+        size_t k = n < cap - p ? n : cap - p;
+        if (src)
+            memcpy(dst + p, src, k);
+        else
+            memset(dst + p, '0', k);
+    }
+    *pos = p + n;
+}
+
+/*
+ * vs_fmt_number() - Format a number into @dst[0..cap).
+ * @neg:   Emit a leading ``'-'``.
+ * @mag:   Magnitude, scaled by 10^@scale.
+ * @width: Minimum length including the sign; shorter results are padded with
+ *         zeros after the sign, like ``%0*d``.
+ * @scale: Digits after the decimal point; 0 formats an integer.
+ *
+ * Nothing is terminated.  A result longer than @cap keeps its leading @cap
+ * bytes, like ``snprintf``, and the missing bytes are reported as overflow.
+ */
+static inline v_status_t vs_fmt_number(char *dst, size_t cap, int neg,
+                                       uint64_t mag, size_t width,
+                                       size_t scale)
+{
+    char tmp[20];
+    size_t nd = vs_fmt_u64(tmp + sizeof tmp, mag);
+    const char *digits = tmp + sizeof tmp - nd;
+    size_t zeros = scale + 1 > nd ? scale + 1 - nd : 0;
+    if (scale == 0)
+        zeros = 0;
+    size_t body = (size_t)(neg != 0) + zeros + nd + (scale != 0);
+    if (width > body)
+        zeros += width - body;
+    size_t total = body > width ? body : width;
+
+    if (!scale && total <= cap) {
+        /* Common case: an integer that fits. */
+        char *p = dst;
+        if (neg)
+            *p++ = '-';
+        memset(p, '0', zeros);
+        memcpy(p + zeros, digits, nd);
+        return (v_status_t){ total, 0 };
+    }
+
+    /* Leading zeros, then the digits, with the point @scale from the end. */
+    size_t pos = 0, run = zeros + nd, ip = run - scale;
+    if (neg)
+        vs_fmt_put(dst, cap, &pos, "-", 1);
+    if (ip <= zeros) {
+        vs_fmt_put(dst, cap, &pos, NULL, ip);
+        if (scale)
+            vs_fmt_put(dst, cap, &pos, ".", 1);
+        vs_fmt_put(dst, cap, &pos, NULL, zeros - ip);
+        vs_fmt_put(dst, cap, &pos, digits, nd);
+    } else {
+        vs_fmt_put(dst, cap, &pos, NULL, zeros);
+        vs_fmt_put(dst, cap, &pos, digits, ip - zeros);
+        if (scale)
+            vs_fmt_put(dst, cap, &pos, ".", 1);
+        vs_fmt_put(dst, cap, &pos, digits + (ip - zeros), nd - (ip - zeros));
+    }
+    return pos > cap ? (v_status_t){ cap, pos - cap }
+                     : (v_status_t){ pos, 0 };
+}
+
+/*
+ * v_fmt_st() - Store the result of vs_fmt_number() in @v.
+ *
+ * Sets ``v.len`` to the bytes stored and returns the v_status_t.
+ */
+#define v_fmt_st(v, name, neg, mag, width, scale)                            \
+    ({                                                                       \
+        VS_PROFILE_BEGIN(name);                                              \
+        v_status_t __st = vs_fmt_number(V_BUF(v), V_SIZE(v), (neg), (mag),   \
+                                        (width), (scale));                   \
+        if (__st.overflow) {                                                 \
+            V_WARN("Line %d : %s(%s, ...) : overflow : bytes required %zu > %zu capacity", \
+                   __LINE__, name, #v, __st.bytes + __st.overflow, V_SIZE(v)); \
+        }                                                                    \
+        VS_TELEMETRY(name, V_SIZE(v), __st.bytes + __st.overflow,            \
+                     __st.overflow);                                         \
+        (v).len = (unsigned short)__st.bytes;                                \
+        VS_PROFILE_END();                                                    \
+        __st;                                                                \
+    })
+
+/* vs_fmt_abs() - Magnitude of the signed value @x without overflow. */
+#define vs_fmt_abs(x) \
+    ((x) < 0 ? 0 - (unsigned long long)(x) : (unsigned long long)(x))
+
+/*
+ * v_from_int() - Format the signed integer @n into the VARCHAR @v.
+ * @v: Destination VARCHAR.
+ * @n: Value; any integer type up to ``long long``.
+ *
+ * Sets ``v.len`` and returns it.  A value wider than @v keeps its leading
+ * digits and records the missing bytes in ``varchar_overflow``.
+ */
+#define v_from_int(v, n) v_status_publish(v_from_int_st(v, n))
+
+/* v_from_int_st() - v_from_int() reporting a v_status_t instead of varchar_overflow. */
+#define v_from_int_st(v, n)                                                  \
+    ({                                                                       \
+        long long __x = (n);                                                 \
+        v_fmt_st(v, "v_from_int", __x < 0, vs_fmt_abs(__x), 0, 0);           \
+    })
+
+/* v_from_uint() - Format the unsigned integer @n into @v; see v_from_int(). */
+#define v_from_uint(v, n) v_status_publish(v_from_uint_st(v, n))
+
+/* v_from_uint_st() - v_from_uint() reporting a v_status_t instead of varchar_overflow. */
+#define v_from_uint_st(v, n) \
+    v_fmt_st(v, "v_from_uint", 0, (unsigned long long)(n), 0, 0)
+
+/*
+ * v_from_int_pad() - Format @n zero padded to at least @width bytes.
+ *
+ * The sign counts toward @width, as with ``%0*lld``: -42 in width 6 gives
+ * "-00042".  Otherwise behaves like v_from_int().
+ */
+#define v_from_int_pad(v, n, width) v_status_publish(v_from_int_pad_st(v, n, width))
+
+/* v_from_int_pad_st() - v_from_int_pad() reporting a v_status_t instead of varchar_overflow. */
+#define v_from_int_pad_st(v, n, width)                                       \
+    ({                                                                       \
+        long long __x = (n);                                                 \
+        v_fmt_st(v, "v_from_int_pad", __x < 0, vs_fmt_abs(__x), (width), 0); \
+    })
+
+/*
+ * v_from_decimal() - Format the fixed-point value @n with @scale fraction
+ * digits, the inverse of v_to_decimal().
+ *
+ * 44090 with scale 2 gives "440.90" and -5 gives "-0.05".  Scale 0 formats
+ * an integer.  Otherwise behaves like v_from_int().
+ */
+#define v_from_decimal(v, n, scale) v_status_publish(v_from_decimal_st(v, n, scale))
+
+/* v_from_decimal_st() - v_from_decimal() reporting a v_status_t instead of varchar_overflow. */
+#define v_from_decimal_st(v, n, scale)                                       \
+    ({                                                                       \
+        long long __x = (n);                                                 \
+        v_fmt_st(v, "v_from_decimal", __x < 0, vs_fmt_abs(__x), 0, (scale)); \
+    })
+
+#endif /* VSUITE_NUMBER_H */
@@ -0,0 +1,355 @@
+#ifndef VSUITE_PROFILE_H
+#define VSUITE_PROFILE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <vsuite/telemetry.h>
+
+/*
+ * Per-call-site latency profiling.
+ *
+ * Compiled in with VSUITE_PROFILE.  The copy, cat, trim, zsetlen, sprintf
+ * and number conversion macros then read a timestamp before and after
+ * their work and add the difference to a static record of the call site:
+ * calls, total ticks and a log2 histogram.  Like the telemetry records
+ * (see telemetry.h) they live in a linker section, ``vs_profile``, that the
+ * linker turns into one array.
+ *
+ * Timestamps come from ``rdtsc`` on x86, ``cntvct_el0`` on AArch64 and
+ * ``clock_gettime(CLOCK_MONOTONIC)`` elsewhere or when
+ * VSUITE_PROFILE_CLOCK_GETTIME is defined.  Neither counter instruction
+ * serialises, so a single sample is only good to a few tens of cycles; the
+ * cost of reading the counter twice is measured at startup and subtracted.
+ *
+ * At exit the sites that were reached are written, slowest total first,
+ * to the file named by the VSUITE_PROFILE environment variable (``-`` for
+ * stderr; JSON when the name ends in ``.json``, CSV otherwise).
+ * vs_profile_dump_csv() and vs_profile_dump_json() write them on demand.
+ *
+ * Updates are plain loads and stores, not atomic increments: a sample is
+ * occasionally lost when two threads hit the same site at once, which is
+ * cheaper than the bus lock and does not matter for a profile.
+ *
+ * Without VSUITE_PROFILE the hooks expand to nothing.
+ */
+
+/* Histogram buckets; bucket k counts samples below 2^k ticks. */
+#define VS_PROFILE_BUCKETS 32
+
+/*
+ * vs_profile_site_t - Timings of one call site.
+ * @macro: Name of the macro, e.g. ``"v_copy"``.
+ * @file:  __FILE__ of the site.
+ * @line:  __LINE__ of the site.
+ * @calls: Samples so far.
+ * @ticks: Sum of the samples.
+ * @hist:  Samples by bucket: 0 ticks in bucket 0, [2^(k-1), 2^k) in
+ *         bucket k, anything longer in the last one.
+ */
+typedef struct {
+    const char *macro;
+    const char *file;
+    int line;
+    uint64_t calls;
+    uint64_t ticks;
+    uint64_t hist[VS_PROFILE_BUCKETS];
+} __attribute__((aligned(64))) vs_profile_site_t;
+
+extern vs_profile_site_t __start_vs_profile[] __attribute__((weak));
+extern vs_profile_site_t __stop_vs_profile[] __attribute__((weak));
+
+/* Startup timestamp and timer cost, set once per process. */
+uint64_t vs_profile_t0_tick __attribute__((weak));
+uint64_t vs_profile_t0_ns __attribute__((weak));
+uint64_t vs_profile_bias __attribute__((weak));
+int vs_profile_hooked __attribute__((weak));
+
+/* vs_profile_ns() - CLOCK_MONOTONIC in nanoseconds. */
+static inline uint64_t vs_profile_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* vs_profile_now() - Current timestamp in ticks. */
+static inline __attribute__((always_inline)) uint64_t vs_profile_now(void)
+{
+#if defined(VSUITE_PROFILE_CLOCK_GETTIME)
+    return vs_profile_ns();
+#elif defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    uint64_t t;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(t));
+    return t;
+#else
+    return vs_profile_ns();
+#endif
+}
+
+/*
+ * vs_profile_count() - Add a sample of @ticks, timer cost included, to @s.
+ */
+static inline __attribute__((always_inline))
+void vs_profile_count(vs_profile_site_t *s, uint64_t ticks)
+{
+    uint64_t bias = __atomic_load_n(&vs_profile_bias, __ATOMIC_RELAXED);
+    ticks = ticks > bias ? ticks - bias : 0;
+    unsigned b = ticks ? 64 - (unsigned)__builtin_clzll(ticks) : 0;
+    if (b >= VS_PROFILE_BUCKETS)
+        b = VS_PROFILE_BUCKETS - 1;
+#define VS_PROFILE_ADD(field, v) \
+    __atomic_store_n(&(field), __atomic_load_n(&(field), __ATOMIC_RELAXED) + (v), __ATOMIC_RELAXED)
+    VS_PROFILE_ADD(s->calls, 1);
+    VS_PROFILE_ADD(s->ticks, ticks);
+    VS_PROFILE_ADD(s->hist[b], 1);
+#undef VS_PROFILE_ADD
+}
+
+/*
+ * vs_profile_sites() - First record of the registry; sets @n to the number
+ * of records, including sites never reached.
+ */
+static inline vs_profile_site_t *vs_profile_sites(size_t *n)
+{
+    *n = __start_vs_profile ? (size_t)(__stop_vs_profile - __start_vs_profile) : 0;
+    return __start_vs_profile;
+}
+
+/* vs_profile_find() - Record of @macro at @file:@line, or ``NULL``. */
+static inline vs_profile_site_t *vs_profile_find(const char *macro,
+                                                 const char *file, int line)
+{
+    size_t n;
+    vs_profile_site_t *s = vs_profile_sites(&n);
+    for (size_t i = 0; i < n; i++)
+        if (s[i].line == line && !strcmp(s[i].macro, macro) &&
+            !strcmp(s[i].file, file))
+            return &s[i];
+    return NULL;
+}
+
+/* vs_profile_calibrate() - Record the startup timestamp and timer cost. */
+static inline void vs_profile_calibrate(void)
+{
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < 1000; i++) {
+        uint64_t t = vs_profile_now();
+        uint64_t d = vs_profile_now() - t;
+        if (d < best)
+            best = d;
+    }
+    vs_profile_bias = best;
+    vs_profile_t0_ns = vs_profile_ns();
+    vs_profile_t0_tick = vs_profile_now();
+}
+
+/*
+ * vs_profile_ns_per_tick() - Length of a tick, measured against
+ * CLOCK_MONOTONIC since startup.  Waits until 10 ms have passed so the
+ * ratio is meaningful.
+ */
+static inline double vs_profile_ns_per_tick(void)
+{
+#if defined(VSUITE_PROFILE_CLOCK_GETTIME) || \
+    !(defined(__x86_64__) || defined(__i386__) || defined(__aarch64__))
+    return 1.0;
+#else
+    if (!vs_profile_t0_ns)
+        vs_profile_calibrate();
+    uint64_t ns, tick;
+    do {
+        ns = vs_profile_ns();
+        tick = vs_profile_now();
+    } while (ns - vs_profile_t0_ns < 10000000u);
+    return (double)(ns - vs_profile_t0_ns) / (double)(tick - vs_profile_t0_tick);
+#endif
+}
+
+/* vs_profile_quantile() - Upper bound, in ticks, of the @q quantile of @s. */
+static inline uint64_t vs_profile_quantile(const vs_profile_site_t *s, double q)
+{
+    uint64_t want = (uint64_t)(q * (double)s->calls + 0.999999), seen = 0;
+    for (unsigned b = 0; b < VS_PROFILE_BUCKETS; b++) {
+        seen += s->hist[b];
+        if (seen >= want)
+            return b ? 1ULL << b : 0;
+    }
+    return 1ULL << (VS_PROFILE_BUCKETS - 1);
+}
+
+static inline int vs_profile_by_ticks(const void *a, const void *b)
+{
+    uint64_t x = (*(const vs_profile_site_t *const *)a)->ticks;
+    uint64_t y = (*(const vs_profile_site_t *const *)b)->ticks;
+    return x < y ? 1 : x > y ? -1 : 0;
+}
+
+/*
+ * vs_profile_sorted() - Reached sites, slowest total first, in a malloc'd
+ * array; sets @n and @total to their number and summed ticks.
+ */
+static inline vs_profile_site_t **vs_profile_sorted(size_t *n, uint64_t *total)
+{
+    size_t all;
+    vs_profile_site_t *s = vs_profile_sites(&all);
+    vs_profile_site_t **v = malloc((all ? all : 1) * sizeof *v);
+    *n = 0;
+    *total = 0;
+    if (!v)
+        return NULL;
+    for (size_t i = 0; i < all; i++)
+        if (s[i].calls) {
+            v[(*n)++] = &s[i];
+            *total += s[i].ticks;
+        }
+    qsort(v, *n, sizeof *v, vs_profile_by_ticks);
+    return v;
+}
+
+/*
+ * vs_profile_dump_csv() - Write the reached sites to @f as CSV, slowest
+ * total first.  ``share`` is the fraction of all profiled time; ``hist``
+ * lists ``<upper bound in ns>:<samples>`` for the non-empty buckets.
+ * Returns the number of sites written.
+ */
+static inline size_t vs_profile_dump_csv(FILE *f)
+{
+    size_t n;
+    uint64_t total;
+    vs_profile_site_t **v = vs_profile_sorted(&n, &total);
+    double tick = vs_profile_ns_per_tick();
+    fprintf(f, "macro,file,line,calls,total_ns,share,mean_ns,p50_ns,p99_ns,hist\n");
+    for (size_t i = 0; v && i < n; i++) {
+        const vs_profile_site_t *s = v[i];
+        fprintf(f, "%s,\"%s\",%d,%llu,%.0f,%.4f,%.1f,%.0f,%.0f,",
+                s->macro, s->file, s->line, (unsigned long long)s->calls,
+                s->ticks * tick, total ? (double)s->ticks / total : 0.0,
+                s->ticks * tick / s->calls,
+                vs_profile_quantile(s, 0.50) * tick,
+                vs_profile_quantile(s, 0.99) * tick);
+        for (unsigned b = 0, sep = 0; b < VS_PROFILE_BUCKETS; b++)
+            if (s->hist[b])
+                fprintf(f, "%s%.0f:%llu", sep++ ? " " : "",
+                        (b ? (double)(1ULL << b) : 0.0) * tick,
+                        (unsigned long long)s->hist[b]);
+        fputc('\n', f);
+    }
+    free(v);
+    return v ? n : 0;
+}
+
+/*
+ * vs_profile_dump_json() - Write the reached sites to @f as JSON: the tick
+ * length and an array of sites with the CSV fields, ``hist`` being pairs of
+ * ``[upper bound in ns, samples]``.  Returns the number of sites.
+ */
+static inline size_t vs_profile_dump_json(FILE *f)
+{
+    size_t n;
+    uint64_t total;
+    vs_profile_site_t **v = vs_profile_sorted(&n, &total);
+    double tick = vs_profile_ns_per_tick();
+    fprintf(f, "{\"ns_per_tick\": %.6f, \"sites\": [", tick);
+    for (size_t i = 0; v && i < n; i++) {
+        const vs_profile_site_t *s = v[i];
+        fprintf(f, "%s\n  {\"macro\": ", i ? "," : "");
+        vs_telemetry_json_str(f, s->macro);
+        fprintf(f, ", \"file\": ");
+        vs_telemetry_json_str(f, s->file);
+        fprintf(f, ", \"line\": %d, \"calls\": %llu, \"total_ns\": %.0f, "
+                   "\"share\": %.4f, \"mean_ns\": %.1f, \"p50_ns\": %.0f, "
+                   "\"p99_ns\": %.0f, \"hist\": [",
+                s->line, (unsigned long long)s->calls, s->ticks * tick,
+                total ? (double)s->ticks / total : 0.0,
+                s->ticks * tick / s->calls,
+                vs_profile_quantile(s, 0.50) * tick,
+                vs_profile_quantile(s, 0.99) * tick);
+        for (unsigned b = 0, sep = 0; b < VS_PROFILE_BUCKETS; b++)
+            if (s->hist[b])
+                fprintf(f, "%s[%.0f, %llu]", sep++ ? ", " : "",
+                        (b ? (double)(1ULL << b) : 0.0) * tick,
+                        (unsigned long long)s->hist[b]);
+        fprintf(f, "]}");
+    }
+    fprintf(f, "%s]}\n", n ? "\n" : "");
+    free(v);
+    return v ? n : 0;
+}
+
+/*
+ * vs_profile_dump() - Write the profile to @path, ``-`` meaning stderr;
+ * JSON when @path ends in ``.json``.  Returns the number of sites or -1
+ * when the file cannot be opened.
+ */
+static inline long vs_profile_dump(const char *path)
+{
+    size_t len = strlen(path);
+    int json = len >= 5 && !strcmp(path + len - 5, ".json");
+    FILE *f = strcmp(path, "-") ? fopen(path, "w") : stderr;
+    if (!f)
+        return -1;
+    size_t n = json ? vs_profile_dump_json(f) : vs_profile_dump_csv(f);
+    if (f == stderr)
+        fflush(f);
+    else if (fclose(f) != 0)
+        return -1;
+    return (long)n;
+}
+
+/* vs_profile_at_exit() - Dump to $VSUITE_PROFILE, run by ``atexit``. */
+static inline void vs_profile_at_exit(void)
+{
+    const char *path = getenv("VSUITE_PROFILE");
+    if (path && *path && vs_profile_dump(path) < 0)
+        perror(path);
+}
+
+#ifdef VSUITE_PROFILE
+
+/* Calibrates and registers the exit dump once per process. */
+static __attribute__((constructor, used)) void vs_profile_init(void)
+{
+    if (!__atomic_exchange_n(&vs_profile_hooked, 1, __ATOMIC_ACQ_REL)) {
+        vs_profile_calibrate();
+        atexit(vs_profile_at_exit);
+    }
+}
+
+/*
+ * VS_PROFILE_BEGIN() - Start timing the enclosing block as a call of
+ * @macro.  A declaration; VS_PROFILE_END() in the same block stops it.
+ */
+#define VS_PROFILE_BEGIN(macro)                                              \
+    static vs_profile_site_t __vs_pf                                         \
+        __attribute__((section("vs_profile"), used)) =                       \
+        { (macro), __FILE__, __LINE__, 0, 0, { 0 } };                        \
+    uint64_t __vs_pf_t0 = vs_profile_now()
+
+/* VS_PROFILE_END() - Record the time since VS_PROFILE_BEGIN(). */
+#define VS_PROFILE_END() \
+    vs_profile_count(&__vs_pf, vs_profile_now() - __vs_pf_t0)
+
+/* VS_PROFILE_EXPR() - Value of @expr, timed as a call of @macro. */
+#define VS_PROFILE_EXPR(macro, expr)                                         \
+    ({                                                                       \
+        VS_PROFILE_BEGIN(macro);                                             \
+        __typeof__(expr) __vs_pf_r = (expr);                                 \
+        VS_PROFILE_END();                                                    \
+        __vs_pf_r;                                                           \
+    })
+
+#else
+
+#define VS_PROFILE_BEGIN(macro) do { } while (0)
+#define VS_PROFILE_END() do { } while (0)
+#define VS_PROFILE_EXPR(macro, expr) (expr)
+
+#endif
+
+#endif /* VSUITE_PROFILE_H */
@@ -16,40 +16,58 @@
  * buffer.  Otherwise ``vdst.len`` is cleared to zero so callers can detect the
  * overflow.
  */
-#define vp_copy(vdst, dsrc)                                          \
+#define vp_copy(vdst, dsrc) \
+    v_status_publish(vp_copy_st(vdst, dsrc))
+
+/* vp_copy_st() - vp_copy() reporting a v_status_t instead of varchar_overflow. */
+#define vp_copy_st(vdst, dsrc)                                       \
     ({                                                               \
-        varchar_overflow = 0;                                        \
+        VS_PROFILE_BEGIN("vp_copy");                                 \
+        size_t __ovf = 0;                                            \
         size_t siz = V_SIZE(vdst);                                   \
         size_t __n = strlen(dsrc);                                   \
         if (__n > siz) {                                             \
-            varchar_overflow = __n - siz;                            \
+            __ovf = __n - siz;                                       \
             V_WARN("Line %d : vp_copy(%s, %s) : overflow : bytes required %zu > %zu capacity", \
                 __LINE__, #vdst, #dsrc, __n, siz);                   \
-            __n = siz;                                               \
+            __n = 0;                                                 \
         }                                                            \
-        memmove(V_BUF(vdst), dsrc, __n);                             \
-        __n;                                                         \
+        VS_TELEMETRY("vp_copy", V_SIZE(vdst), __ovf ? siz + __ovf : __n, __ovf); \
+        vs_copy(V_BUF(vdst), dsrc, __n, V_SIZE(vdst));               \
+        (vdst).len = __n;                                            \
+        VS_PROFILE_END();                                            \
+        (v_status_t){ __n, __ovf };                                  \
     })
 
 /*
  * zvp_copy() - Copy a C string pointer and always NUL terminate the result.
+ *
+ * Like vp_copy() an overflowing source clears the destination, which is
+ * left as a terminated empty string.
  */
-#define zvp_copy(vdst, dsrc)                                         \
+#define zvp_copy(vdst, dsrc) \
+    v_status_publish(zvp_copy_st(vdst, dsrc))
+
+/* zvp_copy_st() - zvp_copy() reporting a v_status_t instead of varchar_overflow. */
+#define zvp_copy_st(vdst, dsrc)                                      \
     ({                                                               \
-        varchar_overflow = 0;                                        \
+        VS_PROFILE_BEGIN("zvp_copy");                                \
+        size_t __ovf = 0;                                            \
         size_t __cap = ZV_CAPACITY(vdst);                            \
         size_t __n = strlen(dsrc);                                   \
         if (__n > __cap) {                                           \
-            varchar_overflow = __n - __cap;                          \
+            __ovf = __n - __cap;                                     \
             V_WARN("Line %d : zvp_copy(%s, %s) : overflow : bytes required %zu > %zu capacity", \
                   __LINE__, #vdst, #dsrc, __n, V_SIZE(vdst));        \
-            __n = __cap;                                             \
+            __n = 0;                                                 \
         }                                                            \
-        memmove(V_BUF(vdst), dsrc, __n);                             \
+        VS_TELEMETRY("zvp_copy", V_SIZE(vdst), (__ovf ? __cap + __ovf : __n) + 1, __ovf); \
+        vs_copy(V_BUF(vdst), dsrc, __n, V_SIZE(vdst));               \
         (vdst).len = __n;                                            \
         if (V_SIZE(vdst) > 0)                                        \
             V_BUF(vdst)[__n] = '\0';                                 \
-        __n;                                                         \
+        VS_PROFILE_END();                                            \
+        (v_status_t){ __n, __ovf };                                  \
     })
 
 /*
@@ -57,22 +75,33 @@
  *
  * ``dstr`` must have capacity ``dcap``. When the source fits the data is copied
  * and a terminator appended.  Otherwise the destination is cleared to an empty
- * string (if ``dcap`` is non-zero).
+ * string (if ``dcap`` is non-zero).  A zero ``dcap`` leaves ``dstr`` untouched.
  */
-#define pv_copy(dstr, dcap, vsrc)                                    \
+#define pv_copy(dstr, dcap, vsrc) \
+    ({ v_status_publish(pv_copy_st(dstr, dcap, vsrc)) + 1; })
+
+/* pv_copy_st() - pv_copy() reporting a v_status_t instead of varchar_overflow. */
+#define pv_copy_st(dstr, dcap, vsrc)                                 \
     ({                                                               \
-        varchar_overflow = 0;                                        \
+        VS_PROFILE_BEGIN("pv_copy");                                 \
+        size_t __ovf = 0;                                            \
         size_t __cap = (dcap);                                       \
         size_t __n = (vsrc).len;                                     \
-        if (__n >= __cap) {                                          \
-            varchar_overflow = __n - __cap + 1;                      \
+        size_t __room = __cap ? __cap - 1 : 0;                       \
+        if (__n > __room || __cap == 0) {                            \
+            __ovf = __n - __room + (__cap == 0);                     \
             V_WARN("Line %d : pv_copy(%s, %s) : overflow : bytes required %zu > %zu capacity", \
                   __LINE__, #dstr, #vsrc, __n, __cap);               \
-            __n = __cap - 1;                                         \
+            __n = 0;                                                 \
+        }                                                            \
+        VS_TELEMETRY("pv_copy", __builtin_constant_p(dcap) ? (dcap) : 0, \
+                     __ovf ? __cap + __ovf : __n + 1, __ovf);        \
+        if (__cap > 0) {                                             \
+            vs_copy(dstr, V_BUF(vsrc), __n, V_SIZE(vsrc));           \
+            dstr[__n] = '\0';                                        \
         }                                                            \
-        memmove(dstr, V_BUF(vsrc), __n);                             \
-        dstr[__n] = '\0';                                            \
-        __n + 1;                                                     \
+        VS_PROFILE_END();                                            \
+        (v_status_t){ __n, __ovf };                                  \
     })
 
 /* Convenience wrapper to duplicate a VARCHAR into a newly allocated C string */
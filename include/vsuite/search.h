@@ -0,0 +1,486 @@
+#ifndef VSUITE_SEARCH_H
+#define VSUITE_SEARCH_H
+
+#include <stdint.h>
+#include <string.h>
+#include <stddef.h>
+
+#include <vsuite/varchar.h>
+#include <vsuite/simd.h>
+
+/*
+ * Length-bounded search within VARCHAR data.
+ *
+ * Every function takes ``(arr, len)`` and reads nothing at or past ``len``,
+ * so a VARCHAR never has to be terminated before it is searched and an
+ * embedded NUL is just another byte.  The raw functions return an offset or
+ * VS_NOT_FOUND; the ``v_`` macros return a ``long`` index or -1.
+ */
+
+#define VS_NOT_FOUND ((size_t)-1)
+
+/* Haystacks of at least this many bytes are scanned by the C library. */
+#define VS_INDEX_LIBC_MIN 64
+
+/*
+ * vs_match_bytes64() - Mark the bytes of @w equal to @c with their high bit.
+ * As with vs_zero_bytes64(), only the lowest set bit is exact.
+ */
+static inline uint64_t vs_match_bytes64(uint64_t w, unsigned char c)
+{
+    return vs_zero_bytes64(w ^ (VS_ONES64 * c));
+}
+
+/*
+ * vs_index_small() - First @c in ``s[0..n)`` for buffers shorter than a
+ * vector, with the same overlapping-word pattern as vs_find_nul_small().
+ */
+static inline size_t vs_index_small(const char *s, size_t n, unsigned char c)
+{
+#ifdef VS_SWAR_LE
+    if (n >= 8) {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            uint64_t m = vs_match_bytes64(vs_load64(s + i), c);
+            if (m)
+                return i + (__builtin_ctzll(m) >> 3);
+        }
+        if (i < n) {
+            uint64_t m = vs_match_bytes64(vs_load64(s + n - 8), c);
+            if (m)
+                return n - 8 + (__builtin_ctzll(m) >> 3);
+        }
+        return VS_NOT_FOUND;
+    }
+#endif
+    for (size_t i = 0; i < n; i++)
+        if ((unsigned char)s[i] == c)
+            return i;
+    return VS_NOT_FOUND;
+}
+
+/*
+ * vs_rindex_small() - Last @c in ``s[0..n)``, scalar.  Words would have to
+ * be scanned for their highest match, where the zero-byte trick is not exact.
+ */
+static inline size_t vs_rindex_small(const char *s, size_t n, unsigned char c)
+{
+    while (n > 0)
+        if ((unsigned char)s[--n] == c)
+            return n;
+    return VS_NOT_FOUND;
+}
+
+#ifdef VS_HAVE_SSE2
+static inline size_t vs_index_sse2(const char *s, size_t n, unsigned char c)
+{
+    const __m128i k = _mm_set1_epi8((char)c);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(s + i));
+        unsigned m = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, k));
+        if (m)
+            return i + __builtin_ctz(m);
+    }
+    if (i < n) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(s + n - 16));
+        unsigned m = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, k));
+        if (m)
+            return n - 16 + __builtin_ctz(m);
+    }
+    return VS_NOT_FOUND;
+}
+
+static inline size_t vs_rindex_sse2(const char *s, size_t n, unsigned char c)
+{
+    const __m128i k = _mm_set1_epi8((char)c);
+    size_t i = n;
+    for (; i >= 16; i -= 16) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(s + i - 16));
+        unsigned m = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, k));
+        if (m)
+            return i - 16 + (31 - __builtin_clz(m));
+    }
+    if (i > 0) {
+        __m128i x = _mm_loadu_si128((const __m128i *)s);
+        unsigned m = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, k));
+        m &= (1u << i) - 1;
+        if (m)
+            return 31 - __builtin_clz(m);
+    }
+    return VS_NOT_FOUND;
+}
+#endif
+
+/*
+ * vs_index() - Offset of the first @c in ``s[0..n)``, or VS_NOT_FOUND.
+ *
+ * Short fields are scanned inline; from VS_INDEX_LIBC_MIN bytes ``memchr``
+ * is used, whose vector code already beats anything inline.
+ */
+static inline size_t vs_index(const char *s, size_t n, unsigned char c)
+{
+    if (n >= VS_INDEX_LIBC_MIN) {
+        const char *p = memchr(s, c, n);
+        return p ? (size_t)(p - s) : VS_NOT_FOUND;
+    }
+#ifdef VS_HAVE_SSE2
+    if (n >= 16)
+        return vs_index_sse2(s, n, c);
+#endif
+    return vs_index_small(s, n, c);
+}
+
+/* vs_rindex() - Offset of the last @c in ``s[0..n)``, or VS_NOT_FOUND. */
+static inline size_t vs_rindex(const char *s, size_t n, unsigned char c)
+{
+#ifdef VS_HAVE_SSE2
+    if (n >= 16)
+        return vs_rindex_sse2(s, n, c);
+#endif
+    return vs_rindex_small(s, n, c);
+}
+
+#define VS_BITOP(a, b, op) \
+    ((a)[(size_t)(b) / (8 * sizeof *(a))] op (size_t)1 << ((size_t)(b) % (8 * sizeof *(a))))
+
+/*
+ * vs_strstr_twoway() - Two-way string matching (Crochemore and Perrin):
+ * linear time and constant space for any needle.  @nn is at least 2.
+ */
+static inline size_t vs_strstr_twoway(const unsigned char *h, size_t hn,
+                                      const unsigned char *nd, size_t nn)
+{
+    const unsigned char *start = h, *z = h + hn;
+    size_t i, ip, jp, k, p, ms, p0, mem, mem0;
+    size_t byteset[32 / sizeof(size_t)] = { 0 };
+    size_t shift[256];
+
+    /* Bad-character table on the needle's last byte. */
+    for (i = 0; i < nn; i++) {
+        VS_BITOP(byteset, nd[i], |=);
+        shift[nd[i]] = i + 1;
+    }
+
+    /* Critical factorization: maximal suffix under both orders. */
+    ip = (size_t)-1; jp = 0; k = p = 1;
+    while (jp + k < nn) {
+        if (nd[ip + k] == nd[jp + k]) {
+            if (k == p) {
+                jp += p;
+                k = 1;
+            } else {
+                k++;
+            }
+        } else if (nd[ip + k] > nd[jp + k]) {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+        } else {
+            ip = jp++;
+            k = p = 1;
+        }
+    }
+    ms = ip;
+    p0 = p;
+
+    ip = (size_t)-1; jp = 0; k = p = 1;
+    while (jp + k < nn) {
+        if (nd[ip + k] == nd[jp + k]) {
+            if (k == p) {
+                jp += p;
+                k = 1;
+            } else {
+                k++;
+            }
+        } else if (nd[ip + k] < nd[jp + k]) {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+        } else {
+            ip = jp++;
+            k = p = 1;
+        }
+    }
+    if (ip + 1 > ms + 1)
+        ms = ip;
+    else
+        p = p0;
+
+    /* A periodic needle remembers how much of the period already matched. */
+    if (memcmp(nd, nd + p, ms + 1)) {
+        mem0 = 0;
+        p = (ms > nn - ms - 1 ? ms : nn - ms - 1) + 1;
+    } else {
+        mem0 = nn - p;
+    }
+    mem = 0;
+
+    for (;;) {
+        if ((size_t)(z - h) < nn)
+            return VS_NOT_FOUND;
+
+        if (VS_BITOP(byteset, h[nn - 1], &)) {
+            k = nn - shift[h[nn - 1]];
+            if (k) {
+                if (k < mem)
+                    k = mem;
+                h += k;
+                mem = 0;
+                continue;
+            }
+        } else {
+            h += nn;
+            mem = 0;
+            continue;
+        }
+
+        /* Right half, then left half. */
+        for (k = ms + 1 > mem ? ms + 1 : mem; k < nn && nd[k] == h[k]; k++)
+            ;
+        if (k < nn) {
+            h += k - ms;
+            mem = 0;
+            continue;
+        }
+        for (k = ms + 1; k > mem && nd[k - 1] == h[k - 1]; k--)
+            ;
+        if (k <= mem)
+            return (size_t)(h - start);
+        h += p;
+        mem = mem0;
+    }
+}
+
+/* Returned by the filtered searches when they hand over to two-way. */
+#define VS_STRSTR_GIVEUP ((size_t)-2)
+
+/*
+ * vs_strstr_verify() - First position of the candidate mask @m (bit k is
+ * ``h + at + k``) where the inner needle bytes match.
+ * @budget: Inner bytes that may still be compared; decremented.
+ *
+ * Returns the position, VS_NOT_FOUND, or VS_STRSTR_GIVEUP once @budget runs
+ * out.  The ends were already matched by the filter.  The bytes are compared
+ * inline: a ``memcmp`` call inside the scan loop would spill its vector
+ * registers.
+ */
+static inline size_t vs_strstr_verify(const char *h, const char *nd,
+                                      size_t nn, size_t at, uint64_t m,
+                                      size_t *budget)
+{
+    while (m) {
+        size_t pos = at + __builtin_ctzll(m), k = 1;
+        while (k < nn - 1 && h[pos + k] == nd[k])
+            k++;
+        if (k >= nn - 1)
+            return pos;
+        if (*budget < k)
+            return VS_STRSTR_GIVEUP;
+        *budget -= k;
+        m &= m - 1;
+    }
+    return VS_NOT_FOUND;
+}
+
+#ifdef VS_HAVE_SSE2
+/* vs_strstr_mask16() - Filter mask for the 16 candidates at @at. */
+static inline uint64_t vs_strstr_mask16(const char *h, size_t at, size_t nn,
+                                        __m128i first, __m128i last)
+{
+    __m128i a = _mm_loadu_si128((const __m128i *)(h + at));
+    __m128i b = _mm_loadu_si128((const __m128i *)(h + at + nn - 1));
+    return (unsigned)_mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)));
+}
+
+/*
+ * vs_strstr_sse2() - Search with a first-and-last-byte filter.
+ * @resume: Set on VS_STRSTR_GIVEUP to the first position not yet ruled out.
+ *
+ * Candidate positions are tested sixteen at a time by comparing the
+ * needle's first byte against ``h[i..i+16)`` and its last byte against
+ * ``h[i+nn-1..i+nn+15)``; only positions where both match are verified.
+ * The final block is anchored at the last candidate, so no load passes
+ * ``h + hn``.  Requires ``2 <= nn`` and ``hn - nn + 1 >= 16``.
+ */
+static inline size_t vs_strstr_sse2(const char *h, size_t hn,
+                                    const char *nd, size_t nn,
+                                    size_t *budget, size_t *resume)
+{
+    const __m128i first = _mm_set1_epi8(nd[0]);
+    const __m128i last = _mm_set1_epi8(nd[nn - 1]);
+    size_t cands = hn - nn + 1, i = 0, at = 0, r = VS_NOT_FOUND;
+    uint64_t m;
+    for (; i + 32 <= cands; i += 32) {
+        m = vs_strstr_mask16(h, i, nn, first, last) |
+            vs_strstr_mask16(h, i + 16, nn, first, last) << 16;
+        if (m && (r = vs_strstr_verify(h, nd, nn, at = i, m, budget))
+                     != VS_NOT_FOUND)
+            goto out;
+    }
+    if (i + 16 <= cands) {
+        m = vs_strstr_mask16(h, i, nn, first, last);
+        if (m && (r = vs_strstr_verify(h, nd, nn, at = i, m, budget))
+                     != VS_NOT_FOUND)
+            goto out;
+        i += 16;
+    }
+    if (i < cands) {
+        at = cands - 16;
+        m = vs_strstr_mask16(h, at, nn, first, last);
+        m &= ~0ULL << (i - at);         /* skip positions already tested */
+        if (m)
+            r = vs_strstr_verify(h, nd, nn, at, m, budget);
+    }
+out:
+    *resume = at;
+    return r;
+}
+#endif
+
+#ifdef VS_HAVE_AVX2
+VS_TARGET_AVX2
+static inline uint64_t vs_strstr_mask32(const char *h, size_t at, size_t nn,
+                                        __m256i first, __m256i last)
+{
+    __m256i a = _mm256_loadu_si256((const __m256i *)(h + at));
+    __m256i b = _mm256_loadu_si256((const __m256i *)(h + at + nn - 1));
+    return (unsigned)_mm256_movemask_epi8(
+        _mm256_and_si256(_mm256_cmpeq_epi8(a, first),
+                         _mm256_cmpeq_epi8(b, last)));
+}
+
+/* vs_strstr_avx2() - vs_strstr_sse2() with 32-byte vectors; needs 32 candidates. */
+VS_TARGET_AVX2
+static inline size_t vs_strstr_avx2(const char *h, size_t hn,
+                                    const char *nd, size_t nn,
+                                    size_t *budget, size_t *resume)
+{
+    const __m256i first = _mm256_set1_epi8(nd[0]);
+    const __m256i last = _mm256_set1_epi8(nd[nn - 1]);
+    size_t cands = hn - nn + 1, i = 0, at = 0, r = VS_NOT_FOUND;
+    uint64_t m;
+    for (; i + 64 <= cands; i += 64) {
+        m = vs_strstr_mask32(h, i, nn, first, last) |
+            vs_strstr_mask32(h, i + 32, nn, first, last) << 32;
+        if (m && (r = vs_strstr_verify(h, nd, nn, at = i, m, budget))
+                     != VS_NOT_FOUND)
+            goto out;
+    }
+    if (i + 32 <= cands) {
+        m = vs_strstr_mask32(h, i, nn, first, last);
+        if (m && (r = vs_strstr_verify(h, nd, nn, at = i, m, budget))
+                     != VS_NOT_FOUND)
+            goto out;
+        i += 32;
+    }
+    if (i < cands) {
+        at = cands - 32;
+        m = vs_strstr_mask32(h, at, nn, first, last);
+        m &= ~0ULL << (i - at);
+        if (m)
+            r = vs_strstr_verify(h, nd, nn, at, m, budget);
+    }
+out:
+    *resume = at;
+    return r;
+}
+#endif
+
+/*
+ * vs_strstr_small() - Search without vectors: find the first byte, then
+ * compare the rest, within the same @budget as the filters.
+ */
+static inline size_t vs_strstr_small(const char *h, size_t hn,
+                                     const char *nd, size_t nn,
+                                     size_t *budget, size_t *resume)
+{
+    size_t i = 0, last = hn - nn;
+    while (i <= last) {
+        size_t k = vs_index(h + i, last - i + 1, (unsigned char)nd[0]);
+        if (k == VS_NOT_FOUND)
+            return VS_NOT_FOUND;
+        i += k;
+        for (k = 1; k < nn && h[i + k] == nd[k]; k++)
+            ;
+        if (k == nn)
+            return i;
+        if (*budget < k) {
+            *resume = i;
+            return VS_STRSTR_GIVEUP;
+        }
+        *budget -= k;
+        i++;
+    }
+    return VS_NOT_FOUND;
+}
+
+/*
+ * vs_strstr() - Offset of the first @nd[0..nn) in @h[0..hn), or
+ * VS_NOT_FOUND.  An empty needle matches at offset 0.
+ *
+ * Single bytes go to vs_index().  Longer needles are found with a vector
+ * filter on their first and last bytes, which skips most of the haystack
+ * whatever the needle length.  Candidates that pass the filter but fail to
+ * match cost a comparison each; once those comparisons add up to the
+ * haystack length the rest is handed to the two-way algorithm, so
+ * repetitive data still takes linear time.
+ */
+static inline size_t vs_strstr(const char *h, size_t hn,
+                               const char *nd, size_t nn)
+{
+    size_t budget = hn + 64, resume = 0, r;
+    if (nn > hn)
+        return VS_NOT_FOUND;
+    if (nn <= 1)
+        return nn ? vs_index(h, hn, (unsigned char)nd[0]) : 0;
+#ifdef VS_HAVE_SSE2
+    if (hn - nn + 1 >= 16) {
+#ifdef VS_HAVE_AVX2
+        if (hn - nn + 1 >= VS_AVX2_MIN && vs_cpu_has_avx2())
+            r = vs_strstr_avx2(h, hn, nd, nn, &budget, &resume);
+        else
+#endif
+            r = vs_strstr_sse2(h, hn, nd, nn, &budget, &resume);
+    } else
+#endif
+        r = vs_strstr_small(h, hn, nd, nn, &budget, &resume);
+    if (r != VS_STRSTR_GIVEUP)
+        return r;
+    r = vs_strstr_twoway((const unsigned char *)h + resume, hn - resume,
+                         (const unsigned char *)nd, nn);
+    return r == VS_NOT_FOUND ? r : r + resume;
+}
+
+/* vs_found() - Convert an offset or VS_NOT_FOUND to a ``long`` or -1. */
+static inline long vs_found(size_t r)
+{
+    return r == VS_NOT_FOUND ? -1L : (long)r;
+}
+
+/*
+ * v_index() - Index of the first byte @c in the VARCHAR @v, or -1.
+ * @v: VARCHAR to search; only ``len`` bytes are read.
+ * @c: Byte to find.
+ */
+#define v_index(v, c) vs_found(vs_index(V_BUF(v), V_LEN(v), (unsigned char)(c)))
+
+/* v_rindex() - Index of the last byte @c in the VARCHAR @v, or -1. */
+#define v_rindex(v, c) vs_found(vs_rindex(V_BUF(v), V_LEN(v), (unsigned char)(c)))
+
+/*
+ * v_strstr() - Index of the first occurrence of the VARCHAR @sub in the
+ * VARCHAR @v, or -1.  An empty @sub is found at 0.
+ */
+#define v_strstr(v, sub) \
+    vs_found(vs_strstr(V_BUF(v), V_LEN(v), V_BUF(sub), V_LEN(sub)))
+
+/* vp_strstr() - v_strstr() with a C string @p as the needle. */
+#define vp_strstr(v, p)                                                      \
+    ({                                                                       \
+        const char *__p = (p);                                               \
+        vs_found(vs_strstr(V_BUF(v), V_LEN(v), __p, strlen(__p)));           \
+    })
+
+#endif /* VSUITE_SEARCH_H */
@@ -0,0 +1,654 @@
+#ifndef VSUITE_SIMD_H
+#define VSUITE_SIMD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Vector kernels shared by the VSuite macros.
+ *
+ * Every kernel takes an explicit byte count and never reads outside
+ * ``[buf, buf + n)``.  Full vectors are processed first; the remainder is
+ * handled by one overlapping vector load anchored at the end of the buffer,
+ * or by 8/4 byte SWAR words for buffers shorter than a vector.
+ *
+ * SSE2 is the baseline on x86-64.  AVX2 versions are compiled with a target
+ * attribute and selected at runtime when the CPU supports them, so the
+ * headers still build with plain ``-std=gnu99``.  Define ``VSUITE_NO_SIMD``
+ * to force the portable scalar code.
+ */
+
+#if !defined(VSUITE_NO_SIMD) && defined(__SSE2__)
+#include <immintrin.h>
+#define VS_HAVE_SSE2 1
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VS_HAVE_AVX2 1
+#define VS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define VS_SWAR_LE 1
+#endif
+
+/* Buffers shorter than this are not worth the AVX2 dispatch. */
+#define VS_AVX2_MIN 64
+
+#define VS_ONES64  0x0101010101010101ULL
+#define VS_HIGHS64 0x8080808080808080ULL
+
+/*
+ * vs_cpu_has_avx2() - Runtime AVX2 check, cached after the first call.
+ */
+static inline int vs_cpu_has_avx2(void)
+{
+#ifdef VS_HAVE_AVX2
+    static int cached = -1;
+    if (cached < 0) {
+        __builtin_cpu_init();
+        cached = __builtin_cpu_supports("avx2") ? 1 : 0;
+    }
+    return cached;
+#else
+    return 0;
+#endif
+}
+
+static inline uint64_t vs_load64(const char *p)
+{
+    uint64_t w;
+    memcpy(&w, p, sizeof w);
+    return w;
+}
+
+static inline uint32_t vs_load32(const char *p)
+{
+    uint32_t w;
+    memcpy(&w, p, sizeof w);
+    return w;
+}
+
+static inline uint16_t vs_load16(const char *p)
+{
+    uint16_t w;
+    memcpy(&w, p, sizeof w);
+    return w;
+}
+
+static inline void vs_store64(char *p, uint64_t w) { memcpy(p, &w, sizeof w); }
+static inline void vs_store32(char *p, uint32_t w) { memcpy(p, &w, sizeof w); }
+static inline void vs_store16(char *p, uint16_t w) { memcpy(p, &w, sizeof w); }
+
+/*
+ * vs_zero_bytes64() - Mark zero bytes of @w with their high bit.
+ *
+ * Bits above the lowest marked byte may be false positives, so only the
+ * lowest set bit is meaningful.
+ */
+static inline uint64_t vs_zero_bytes64(uint64_t w)
+{
+    return (w - VS_ONES64) & ~w & VS_HIGHS64;
+}
+
+static inline uint32_t vs_zero_bytes32(uint32_t w)
+{
+    return (w - 0x01010101U) & ~w & 0x80808080U;
+}
+
+/*
+ * vs_find_nul_small() - NUL scan for buffers shorter than a vector.
+ *
+ * Two overlapping words cover any length from 4 to 16 bytes; the overlap
+ * was already found clean by the first word, so the second word's lowest
+ * hit is the first terminator in its remaining bytes.
+ */
+static inline char *vs_find_nul_small(const char *s, size_t n)
+{
+#ifdef VS_SWAR_LE
+    if (n >= 8) {
+        uint64_t m = vs_zero_bytes64(vs_load64(s));
+        if (m)
+            return (char *)s + (__builtin_ctzll(m) >> 3);
+        for (size_t i = 8; i + 8 <= n; i += 8) {
+            m = vs_zero_bytes64(vs_load64(s + i));
+            if (m)
+                return (char *)s + i + (__builtin_ctzll(m) >> 3);
+        }
+        m = vs_zero_bytes64(vs_load64(s + n - 8));
+        return m ? (char *)s + n - 8 + (__builtin_ctzll(m) >> 3) : NULL;
+    }
+    if (n >= 4) {
+        uint32_t m = vs_zero_bytes32(vs_load32(s));
+        if (m)
+            return (char *)s + (__builtin_ctz(m) >> 3);
+        m = vs_zero_bytes32(vs_load32(s + n - 4));
+        return m ? (char *)s + n - 4 + (__builtin_ctz(m) >> 3) : NULL;
+    }
+#endif
+    for (size_t i = 0; i < n; i++)
+        if (s[i] == '\0')
+            return (char *)s + i;
+    return NULL;
+}
+
+#ifdef VS_HAVE_SSE2
+static inline char *vs_find_nul_sse2(const char *s, size_t n)
+{
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(s + i));
+        unsigned m = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, zero));
+        if (m)
+            return (char *)s + i + __builtin_ctz(m);
+    }
+    if (i < n) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(s + n - 16));
+        unsigned m = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, zero));
+        if (m)
+            return (char *)s + n - 16 + __builtin_ctz(m);
+    }
+    return NULL;
+}
+#endif
+
+#ifdef VS_HAVE_AVX2
+VS_TARGET_AVX2
+static inline char *vs_find_nul_avx2(const char *s, size_t n)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(s + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(s + i + 32));
+        __m256i ea = _mm256_cmpeq_epi8(a, zero);
+        __m256i eb = _mm256_cmpeq_epi8(b, zero);
+        if (!_mm256_testz_si256(_mm256_or_si256(ea, eb), _mm256_or_si256(ea, eb))) {
+            unsigned ma = (unsigned)_mm256_movemask_epi8(ea);
+            if (ma)
+                return (char *)s + i + __builtin_ctz(ma);
+            return (char *)s + i + 32 + __builtin_ctz((unsigned)_mm256_movemask_epi8(eb));
+        }
+    }
+    for (; i + 32 <= n; i += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(s + i));
+        unsigned m = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, zero));
+        if (m)
+            return (char *)s + i + __builtin_ctz(m);
+    }
+    if (i < n) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(s + n - 32));
+        unsigned m = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, zero));
+        if (m)
+            return (char *)s + n - 32 + __builtin_ctz(m);
+    }
+    return NULL;
+}
+#endif
+
+/*
+ * vs_find_nul() - Locate the first NUL byte in ``s[0..n)``.
+ * @s: Buffer to scan.
+ * @n: Number of bytes to examine; nothing beyond ``s + n`` is read.
+ *
+ * Returns a pointer to the first ``'\0'`` or ``NULL`` when none is present.
+ */
+static inline char *vs_find_nul(const char *s, size_t n)
+{
+#ifdef VS_HAVE_SSE2
+    if (n >= 16) {
+#ifdef VS_HAVE_AVX2
+        if (n >= VS_AVX2_MIN && vs_cpu_has_avx2())
+            return vs_find_nul_avx2(s, n);
+#endif
+        return vs_find_nul_sse2(s, n);
+    }
+#endif
+    return vs_find_nul_small(s, n);
+}
+
+/*
+ * vs_case_word() - Flip the case of the ASCII letters ``lo..lo+25`` in @w.
+ *
+ * Bytes are tested on their low seven bits; the carries cannot cross byte
+ * boundaries because every partial sum stays below 0x100.  Bytes with the
+ * high bit set are never touched.
+ */
+static inline uint64_t vs_case_word(uint64_t w, unsigned char lo)
+{
+    uint64_t h = w & ~VS_HIGHS64;
+    uint64_t ge = h + (uint64_t)(0x80 - lo) * VS_ONES64;
+    uint64_t gt = h + (uint64_t)(0x80 - lo - 26) * VS_ONES64;
+    return w ^ (((ge & ~gt & ~w) & VS_HIGHS64) >> 2);
+}
+
+static inline void vs_case_small(char *s, size_t n, unsigned char lo)
+{
+#ifdef VS_SWAR_LE
+    if (n >= 8) {
+        /* case conversion is idempotent, so the last word may overlap */
+        for (size_t i = 0; i + 8 <= n; i += 8) {
+            uint64_t w = vs_case_word(vs_load64(s + i), lo);
+            memcpy(s + i, &w, sizeof w);
+        }
+        uint64_t w = vs_case_word(vs_load64(s + n - 8), lo);
+        memcpy(s + n - 8, &w, sizeof w);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < n; i++) {
+        unsigned char c = (unsigned char)s[i];
+        s[i] = (char)(c ^ (((unsigned char)(c - lo) < 26) << 5));
+    }
+}
+
+#ifdef VS_HAVE_SSE2
+static inline __m128i vs_case_sse2_vec(__m128i x, __m128i bias, __m128i limit,
+                                       __m128i flip)
+{
+    /* bias maps lo..lo+25 onto -128..-103 so one signed compare suffices */
+    __m128i t = _mm_add_epi8(x, bias);
+    __m128i m = _mm_cmplt_epi8(t, limit);
+    return _mm_xor_si128(x, _mm_and_si128(m, flip));
+}
+
+static inline void vs_case_sse2(char *s, size_t n, unsigned char lo)
+{
+    const __m128i bias  = _mm_set1_epi8((char)(0x80 - lo));
+    const __m128i limit = _mm_set1_epi8((char)(-128 + 26));
+    const __m128i flip  = _mm_set1_epi8(0x20);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(s + i));
+        _mm_storeu_si128((__m128i *)(s + i), vs_case_sse2_vec(x, bias, limit, flip));
+    }
+    if (i < n) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(s + n - 16));
+        _mm_storeu_si128((__m128i *)(s + n - 16), vs_case_sse2_vec(x, bias, limit, flip));
+    }
+}
+#endif
+
+#ifdef VS_HAVE_AVX2
+VS_TARGET_AVX2
+static inline void vs_case_avx2(char *s, size_t n, unsigned char lo)
+{
+    const __m256i bias  = _mm256_set1_epi8((char)(0x80 - lo));
+    const __m256i limit = _mm256_set1_epi8((char)(-128 + 26));
+    const __m256i flip  = _mm256_set1_epi8(0x20);
+    size_t i = 0;
+    for (;;) {
+        if (i + 32 > n)
+            i = n - 32;
+        __m256i x = _mm256_loadu_si256((const __m256i *)(s + i));
+        __m256i m = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(x, bias));
+        x = _mm256_xor_si256(x, _mm256_and_si256(m, flip));
+        _mm256_storeu_si256((__m256i *)(s + i), x);
+        if (i + 32 >= n)
+            break;
+        i += 32;
+    }
+}
+#endif
+
+/*
+ * vs_case() - Flip the case of ASCII letters ``lo..lo+25`` in ``s[0..n)``.
+ * @lo: ``'a'`` to uppercase, ``'A'`` to lowercase.
+ *
+ * Locale independent; bytes outside the ASCII letter range are unchanged.
+ */
+static inline void vs_case(char *s, size_t n, unsigned char lo)
+{
+#ifdef VS_HAVE_SSE2
+    if (n >= 16) {
+#ifdef VS_HAVE_AVX2
+        if (n >= VS_AVX2_MIN && vs_cpu_has_avx2()) {
+            vs_case_avx2(s, n, lo);
+            return;
+        }
+#endif
+        vs_case_sse2(s, n, lo);
+        return;
+    }
+#endif
+    vs_case_small(s, n, lo);
+}
+
+/* vs_upper() / vs_lower() - ASCII case conversion of ``s[0..n)`` in place. */
+static inline void vs_upper(char *s, size_t n) { vs_case(s, n, 'a'); }
+static inline void vs_lower(char *s, size_t n) { vs_case(s, n, 'A'); }
+
+/*
+ * vs_space_word() - Mark the ASCII whitespace bytes of @w with their high bit.
+ *
+ * Whitespace is the "C" locale ``isspace`` set: ``' '`` and ``'\t'..'\r'``.
+ * Unlike vs_zero_bytes64() the result is exact for every byte.
+ */
+static inline uint64_t vs_space_word(uint64_t w)
+{
+    uint64_t h = w & ~VS_HIGHS64;
+    uint64_t x = h ^ (0x20 * VS_ONES64);
+    uint64_t blank = ~((x + ~VS_HIGHS64) | x);
+    uint64_t ge = h + (uint64_t)(0x80 - '\t') * VS_ONES64;
+    uint64_t gt = h + (uint64_t)(0x80 - '\r' - 1) * VS_ONES64;
+    return (blank | (ge & ~gt)) & ~w & VS_HIGHS64;
+}
+
+static inline int vs_is_space(unsigned char c)
+{
+    return c == ' ' || (unsigned char)(c - '\t') < 5;
+}
+
+static inline size_t vs_span_space_small(const char *s, size_t n)
+{
+#ifdef VS_SWAR_LE
+    if (n >= 8) {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            uint64_t m = ~vs_space_word(vs_load64(s + i)) & VS_HIGHS64;
+            if (m)
+                return i + (__builtin_ctzll(m) >> 3);
+        }
+        if (i < n) {
+            uint64_t m = ~vs_space_word(vs_load64(s + n - 8)) & VS_HIGHS64;
+            if (m)
+                return n - 8 + (__builtin_ctzll(m) >> 3);
+        }
+        return n;
+    }
+#endif
+    size_t i = 0;
+    while (i < n && vs_is_space((unsigned char)s[i]))
+        i++;
+    return i;
+}
+
+static inline size_t vs_rspan_space_small(const char *s, size_t n)
+{
+#ifdef VS_SWAR_LE
+    if (n >= 8) {
+        size_t i = n;
+        for (; i >= 8; i -= 8) {
+            uint64_t m = ~vs_space_word(vs_load64(s + i - 8)) & VS_HIGHS64;
+            if (m)
+                return i - 8 + ((63 - __builtin_clzll(m)) >> 3) + 1;
+        }
+        if (i > 0) {
+            uint64_t m = ~vs_space_word(vs_load64(s)) & VS_HIGHS64;
+            m &= (1ULL << (i * 8)) - 1;
+            if (m)
+                return ((63 - __builtin_clzll(m)) >> 3) + 1;
+        }
+        return 0;
+    }
+#endif
+    while (n > 0 && vs_is_space((unsigned char)s[n - 1]))
+        n--;
+    return n;
+}
+
+#ifdef VS_HAVE_SSE2
+/* Bit i set when byte i of @x is not whitespace. */
+static inline unsigned vs_nonspace_mask16(__m128i x)
+{
+    __m128i blank = _mm_cmpeq_epi8(x, _mm_set1_epi8(' '));
+    __m128i t = _mm_sub_epi8(x, _mm_set1_epi8('\t'));
+    __m128i ctl = _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8(4)), t);
+    return ~(unsigned)_mm_movemask_epi8(_mm_or_si128(blank, ctl)) & 0xffffU;
+}
+
+static inline size_t vs_span_space_sse2(const char *s, size_t n)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        unsigned m = vs_nonspace_mask16(_mm_loadu_si128((const __m128i *)(s + i)));
+        if (m)
+            return i + __builtin_ctz(m);
+    }
+    if (i < n) {
+        unsigned m = vs_nonspace_mask16(_mm_loadu_si128((const __m128i *)(s + n - 16)));
+        if (m)
+            return n - 16 + __builtin_ctz(m);
+    }
+    return n;
+}
+
+static inline size_t vs_rspan_space_sse2(const char *s, size_t n)
+{
+    size_t i = n;
+    for (; i >= 16; i -= 16) {
+        unsigned m = vs_nonspace_mask16(_mm_loadu_si128((const __m128i *)(s + i - 16)));
+        if (m)
+            return i - 16 + (31 - __builtin_clz(m)) + 1;
+    }
+    if (i > 0) {
+        unsigned m = vs_nonspace_mask16(_mm_loadu_si128((const __m128i *)s));
+        m &= (1U << i) - 1;
+        if (m)
+            return (31 - __builtin_clz(m)) + 1;
+    }
+    return 0;
+}
+#endif
+
+#ifdef VS_HAVE_AVX2
+VS_TARGET_AVX2
+static inline unsigned vs_nonspace_mask32(__m256i x)
+{
+    __m256i blank = _mm256_cmpeq_epi8(x, _mm256_set1_epi8(' '));
+    __m256i t = _mm256_sub_epi8(x, _mm256_set1_epi8('\t'));
+    __m256i ctl = _mm256_cmpeq_epi8(_mm256_min_epu8(t, _mm256_set1_epi8(4)), t);
+    return ~(unsigned)_mm256_movemask_epi8(_mm256_or_si256(blank, ctl));
+}
+
+VS_TARGET_AVX2
+static inline size_t vs_span_space_avx2(const char *s, size_t n)
+{
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        unsigned m = vs_nonspace_mask32(_mm256_loadu_si256((const __m256i *)(s + i)));
+        if (m)
+            return i + __builtin_ctz(m);
+    }
+    if (i < n) {
+        unsigned m = vs_nonspace_mask32(_mm256_loadu_si256((const __m256i *)(s + n - 32)));
+        if (m)
+            return n - 32 + __builtin_ctz(m);
+    }
+    return n;
+}
+
+VS_TARGET_AVX2
+static inline size_t vs_rspan_space_avx2(const char *s, size_t n)
+{
+    size_t i = n;
+    for (; i >= 32; i -= 32) {
+        unsigned m = vs_nonspace_mask32(_mm256_loadu_si256((const __m256i *)(s + i - 32)));
+        if (m)
+            return i - 32 + (31 - __builtin_clz(m)) + 1;
+    }
+    if (i > 0) {
+        unsigned m = vs_nonspace_mask32(_mm256_loadu_si256((const __m256i *)s));
+        m &= (1U << i) - 1;
+        if (m)
+            return (31 - __builtin_clz(m)) + 1;
+    }
+    return 0;
+}
+#endif
+
+/*
+ * vs_span_space() - Count the leading whitespace bytes of ``s[0..n)``.
+ *
+ * Returns the offset of the first non-blank byte, or @n when every byte is
+ * whitespace.
+ */
+static inline size_t vs_span_space(const char *s, size_t n)
+{
+    size_t r;
+#ifdef VS_HAVE_SSE2
+    if (n >= 16) {
+#ifdef VS_HAVE_AVX2
+        if (n >= VS_AVX2_MIN && vs_cpu_has_avx2())
+            r = vs_span_space_avx2(s, n);
+        else
+#endif
+            r = vs_span_space_sse2(s, n);
+    } else
+#endif
+        r = vs_span_space_small(s, n);
+    /* tell the compiler the result is an offset into s, for -Warray-bounds */
+    if (r > n)
+        __builtin_unreachable();
+    return r;
+}
+
+/*
+ * vs_rspan_space() - Length of ``s[0..n)`` without its trailing whitespace.
+ *
+ * Returns one past the last non-blank byte, or 0 when every byte is
+ * whitespace.
+ */
+static inline size_t vs_rspan_space(const char *s, size_t n)
+{
+    size_t r;
+#ifdef VS_HAVE_SSE2
+    if (n >= 16) {
+#ifdef VS_HAVE_AVX2
+        if (n >= VS_AVX2_MIN && vs_cpu_has_avx2())
+            r = vs_rspan_space_avx2(s, n);
+        else
+#endif
+            r = vs_rspan_space_sse2(s, n);
+    } else
+#endif
+        r = vs_rspan_space_small(s, n);
+    /* tell the compiler the result is an offset into s, for -Warray-bounds */
+    if (r > n)
+        __builtin_unreachable();
+    return r;
+}
+
+/*
+ * Small copies.
+ *
+ * Every field in the GL interface is a few bytes long, and a library
+ * ``memmove`` call costs more than the copy itself.  Up to 32 bytes are
+ * moved with two overlapping loads from each end of the source followed by
+ * two stores, so any length in a range is a fixed, branch-light sequence.
+ * Both loads complete before either store, which keeps overlapping source
+ * and destination correct without the ``memmove`` direction check.
+ */
+
+/* vs_copy16() - Copy 0..16 bytes; loads finish before stores. */
+static inline __attribute__((always_inline))
+void vs_copy16(char *d, const char *s, size_t n)
+{
+    if (n >= 8) {
+        uint64_t a = vs_load64(s), b = vs_load64(s + n - 8);
+        vs_store64(d, a);
+        vs_store64(d + n - 8, b);
+    } else if (n >= 4) {
+        uint32_t a = vs_load32(s), b = vs_load32(s + n - 4);
+        vs_store32(d, a);
+        vs_store32(d + n - 4, b);
+    } else if (n >= 2) {
+        uint16_t a = vs_load16(s), b = vs_load16(s + n - 2);
+        vs_store16(d, a);
+        vs_store16(d + n - 2, b);
+    } else if (n) {
+        d[0] = s[0];
+    }
+}
+
+/* vs_copy32() - Copy 17..32 bytes; loads finish before stores. */
+static inline __attribute__((always_inline))
+void vs_copy32(char *d, const char *s, size_t n)
+{
+#ifdef VS_HAVE_SSE2
+    __m128i a = _mm_loadu_si128((const __m128i *)s);
+    __m128i b = _mm_loadu_si128((const __m128i *)(s + n - 16));
+    _mm_storeu_si128((__m128i *)d, a);
+    _mm_storeu_si128((__m128i *)(d + n - 16), b);
+#else
+    uint64_t a = vs_load64(s), b = vs_load64(s + 8);
+    uint64_t c = vs_load64(s + n - 16), e = vs_load64(s + n - 8);
+    vs_store64(d, a);
+    vs_store64(d + 8, b);
+    vs_store64(d + n - 16, c);
+    vs_store64(d + n - 8, e);
+#endif
+}
+
+#ifdef VS_HAVE_SSE2
+/* vs_copy64_sse2() - Copy 33..64 bytes; loads finish before stores. */
+static inline __attribute__((always_inline))
+void vs_copy64_sse2(char *d, const char *s, size_t n)
+{
+    __m128i a = _mm_loadu_si128((const __m128i *)s);
+    __m128i b = _mm_loadu_si128((const __m128i *)(s + 16));
+    __m128i c = _mm_loadu_si128((const __m128i *)(s + n - 32));
+    __m128i e = _mm_loadu_si128((const __m128i *)(s + n - 16));
+    _mm_storeu_si128((__m128i *)d, a);
+    _mm_storeu_si128((__m128i *)(d + 16), b);
+    _mm_storeu_si128((__m128i *)(d + n - 32), c);
+    _mm_storeu_si128((__m128i *)(d + n - 16), e);
+}
+#define VS_COPY_INLINE_MAX 64
+#else
+#define VS_COPY_INLINE_MAX 32
+#endif
+
+/*
+ * vs_opaque_len() - Hide @n from the optimizer.
+ *
+ * When GCC can bound a ``memcpy`` length by a declared size it expands the
+ * copy inline as ``rep movsq``, whose startup cost makes copies of a few
+ * hundred bytes several times slower than the library routine.
+ */
+static inline __attribute__((always_inline)) size_t vs_opaque_len(size_t n)
+{
+    __asm__("" : "+r"(n));
+    return n;
+}
+
+/*
+ * vs_copy() - Copy @n bytes from @s to @d; the regions may overlap.
+ * @cap: Upper bound on @n known from the declared buffer sizes.
+ *
+ * The macros pass a compile-time @cap, so for narrow fields only the
+ * branches for lengths up to @cap survive and the copy inlines to a few
+ * moves.  A length beyond @cap (a corrupt ``len``) or beyond
+ * VS_COPY_INLINE_MAX goes to the library, using ``memcpy`` when the regions
+ * are disjoint, with the length passed through vs_opaque_len().
+ *
+ * Unoptimized builds inline nothing, so they keep the plain ``memmove``.
+ */
+#ifdef __OPTIMIZE__
+#define vs_copy(d, s, n, cap) vs_copy_fcn((d), (s), (n), (cap))
+#else
+#define vs_copy(d, s, n, cap) ((void)(cap), (void)memmove((d), (s), (n)))
+#endif
+
+static inline __attribute__((always_inline))
+void vs_copy_fcn(char *d, const char *s, size_t n, size_t cap)
+{
+    if (n <= (cap < VS_COPY_INLINE_MAX ? cap : VS_COPY_INLINE_MAX)) {
+        if (n <= 16)
+            vs_copy16(d, s, n);
+        else if (n <= 32)
+            vs_copy32(d, s, n);
+#ifdef VS_HAVE_SSE2
+        else
+            vs_copy64_sse2(d, s, n);
+#endif
+    } else if ((uintptr_t)d - (uintptr_t)s >= n &&
+               (uintptr_t)s - (uintptr_t)d >= n) {
+        memcpy(d, s, vs_opaque_len(n));
+    } else {
+        memmove(d, s, vs_opaque_len(n));
+    }
+}
+
+#endif /* VSUITE_SIMD_H */
@@ -4,12 +4,37 @@
 #include <string.h>
 #include <ctype.h>
 
+#include <vsuite/simd.h>
+#include <vsuite/telemetry.h>
+
 /*
  * S_SIZE() - Return the total capacity of fixed C-String
  * @s: Fixed allocation C-String
  */
 #define S_SIZE(s) (sizeof(s))
 
+/*
+ * S_LEN() - Length of a fixed C-String, bounded by its capacity.
+ * @s: Fixed allocation C-String
+ *
+ * Equivalent to ``strnlen(s, S_SIZE(s))``; the explicit clamp lets the
+ * compiler see that the in-place kernels stay inside ``s``.  A ``char *``
+ * has no capacity to bound by, so for pointers this is ``strlen(s)``.
+ */
+#define S_LEN(s)                                                           \
+    __builtin_choose_expr(S_IS_PTR(s), strlen((const char *)(s)),          \
+                          s_strnlen_fcn((const char *)(s), S_SIZE(s)))
+
+/* S_IS_PTR() - True when @s is a pointer rather than a character array. */
+#define S_IS_PTR(s) \
+    __builtin_types_compatible_p(__typeof__(s), __typeof__(&(s)[0]))
+
+static inline size_t s_strnlen_fcn(const char *s, size_t cap)
+{
+    size_t n = strnlen(s, cap);
+    return n < cap ? n : cap;
+}
+
 /*
  * s_has_capacity() - Test if @s can hold @N bytes.
  * @s:  Fixed C-String variable being queried.
@@ -103,7 +128,9 @@
                   __LINE__, #dest, #src, __n, __cap);                       \
             __n = __cap - 1;                                                \
         }                                                                   \
-        memmove((dest), (src), __n);                                        \
+        VS_TELEMETRY("s_copy", S_SIZE(dest), __n + varchar_overflow + 1,    \
+                     varchar_overflow);                                     \
+        vs_copy((dest), (src), __n, S_SIZE(dest));                          \
         (dest)[__n] = '\0';                                                \
         __n;                                                                \
     })
@@ -132,7 +159,9 @@
                   __LINE__, #dest, #src, (unsigned)(n), __n, __cap);        \
             __n = __cap - 1;                                                \
         }                                                                   \
-        memmove((dest), (src), __n);                                        \
+        VS_TELEMETRY("s_strncpy", S_SIZE(dest), __n + varchar_overflow + 1, \
+                     varchar_overflow);                                     \
+        vs_copy((dest), (src), __n, S_SIZE(dest));                          \
         (dest)[__n] = '\0';                                                \
         (int)__n;                                                           \
     })
@@ -161,7 +190,10 @@
                   __LINE__, #dest, #src, __n, S_SIZE(dest));        \
             __n = __avail;                                          \
         }                                                           \
-        memmove((dest) + __dlen, (src), __n);                       \
+        VS_TELEMETRY("s_strcat", S_SIZE(dest),                      \
+                     __dlen + __n + varchar_overflow + 1,           \
+                     varchar_overflow);                             \
+        vs_copy((dest) + __dlen, (src), __n, S_SIZE(dest));         \
         (dest)[__dlen + __n] = '\0';                                \
         (int)__n;                                                   \
     })
@@ -191,7 +223,10 @@
                   __LINE__, #dest, #src, (unsigned)(n), __n, S_SIZE(dest)); \
             __n = __avail;                                          \
         }                                                           \
-        memmove((dest) + __dlen, (src), __n);                       \
+        VS_TELEMETRY("s_strncat", S_SIZE(dest),                     \
+                     __dlen + __n + varchar_overflow + 1,           \
+                     varchar_overflow);                             \
+        vs_copy((dest) + __dlen, (src), __n, S_SIZE(dest));         \
         (dest)[__dlen + __n] = '\0';                                \
         (int)__n;                                                   \
     })
@@ -199,63 +234,56 @@
 /*
  * s_ltrim() - Remove leading ASCII whitespace from a C string.
  *
- * Characters are shifted left in-place using ``memmove`` when leading
- * whitespace is detected.
+ * The first non-blank byte is located with vs_span_space() and the rest of
+ * the string, terminator included, is shifted left with ``memmove``.
  */
 #define s_ltrim(s) do {                                            \
-    size_t __len = strnlen((s), S_SIZE(s));                        \
-    size_t i = 0;                                                  \
-    while (i < __len && isspace((unsigned char)(s)[i]))            \
-        i++;                                                       \
-    if (i > 0) {                                                   \
-        memmove((s), (s) + i, __len - i + 1);                      \
+    size_t __len = S_LEN(s);                                       \
+    size_t __i = vs_span_space((s), __len);                        \
+    if (__i > 0) {                                                 \
+        memmove((s), (s) + __i, __len - __i + 1);                  \
     }                                                              \
 } while (0)
 
 /*
  * s_rtrim() - Strip trailing ASCII whitespace from a C string.
  *
- * Characters are removed from the end while whitespace is encountered.
+ * A terminator is written after the last non-blank byte.
  */
 #define s_rtrim(s) do {                                            \
-    size_t __len = strnlen((s), S_SIZE(s));                        \
-    while (__len > 0 &&                                           \
-           isspace((unsigned char)(s)[__len - 1])) {               \
-        __len--;                                                  \
-    }                                                             \
-    (s)[__len] = '\0';                                            \
+    size_t __len = S_LEN(s);                                       \
+    (s)[vs_rspan_space((s), __len)] = '\0';                        \
 } while (0)
 
 /*
- * s_trim() - Convenience wrapper to run both s_rtrim() and s_ltrim().
+ * s_trim() - Remove leading and trailing whitespace in one pass.
  *
- * Leading and trailing whitespace are removed as described by the individual
- * helpers.
+ * Like v_trim() the leading scan is bounded by the trimmed end, so each
+ * byte is examined once and the string is moved at most once.
  */
-#define s_trim(s)  \
-    do { s_rtrim(s); s_ltrim(s); } while (0)
+#define s_trim(s) do {                                             \
+    size_t __len = S_LEN(s);                                       \
+    size_t __end = vs_rspan_space((s), __len);                     \
+    size_t __i = vs_span_space((s), __end);                        \
+    if (__i > 0)                                                   \
+        memmove((s), (s) + __i, __end - __i);                      \
+    (s)[__end - __i] = '\0';                                       \
+} while (0)
 
 /*
  * s_upper() - In-place ASCII uppercase conversion.
  *
- * Each byte is converted with ``toupper`` using unsigned char promotion.
+ * Converts the bytes before the terminator (at most S_SIZE(s) for an
+ * array) with vs_upper().  Only ``'a'..'z'`` are changed; the current locale is not
+ * consulted.
  */
-#define s_upper(s) \
-    do { \
-        for (char *p = s; *p != '\0'; p++) { \
-            *p = toupper((unsigned char)*p); \
-        } \
-    } while (0)
+#define s_upper(s) vs_upper((s), S_LEN(s))
 
 /*
  * s_lower() - In-place ASCII lowercase conversion.
  *
- * Like ``s_upper`` but using ``tolower``.
+ * Like ``s_upper`` but using vs_lower().
  */
-
-#define s_lower(s) do {                                   \
-    for (size_t i = 0; (s)[i] != '\0'; i++)              \
-        (s)[i] = tolower((unsigned char)(s)[i]);          \
-} while (0)
+#define s_lower(s) vs_lower((s), S_LEN(s))
 
 #endif /* VARCHAR_MACROS_S_H */
@@ -0,0 +1,215 @@
+#ifndef VSUITE_TELEMETRY_H
+#define VSUITE_TELEMETRY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Per-call-site overflow telemetry.
+ *
+ * Compiled in with VSUITE_TELEMETRY.  Every macro that may truncate then
+ * keeps a static record in the ``vs_telemetry`` linker section: macro name,
+ * call site, destination size, calls, overflows and the largest destination
+ * size any call needed.  That covers the copy, cat and sprintf macros of
+ * varchar.h and zvarchar.h, the pstr.h and fixed.h copies, the ``s_`` copies
+ * and cats of string.h, v_concat_many(), v_build_end(), v_from_int() and its
+ * siblings, vb_copy() and the vc_ copies, and the ``zv_`` forms where they
+ * exist.  The linker collects the records of all translation units into one
+ * array, so the registry costs nothing to build and is walked through the
+ * ``__start_``/``__stop_`` symbols.
+ *
+ * At exit the registry is written to the file named by the VSUITE_TELEMETRY
+ * environment variable (``-`` for stderr; JSON when the name ends in
+ * ``.json``, CSV otherwise).  vs_telemetry_dump_csv() and
+ * vs_telemetry_dump_json() write it on demand.
+ *
+ * Without VSUITE_TELEMETRY the hooks expand to nothing.
+ */
+
+/*
+ * vs_telemetry_site_t - Counters of one call site.
+ * @macro:    Name of the macro, e.g. ``"v_copy"``.
+ * @file:     __FILE__ of the site.
+ * @line:     __LINE__ of the site.
+ * @size:     V_SIZE() of the destination; of one element for vb_copy() and
+ *            the vc_ macros, and 0 when the pv_copy() capacity is not a
+ *            constant.
+ * @calls:    Calls so far.
+ * @overflow: Calls that truncated.
+ * @required: Largest destination size needed to avoid truncation, the
+ *            terminator included where the macro writes one.
+ *
+ * One cache line each, so sites hit by different threads do not share one.
+ */
+typedef struct {
+    const char *macro;
+    const char *file;
+    int line;
+    size_t size;
+    uint64_t calls;
+    uint64_t overflow;
+    uint64_t required;
+} __attribute__((aligned(64))) vs_telemetry_site_t;
+
+extern vs_telemetry_site_t __start_vs_telemetry[] __attribute__((weak));
+extern vs_telemetry_site_t __stop_vs_telemetry[] __attribute__((weak));
+
+int vs_telemetry_hooked __attribute__((weak));
+
+/*
+ * vs_telemetry_sites() - First record of the registry; sets @n to the
+ * number of records.  Records of sites never reached have zero calls.
+ */
+static inline vs_telemetry_site_t *vs_telemetry_sites(size_t *n)
+{
+    *n = __start_vs_telemetry ? (size_t)(__stop_vs_telemetry - __start_vs_telemetry) : 0;
+    return __start_vs_telemetry;
+}
+
+/* vs_telemetry_find() - Record of @macro at @file:@line, or ``NULL``. */
+static inline vs_telemetry_site_t *vs_telemetry_find(const char *macro,
+                                                     const char *file, int line)
+{
+    size_t n;
+    vs_telemetry_site_t *s = vs_telemetry_sites(&n);
+    for (size_t i = 0; i < n; i++)
+        if (s[i].line == line && !strcmp(s[i].macro, macro) &&
+            !strcmp(s[i].file, file))
+            return &s[i];
+    return NULL;
+}
+
+/*
+ * vs_telemetry_count() - Count one call of @s that needed @required bytes
+ * of destination; @overflow is nonzero when it truncated.
+ */
+static inline void vs_telemetry_count(vs_telemetry_site_t *s, size_t required,
+                                      int overflow)
+{
+    __atomic_fetch_add(&s->calls, 1, __ATOMIC_RELAXED);
+    if (overflow)
+        __atomic_fetch_add(&s->overflow, 1, __ATOMIC_RELAXED);
+    uint64_t max = __atomic_load_n(&s->required, __ATOMIC_RELAXED);
+    while (required > max &&
+           !__atomic_compare_exchange_n(&s->required, &max, required, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+/*
+ * vs_telemetry_dump_csv() - Write the registry to @f as CSV with a header
+ * line.  Returns the number of records written.
+ */
+static inline size_t vs_telemetry_dump_csv(FILE *f)
+{
+    size_t n;
+    vs_telemetry_site_t *s = vs_telemetry_sites(&n);
+    fprintf(f, "macro,file,line,size,calls,overflow,required\n");
+    for (size_t i = 0; i < n; i++)
+        fprintf(f, "%s,\"%s\",%d,%zu,%llu,%llu,%llu\n",
+                s[i].macro, s[i].file, s[i].line, s[i].size,
+                (unsigned long long)__atomic_load_n(&s[i].calls, __ATOMIC_RELAXED),
+                (unsigned long long)__atomic_load_n(&s[i].overflow, __ATOMIC_RELAXED),
+                (unsigned long long)__atomic_load_n(&s[i].required, __ATOMIC_RELAXED));
+    return n;
+}
+
+/* vs_telemetry_json_str() - Write @str to @f as a JSON string. */
+static inline void vs_telemetry_json_str(FILE *f, const char *str)
+{
+    fputc('"', f);
+    for (; *str; str++) {
+        if (*str == '"' || *str == '\\')
+            fputc('\\', f);
+        if ((unsigned char)*str < 0x20)
+            fprintf(f, "\\u%04x", *str);
+        else
+            fputc(*str, f);
+    }
+    fputc('"', f);
+}
+
+/*
+ * vs_telemetry_dump_json() - Write the registry to @f as a JSON array of
+ * objects with the CSV column names.  Returns the number of records.
+ */
+static inline size_t vs_telemetry_dump_json(FILE *f)
+{
+    size_t n;
+    vs_telemetry_site_t *s = vs_telemetry_sites(&n);
+    fputc('[', f);
+    for (size_t i = 0; i < n; i++) {
+        fprintf(f, "%s\n  {\"macro\": ", i ? "," : "");
+        vs_telemetry_json_str(f, s[i].macro);
+        fprintf(f, ", \"file\": ");
+        vs_telemetry_json_str(f, s[i].file);
+        fprintf(f, ", \"line\": %d, \"size\": %zu, \"calls\": %llu, "
+                   "\"overflow\": %llu, \"required\": %llu}",
+                s[i].line, s[i].size,
+                (unsigned long long)__atomic_load_n(&s[i].calls, __ATOMIC_RELAXED),
+                (unsigned long long)__atomic_load_n(&s[i].overflow, __ATOMIC_RELAXED),
+                (unsigned long long)__atomic_load_n(&s[i].required, __ATOMIC_RELAXED));
+    }
+    fprintf(f, "%s]\n", n ? "\n" : "");
+    return n;
+}
+
+/*
+ * vs_telemetry_dump() - Write the registry to @path, ``-`` meaning stderr;
+ * JSON when @path ends in ``.json``.  Returns the number of records or -1
+ * when the file cannot be opened.
+ */
+static inline long vs_telemetry_dump(const char *path)
+{
+    size_t len = strlen(path);
+    int json = len >= 5 && !strcmp(path + len - 5, ".json");
+    FILE *f = strcmp(path, "-") ? fopen(path, "w") : stderr;
+    if (!f)
+        return -1;
+    size_t n = json ? vs_telemetry_dump_json(f) : vs_telemetry_dump_csv(f);
+    if (f == stderr)
+        fflush(f);
+    else if (fclose(f) != 0)
+        return -1;
+    return (long)n;
+}
+
+/* vs_telemetry_at_exit() - Dump to $VSUITE_TELEMETRY, run by ``atexit``. */
+static inline void vs_telemetry_at_exit(void)
+{
+    const char *path = getenv("VSUITE_TELEMETRY");
+    if (path && *path && vs_telemetry_dump(path) < 0)
+        perror(path);
+}
+
+#ifdef VSUITE_TELEMETRY
+
+/* Registers the exit dump once per process, from whichever unit runs first. */
+static __attribute__((constructor, used)) void vs_telemetry_init(void)
+{
+    if (!__atomic_exchange_n(&vs_telemetry_hooked, 1, __ATOMIC_ACQ_REL))
+        atexit(vs_telemetry_at_exit);
+}
+
+/*
+ * VS_TELEMETRY() - Count a call of @macro writing to a destination of
+ * @size bytes that needed @required; @overflow when it truncated.  @size
+ * must be a constant expression.
+ */
+#define VS_TELEMETRY(macro, size, required, overflow)                        \
+    do {                                                                     \
+        static vs_telemetry_site_t __vs_tm                                   \
+            __attribute__((section("vs_telemetry"), used)) =                 \
+            { (macro), __FILE__, __LINE__, (size), 0, 0, 0 };                \
+        vs_telemetry_count(&__vs_tm, (required), (overflow) != 0);           \
+    } while (0)
+
+#else
+
+#define VS_TELEMETRY(macro, size, required, overflow) do { } while (0)
+
+#endif
+
+#endif /* VSUITE_TELEMETRY_H */
@@ -7,15 +7,66 @@
 #include <stdarg.h>
 #include <stdio.h>
 
+#include <vsuite/simd.h>
+#include <vsuite/telemetry.h>
+#include <vsuite/profile.h>
+
+/*
+ * V_WARN() - Overflow warnings, off by default.  V_WARN_STDERR prints them
+ * on stderr; V_WARN_SINK(fmt, ...), if defined, receives them instead.
+ * Either way each call site logs its first VS_DIAG_LIMIT warnings and then
+ * only counts (see diag.h).  A V_WARN defined by the caller is used as is.
+ */
 #ifdef V_WARN_STDERR
-#define V_WARN(fmt, ...) fprintf(stderr, fmt "\n", ##__VA_ARGS__)
+#include <vsuite/diag.h>
+#define V_WARN(fmt, ...) \
+    VS_DIAG_LIMITED(fmt, fprintf(stderr, fmt "\n", ##__VA_ARGS__))
+#elif defined(V_WARN_SINK) && !defined(V_WARN)
+#include <vsuite/diag.h>
+#define V_WARN(fmt, ...) VS_DIAG_LIMITED(fmt, V_WARN_SINK(fmt, ##__VA_ARGS__))
 #endif
 
 #ifndef V_WARN
 #define V_WARN(fmt, ...) /* */
 #endif
 
-size_t varchar_overflow = 0;
+#ifndef VSUITE_TLS
+#define VSUITE_TLS __thread
+#endif
+
+/*
+ * varchar_overflow - Bytes that did not fit in the last copy, cat or sprintf.
+ *
+ * Each thread and each translation unit has its own copy, so worker threads
+ * never share the cache line.  Every macro that sets it expands in the
+ * caller's translation unit, which is therefore the one that reads it back.
+ * Code that does not need the side channel should use the ``_st`` variants,
+ * which return a v_status_t and do not store anything.
+ */
+static VSUITE_TLS size_t varchar_overflow __attribute__((unused)) = 0;
+
+/*
+ * v_status_t - Result of the ``_st`` copy and concatenation variants.
+ * @bytes:    Number of bytes stored in the destination.
+ * @overflow: Number of source bytes that did not fit; zero when complete.
+ *
+ * Returned by value, so it normally stays in registers.
+ */
+typedef struct {
+    size_t bytes;
+    size_t overflow;
+} v_status_t;
+
+/*
+ * v_status_publish() - Record @st in ``varchar_overflow`` and yield its
+ * byte count.  Used by the classic macros that report through the global.
+ */
+#define v_status_publish(st)                                       \
+    ({                                                             \
+        v_status_t __st = (st);                                    \
+        varchar_overflow = __st.overflow;                          \
+        __st.bytes;                                                \
+    })
 
 /**
  * VARCHAR() - Declare a fixed-size Oracle style VARCHAR structure.
@@ -56,6 +107,23 @@ typedef VARCHAR(varchar_t, 1);
  */
 #define V_BUF(v)  ((v).arr)
 
+/*
+ * V_LEN() - Return ``len`` clamped to the capacity of a VARCHAR.
+ * @v: VARCHAR variable.
+ *
+ * The in-place kernels are bounded by this value, so a corrupt ``len`` can
+ * never take them past the end of ``arr``.
+ */
+#define V_LEN(v)  ((v).len <= V_SIZE(v) ? (size_t)(v).len : V_SIZE(v))
+
+/*
+ * V_COPY_CAP() - Compile-time bound on a copy between two VARCHARs.
+ *
+ * The smaller of the two declared sizes; vs_copy() uses it to pick the
+ * fixed-size move sequence for narrow fields.
+ */
+#define V_COPY_CAP(a, b)  (V_SIZE(a) < V_SIZE(b) ? V_SIZE(a) : V_SIZE(b))
+
 /*
  * v_has_capacity() - Test if @v can hold @N bytes.
  * @v:  VARCHAR variable being queried.
@@ -116,18 +184,25 @@ typedef VARCHAR(varchar_t, 1);
  * The number of bytes moved (after truncation) is returned and any overflow is
  * recorded in ``varchar_overflow``.
  */
-#define v_copy(dest, src)                                                  \
+#define v_copy(dest, src) \
+    v_status_publish(v_copy_st(dest, src))
+
+/* v_copy_st() - v_copy() reporting a v_status_t instead of varchar_overflow. */
+#define v_copy_st(dest, src)                                               \
     ({                                                                     \
-        varchar_overflow = 0;                                              \
+        VS_PROFILE_BEGIN("v_copy");                                        \
+        size_t __ovf = 0;                                                  \
         size_t __n = (src).len;                                            \
         if (__n > V_SIZE(dest)) {                                          \
-            varchar_overflow = __n - V_SIZE(dest);                         \
+            __ovf = __n - V_SIZE(dest);                                    \
             V_WARN("Line %d : v_copy(%s, %s) : overflow : bytes required %zu > %zu capacity", \
                 __LINE__, #dest, #src, __n, V_SIZE(dest));                 \
             __n = V_SIZE(dest);                                            \
         }                                                                  \
-        memmove(V_BUF(dest), V_BUF(src), __n);                             \
-        __n;                                                               \
+        VS_TELEMETRY("v_copy", V_SIZE(dest), __n + __ovf, __ovf);          \
+        vs_copy(V_BUF(dest), V_BUF(src), __n, V_COPY_CAP(dest, src));      \
+        VS_PROFILE_END();                                                  \
+        (v_status_t){ __n, __ovf };                                        \
     })
 
 /*
@@ -141,20 +216,27 @@ typedef VARCHAR(varchar_t, 1);
  * of bytes moved is returned.  ``dest.len`` remains unchanged and overflow is
  * reported via ``varchar_overflow``.
  */
-#define v_strncpy(dest, src, n)                                            \
+#define v_strncpy(dest, src, n) \
+    v_status_publish(v_strncpy_st(dest, src, n))
+
+/* v_strncpy_st() - v_strncpy() reporting a v_status_t instead of varchar_overflow. */
+#define v_strncpy_st(dest, src, n)                                         \
     ({                                                                     \
-        varchar_overflow = 0;                                              \
+        VS_PROFILE_BEGIN("v_strncpy");                                     \
+        size_t __ovf = 0;                                                  \
         size_t __n = (n);                                                  \
         if (__n > (src).len)                                               \
             __n = (src).len;                                               \
         if (__n > V_SIZE(dest)) {                                          \
-            varchar_overflow = __n - V_SIZE(dest);                         \
+            __ovf = __n - V_SIZE(dest);                                    \
             V_WARN("Line %d : v_strncpy(%s, %s, %u) : overflow : bytes required %zu > %zu capacity", \
                 __LINE__, #dest, #src, (n), __n, V_SIZE(dest));            \
             __n = V_SIZE(dest);                                            \
         }                                                                  \
-        memmove(V_BUF(dest), V_BUF(src), __n);                             \
-        __n;\
+        VS_TELEMETRY("v_strncpy", V_SIZE(dest), __n + __ovf, __ovf);       \
+        vs_copy(V_BUF(dest), V_BUF(src), __n, V_COPY_CAP(dest, src));      \
+        VS_PROFILE_END();                                                  \
+        (v_status_t){ __n, __ovf };                                        \
     })
 
 /*
@@ -167,20 +249,28 @@ typedef VARCHAR(varchar_t, 1);
  * resulting ``len`` is increased by the number of bytes appended and that value
  * is returned.  Overflow information is stored in ``varchar_overflow``.
  */
-#define v_strcat(dest, src)                                        \
+#define v_strcat(dest, src) \
+    ({ (int)v_status_publish(v_strcat_st(dest, src)); })
+
+/* v_strcat_st() - v_strcat() reporting a v_status_t instead of varchar_overflow. */
+#define v_strcat_st(dest, src)                                     \
     ({                                                             \
-        varchar_overflow = 0;                                      \
+        VS_PROFILE_BEGIN("v_strcat");                              \
+        size_t __ovf = 0;                                          \
         size_t __avail = v_unused_capacity(dest);                  \
         size_t __n = (src).len;                                    \
         if (__n > __avail) {                                       \
-            varchar_overflow = __n - __avail;                      \
+            __ovf = __n - __avail;                                 \
             V_WARN("Line %d : v_strcat(%s, %s) : overflow : bytes required %zu > %zu capacity", \
                     __LINE__, #dest, #src, __n, V_SIZE(dest));     \
             __n = __avail;                                         \
         }                                                          \
-        memmove(V_BUF(dest) + (dest).len, V_BUF(src), __n);        \
+        VS_TELEMETRY("v_strcat", V_SIZE(dest), (dest).len + __n + __ovf, __ovf); \
+        vs_copy(V_BUF(dest) + (dest).len, V_BUF(src), __n,         \
+                V_COPY_CAP(dest, src));                            \
         (dest).len += __n;                                         \
-        (int)__n;                                                  \
+        VS_PROFILE_END();                                          \
+        (v_status_t){ __n, __ovf };                                \
     })
 
 /*
@@ -191,82 +281,94 @@ typedef VARCHAR(varchar_t, 1);
  * length increases by the number of bytes appended which is also returned.  Any
  * truncation is noted in ``varchar_overflow``.
  */
-#define v_strncat(dest, src, n)                                    \
+#define v_strncat(dest, src, n) \
+    ({ (int)v_status_publish(v_strncat_st(dest, src, n)); })
+
+/* v_strncat_st() - v_strncat() reporting a v_status_t instead of varchar_overflow. */
+#define v_strncat_st(dest, src, n)                                 \
     ({                                                             \
-        varchar_overflow = 0;                                      \
+        VS_PROFILE_BEGIN("v_strncat");                             \
+        size_t __ovf = 0;                                          \
         size_t __avail = v_unused_capacity(dest);                  \
         size_t __n = (n);                                          \
         if (__n > (src).len)                                       \
             __n = (src).len;                                       \
         if (__n > __avail) {                                       \
-            varchar_overflow = __n - __avail;                      \
+            __ovf = __n - __avail;                                 \
             V_WARN("Line %d : v_strncat(%s, %s, %u) : overflow : bytes required %zu > %zu capacity", \
                 __LINE__, #dest, #src, (n), __n, V_SIZE(dest));    \
             __n = __avail;                                         \
         }                                                          \
-        memmove(V_BUF(dest) + (dest).len, V_BUF(src), __n);        \
+        VS_TELEMETRY("v_strncat", V_SIZE(dest), (dest).len + __n + __ovf, __ovf); \
+        vs_copy(V_BUF(dest) + (dest).len, V_BUF(src), __n,         \
+                V_COPY_CAP(dest, src));                            \
         (dest).len += __n;                                         \
-        (int)__n;                                                  \
+        VS_PROFILE_END();                                          \
+        (v_status_t){ __n, __ovf };                                \
     })
 
 /*
  * v_ltrim() - Remove leading ASCII whitespace from a VARCHAR.
  *
- * Characters are shifted left in-place using ``memmove`` when leading
- * whitespace is detected.  ``len`` is adjusted to reflect the new size.
+ * The first non-blank byte is located with vs_span_space() and the rest of
+ * the data is shifted left in-place using ``memmove``.  ``len`` is adjusted
+ * to reflect the new size.
  */
 #define v_ltrim(v) do {                                            \
-    size_t i = 0;                                                  \
-    while (i < (v).len && isspace((unsigned char)V_BUF(v)[i]))     \
-        i++;                                                       \
-    if (i > 0) {                                                   \
-        memmove(V_BUF(v), V_BUF(v) + i, (v).len - i);              \
-        (v).len -= i;                                              \
+    VS_PROFILE_BEGIN("v_ltrim");                                    \
+    size_t __i = (v).len ? vs_span_space(V_BUF(v), V_LEN(v)) : 0;   \
+    if (__i > 0) {                                                 \
+        memmove(V_BUF(v), V_BUF(v) + __i, V_LEN(v) - __i);          \
+        (v).len = V_LEN(v) - __i;                                  \
     }                                                              \
+    VS_PROFILE_END();                                              \
 } while (0)
 
 /*
  * v_rtrim() - Strip trailing ASCII whitespace from a VARCHAR.
  *
- * The length is decremented while whitespace characters are found at the end
- * of the buffer.  Content is left in place; only ``len`` changes.
+ * The last non-blank byte is located with vs_rspan_space().  Content is left
+ * in place; only ``len`` changes.
  */
 #define v_rtrim(v) do {                                            \
-    while ((v).len > 0 &&                                          \
-           isspace((unsigned char)V_BUF(v)[(v).len - 1])) {        \
-        (v).len--;                                                 \
-    }                                                              \
+    VS_PROFILE_BEGIN("v_rtrim");                                   \
+    if ((v).len > 0)                                               \
+        (v).len = vs_rspan_space(V_BUF(v), V_LEN(v));               \
+    VS_PROFILE_END();                                              \
 } while (0)
 
 /*
- * v_trim() - Convenience wrapper to run both v_rtrim() and v_ltrim().
+ * v_trim() - Remove leading and trailing whitespace in one pass.
  *
- * Leading and trailing whitespace are removed as described by the individual
- * helpers.
+ * The trailing blanks are found first and the leading scan is bounded by
+ * that end, so no byte is examined twice and the data is moved at most once.
  */
-#define v_trim(v)  \
-    do { v_rtrim(v); v_ltrim(v); } while (0)
+#define v_trim(v) do {                                             \
+    VS_PROFILE_BEGIN("v_trim");                                    \
+    if ((v).len > 0) {                                             \
+        size_t __end = vs_rspan_space(V_BUF(v), V_LEN(v));          \
+        size_t __i = vs_span_space(V_BUF(v), __end);               \
+        if (__i > 0)                                               \
+            memmove(V_BUF(v), V_BUF(v) + __i, __end - __i);        \
+        (v).len = __end - __i;                                     \
+    }                                                              \
+    VS_PROFILE_END();                                              \
+} while (0)
 
 /*
  * v_upper() - In-place ASCII uppercase conversion.
  *
- * Each byte is converted with ``toupper`` using unsigned char promotion.
+ * Converts 16 or 32 bytes per step with vs_upper().  Only ``'a'..'z'`` are
+ * changed; the current locale is not consulted.
  */
-#define v_upper(v) do {                                  \
-    for (size_t i = 0; i < (v).len; i++)                 \
-        V_BUF(v)[i] = toupper((unsigned char)V_BUF(v)[i]); \
-} while (0)
+#define v_upper(v) vs_upper(V_BUF(v), V_LEN(v))
 
 /*
  * v_lower() - In-place ASCII lowercase conversion.
  *
- * Like ``v_upper`` but using ``tolower``.
+ * Like ``v_upper`` but using vs_lower().
  */
-
-#define v_lower(v) do {                                  \
-    for (size_t i = 0; i < (v).len; i++)                 \
-        V_BUF(v)[i] = tolower((unsigned char)V_BUF(v)[i]); \
-} while (0)
+#define v_lower(v) vs_lower(V_BUF(v), V_LEN(v))
 
 /*
  * v_sprintf() - Print formatted data into a VARCHAR.
@@ -321,12 +423,16 @@ static inline int v_sprintf_fcn(char *dst_buf, size_t capacity,
 
 #define v_sprintf(v, fmt, ...) \
     ({ \
+        VS_PROFILE_BEGIN("v_sprintf"); \
         size_t capacity = V_SIZE(v); \
         int n = v_sprintf_fcn(V_BUF(v), capacity, &(v).len, fmt, ##__VA_ARGS__); \
         if (varchar_overflow > 0) { \
             V_WARN("Line %d : v_sprintf(%s, fmt, ...) : overflow : bytes required %zu > %zu capacity : fmt = \"%s\"", \
                 __LINE__, #v, varchar_overflow+capacity, capacity, fmt); \
         } \
+        VS_TELEMETRY("v_sprintf", V_SIZE(v), n < 0 ? 0 : n + varchar_overflow + 1, \
+                     varchar_overflow); \
+        VS_PROFILE_END(); \
         n; \
     })
 
@@ -6,6 +6,7 @@
 #include <ctype.h>
 
 #include <vsuite/varchar.h>
+#include <vsuite/simd.h>
 
 /*
  * ZV_CAPACITY() - Number of bytes usable for data in a zero-terminated VARCHAR.
@@ -34,6 +35,7 @@
  */
 #define zv_setlenz(v) \
     do { \
+        VS_PROFILE_BEGIN("zv_setlenz"); \
         if ( !v_valid(v)) { \
             V_WARN("Line %d : VARCHAR_SETLENZ:  %s : length %u exceeds allocated size %zu : truncating to actual size\n\n", \
                 __LINE__, #v, (v).len, sizeof((v).arr)); \
@@ -48,6 +50,7 @@
             } \
         } \
         V_BUF(v)[(v).len] = '\0'; \
+        VS_PROFILE_END(); \
     } while (0)
 
 #define zv_zero_terminate(v) zv_setlenz(v)
@@ -58,19 +61,10 @@
  * @max_len: Maximum number of bytes to examine.
  *
  * Returns a pointer to the first ``'\0'`` within the given range or ``NULL``
- * when none is present.
- */
-#define FIND_FIRST_NUL_BYTE(arr,max_len)       \
-    ({                                         \
-        char * found = NULL;                   \
-        for (size_t i = 0; i < max_len; ++i) { \
-            if (arr[i] == '\0') {              \
-                found = arr + i;               \
-                break;                         \
-            }                                  \
-        }                                      \
-        found;                                 \
-    })
+ * when none is present.  The scan is done by vs_find_nul() which compares
+ * 16 or 32 bytes per step and never reads past ``max_len``.
+ */
+#define FIND_FIRST_NUL_BYTE(arr,max_len) vs_find_nul((arr), (max_len))
 
 /*
  * zv_zsetlen() - Determine the length of a NUL terminated VARCHAR.
@@ -85,6 +79,7 @@
  */
 #define zv_zsetlen(v) \
     { \
+        VS_PROFILE_BEGIN("zv_zsetlen"); \
         unsigned siz = sizeof((v).arr); \
         char *nul = FIND_FIRST_NUL_BYTE((v).arr, siz); \
         if (nul == NULL) { \
@@ -94,6 +89,7 @@
         } \
         (v).len = (unsigned short)((unsigned long)nul - (unsigned long)(v).arr); \
         (v).arr[(v).len] = '\0'; \
+        VS_PROFILE_END(); \
     }
 
 /*
@@ -119,76 +115,103 @@
  * too small it is truncated to leave space for the terminator and zero is
  * returned.
  */
-#define zv_copy(dest, src)                                          \
+#define zv_copy(dest, src) \
+    v_status_publish(zv_copy_st(dest, src))
+
+/* zv_copy_st() - zv_copy() reporting a v_status_t instead of varchar_overflow. */
+#define zv_copy_st(dest, src)                                       \
     ({                                                              \
-        varchar_overflow = 0;                                       \
+        VS_PROFILE_BEGIN("zv_copy");                                \
+        size_t __ovf = 0;                                           \
         size_t __cap = ZV_CAPACITY(dest);                           \
         size_t __n = (src).len;                                     \
         if (__n > __cap) {                                          \
-            varchar_overflow = __n - __cap;                         \
+            __ovf = __n - __cap;                                    \
             V_WARN("Line %d : zv_copy(%s, %s) : overflow : bytes required %zu > %zu capacity", \
                   __LINE__, #dest, #src, __n, V_SIZE(dest));        \
             __n = __cap;                                            \
         }                                                           \
-        memmove(V_BUF(dest), V_BUF(src), __n);                      \
+        VS_TELEMETRY("zv_copy", V_SIZE(dest), __n + __ovf + 1, __ovf); \
+        vs_copy(V_BUF(dest), V_BUF(src), __n, V_COPY_CAP(dest, src)); \
         (dest).len = __n;                                           \
         if (V_SIZE(dest) > 0)                                       \
             V_BUF(dest)[__n] = '\0';                                \
-        __n;                                                        \
+        VS_PROFILE_END();                                           \
+        (v_status_t){ __n, __ovf };                                 \
     })
 
 /*
  * zv_strncpy() - Copy at most n characters and ensure termination.
  */
-#define zv_strncpy(dest, src, n)                                   \
+#define zv_strncpy(dest, src, n) \
+    ({ (int)v_status_publish(zv_strncpy_st(dest, src, n)); })
+
+/* zv_strncpy_st() - zv_strncpy() reporting a v_status_t instead of varchar_overflow. */
+#define zv_strncpy_st(dest, src, n)                                \
     ({                                                             \
-        varchar_overflow = 0;                                      \
+        VS_PROFILE_BEGIN("zv_strncpy");                            \
+        size_t __ovf = 0;                                          \
         size_t __cap = ZV_CAPACITY(dest);                          \
         size_t __n = (n);                                          \
         if (__n > (src).len)                                       \
             __n = (src).len;                                       \
         if (__n > __cap) {                                         \
-            varchar_overflow = __n - __cap;                        \
+            __ovf = __n - __cap;                                   \
             V_WARN("Line %d : zv_strncpy(%s, %s, %u) : overflow : bytes required %zu > %zu capacity", \
                    __LINE__, #dest, #src, (unsigned)(n), __n, V_SIZE(dest)); \
             __n = __cap;                                           \
         }                                                          \
-        memmove(V_BUF(dest), V_BUF(src), __n);                     \
+        VS_TELEMETRY("zv_strncpy", V_SIZE(dest), __n + __ovf + 1, __ovf); \
+        vs_copy(V_BUF(dest), V_BUF(src), __n, V_COPY_CAP(dest, src)); \
         (dest).len = __n;                                          \
         if (V_SIZE(dest) > 0)                                      \
             V_BUF(dest)[__n] = '\0';                               \
-        (int)__n;                                                  \
+        VS_PROFILE_END();                                          \
+        (v_status_t){ __n, __ovf };                                \
     })
 
 /*
  * zv_strcat() - Append src to dest with preserved terminator.
  */
-#define zv_strcat(dest, src)                                      \
+#define zv_strcat(dest, src) \
+    ({ (int)v_status_publish(zv_strcat_st(dest, src)); })
+
+/* zv_strcat_st() - zv_strcat() reporting a v_status_t instead of varchar_overflow. */
+#define zv_strcat_st(dest, src)                                   \
     ({                                                            \
-        varchar_overflow = 0;                                     \
+        VS_PROFILE_BEGIN("zv_strcat");                            \
+        size_t __ovf = 0;                                         \
         size_t __avail = (V_SIZE(dest) > (dest).len)              \
                             ? V_SIZE(dest) - 1 - (dest).len       \
                             : 0;                                  \
         size_t __n = (src).len;                                   \
         if (__n > __avail) {                                      \
-            varchar_overflow = __n - __avail;                     \
+            __ovf = __n - __avail;                                \
             V_WARN("Line %d : zv_strcat(%s, %s) : overflow : bytes required %zu > %zu capacity", \
                    __LINE__, #dest, #src, __n, V_SIZE(dest));     \
             __n = __avail;                                        \
         }                                                         \
-        memmove(V_BUF(dest) + (dest).len, V_BUF(src), __n);       \
+        VS_TELEMETRY("zv_strcat", V_SIZE(dest), (dest).len + __n + __ovf + 1, __ovf); \
+        vs_copy(V_BUF(dest) + (dest).len, V_BUF(src), __n,        \
+                V_COPY_CAP(dest, src));                           \
         (dest).len += __n;                                        \
-        if (V_SIZE(dest) > 0)                                     \
+        if ((dest).len < V_SIZE(dest))                            \
             V_BUF(dest)[(dest).len] = '\0';                       \
-        (int)__n;                                                 \
+        VS_PROFILE_END();                                         \
+        (v_status_t){ __n, __ovf };                               \
     })
 
 /*
  * zv_strncat() - Append at most n characters from src to dest and terminate.
  */
-#define zv_strncat(dest, src, n)                                   \
+#define zv_strncat(dest, src, n) \
+    ({ (int)v_status_publish(zv_strncat_st(dest, src, n)); })
+
+/* zv_strncat_st() - zv_strncat() reporting a v_status_t instead of varchar_overflow. */
+#define zv_strncat_st(dest, src, n)                                \
     ({                                                             \
-        varchar_overflow = 0;                                      \
+        VS_PROFILE_BEGIN("zv_strncat");                            \
+        size_t __ovf = 0;                                          \
         size_t __avail = (V_SIZE(dest) > (dest).len)               \
                             ? V_SIZE(dest) - 1 - (dest).len        \
                             : 0;                                   \
@@ -196,16 +219,19 @@
         if (__n > (src).len)                                       \
             __n = (src).len;                                       \
         if (__n > __avail) {                                       \
-            varchar_overflow = __n - __avail;                      \
+            __ovf = __n - __avail;                                 \
             V_WARN("Line %d : zv_strncat(%s, %s, %u) : overflow : bytes required %zu > %zu capacity", \
                    __LINE__, #dest, #src, (unsigned)(n), __n, V_SIZE(dest)); \
             __n = __avail;                                         \
         }                                                          \
-        memmove(V_BUF(dest) + (dest).len, V_BUF(src), __n);        \
+        VS_TELEMETRY("zv_strncat", V_SIZE(dest), (dest).len + __n + __ovf + 1, __ovf); \
+        vs_copy(V_BUF(dest) + (dest).len, V_BUF(src), __n,         \
+                V_COPY_CAP(dest, src));                            \
         (dest).len += __n;                                         \
-        if (V_SIZE(dest) > 0)                                      \
+        if ((dest).len < V_SIZE(dest))                             \
             V_BUF(dest)[(dest).len] = '\0';                        \
-        (int)__n;                                                  \
+        VS_PROFILE_END();                                          \
+        (v_status_t){ __n, __ovf };                                \
     })
 
 /*
@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "vsuite/arena.h"
+
+static int failures = 0;
+static int verbose = 0;
+
+/*
+ * CHECK_MSG() - Provide additional failure context.
+ * @name: Test name displayed on failure.
+ * @expr: Boolean expression indicating success.
+ * @fmt:  printf style format string used when @expr evaluates to false.
+ * @...: Values referenced by @fmt when reporting a failure.
+ */
+#define CHECK_MSG(name, expr, fmt, ...) do { \
+    if (!(expr)) { \
+        printf("\nFAIL: %s - " fmt "\n", name, ##__VA_ARGS__); \
+        failures++; \
+    } else if (verbose) { \
+        printf("PASS: %s\n", name); \
+    } else { \
+        fputc('.', stdout); fflush(stdout); \
+    } \
+} while (0)
+
+static void test_dup(void) {
+    vs_arena_t *a = vs_arena_create(64);
+    VARCHAR(v, 10);
+    memcpy(v.arr, "hello!!!!!", 10);
+    v.len = 5;
+    char *s = dv_arena_dup(a, v);
+    char *t = dp_arena_dup(a, "world");
+    CHECK_MSG("dv_arena_dup", s && strcmp(s, "hello") == 0, "got %s", s);
+    CHECK_MSG("dp_arena_dup", t && strcmp(t, "world") == 0 && t == s + 6,
+              "got %s", t);
+    CHECK_MSG("vs_arena_used", vs_arena_used(a) == 12, "used=%zu",
+              vs_arena_used(a));
+
+    v.len = 60;                         /* corrupt: clamped to V_SIZE */
+    s = dv_arena_dup(a, v);
+    CHECK_MSG("dv_arena_dup clamp", s && strlen(s) == 10, "len=%zu",
+              s ? strlen(s) : 0);
+    vs_arena_destroy(a);
+}
+
+static void test_alloc_align(void) {
+    vs_arena_t *a = vs_arena_create(256);
+    int ok = 1;
+    (void)vs_arena_strndup(a, "x", 1);
+    for (int i = 0; i < 10 && ok; i++) {
+        char *p = vs_arena_alloc(a, (size_t)i * 3 + 1);
+        ok = p && ((uintptr_t)p % VS_ARENA_ALIGN) == 0;
+        (void)vs_arena_strndup(a, "abc", i % 4);
+    }
+    CHECK_MSG("vs_arena_alloc align", ok, "misaligned block");
+    vs_arena_destroy(a);
+}
+
+/* Overflowing the first chunk chains more; reset folds them into one. */
+static void test_grow_reset(void) {
+    vs_arena_t *a = vs_arena_create(32);
+    char *p[20];
+    int ok = 1;
+    for (int i = 0; i < 20; i++) {
+        char buf[16];
+        snprintf(buf, sizeof buf, "row-%02d", i);
+        p[i] = dp_arena_dup(a, buf);
+    }
+    for (int i = 0; i < 20 && ok; i++) {
+        char buf[16];
+        snprintf(buf, sizeof buf, "row-%02d", i);
+        ok = p[i] && strcmp(p[i], buf) == 0;
+    }
+    CHECK_MSG("arena grow", ok && a->head->next != NULL &&
+              vs_arena_used(a) == 140, "used=%zu", vs_arena_used(a));
+
+    char *big = vs_arena_alloc(a, 1000);
+    CHECK_MSG("arena large block", big != NULL && a->head->size >= 1000,
+              "size=%zu", a->head->size);
+    memset(big, 'b', 1000);
+
+    size_t hw = vs_arena_high_water(a);
+    vs_arena_reset(a);
+    CHECK_MSG("arena reset", vs_arena_used(a) == 0 && a->head &&
+              a->head->next == NULL && a->head->size >= hw && hw == 1155,
+              "hw=%zu size=%zu", hw, a->head ? a->head->size : 0);
+
+    /* The same batch now fits the single chunk. */
+    vs_arena_chunk_t *first = a->head;
+    for (int i = 0; i < 20; i++)
+        (void)dp_arena_dup(a, "row-00");
+    (void)vs_arena_alloc(a, 1000);
+    CHECK_MSG("arena steady state", a->head == first &&
+              vs_arena_high_water(a) == hw, "hw=%zu", vs_arena_high_water(a));
+
+    vs_arena_reset(a);
+    CHECK_MSG("arena reset reuse", a->head == first && a->ptr == first->data,
+              "chunk replaced");
+    vs_arena_destroy(a);
+    vs_arena_destroy(NULL);
+}
+
+int main(int argc, char **argv) {
+    for (int i=1;i<argc;i++)
+        verbose |= (!strcmp(argv[i], "-v") || !strcmp(argv[i], "--verbose"));
+
+    test_dup();
+    test_alloc_align();
+    test_grow_reset();
+
+    if (failures == 0)
+        printf(verbose ? "\nAll tests passed.\n" : "\n");
+    else
+        printf("\n%d test(s) failed.\n", failures);
+    return failures;
+}
@@ -0,0 +1,238 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "vsuite/batch.h"
+#include "vsuite/zvarchar.h"
+
+static int failures = 0;
+static int verbose = 0;
+
+/*
+ * CHECK_MSG() - Provide additional failure context.
+ * @name: Test name displayed on failure.
+ * @expr: Boolean expression indicating success.
+ * @fmt:  printf style format string used when @expr evaluates to false.
+ * @...: Values referenced by @fmt when reporting a failure.
+ */
+#define CHECK_MSG(name, expr, fmt, ...) do { \
+    if (!(expr)) { \
+        printf("\nFAIL: %s - " fmt "\n", name, ##__VA_ARGS__); \
+        failures++; \
+    } else if (verbose) { \
+        printf("PASS: %s\n", name); \
+    } else { \
+        fputc('.', stdout); fflush(stdout); \
+    } \
+} while (0)
+
+enum { ROWS = 1000 };
+
+/* A fetched CHAR(20) column: values of varying width, blank padded. */
+static void fill_rows(size_t n, char (*row)[21], size_t *width) {
+    for (size_t i = 0; i < n; i++) {
+        width[i] = i % 21;
+        memset(row[i], ' ', 20);
+        for (size_t k = 0; k < width[i]; k++)
+            row[i][k] = "abcdefghij"[(i + k) % 10];
+        row[i][20] = '\0';
+    }
+}
+
+/* vb_zsetlen must agree with zv_zsetlen applied row by row. */
+static void test_zsetlen(void) {
+    static VARCHAR(rows[ROWS], 8);
+    int ok = 1;
+    size_t bad_i = 0;
+    for (size_t i = 0; i < ROWS; i++) {
+        memset(rows[i].arr, 'x', 8);
+        rows[i].arr[i % 8] = '\0';
+        rows[i].len = 999;
+    }
+    size_t bad = vb_zsetlen(rows, ROWS);
+    for (size_t i = 0; i < ROWS && ok; i++)
+        if (rows[i].len != i % 8) { ok = 0; bad_i = i; }
+    CHECK_MSG("vb_zsetlen lengths", ok && bad == 0,
+              "row %zu len=%u bad=%zu", bad_i, rows[bad_i].len, bad);
+
+    memset(rows[3].arr, 'y', 8);
+    memset(rows[9].arr, 'y', 8);
+    bad = vb_zsetlen(rows, 10);
+    CHECK_MSG("vb_zsetlen unterminated", bad == 2 && rows[3].len == 7 &&
+              rows[3].arr[7] == '\0' && rows[9].len == 7,
+              "bad=%zu len3=%u len9=%u", bad, rows[3].len, rows[9].len);
+}
+
+/* Only the first @count elements are touched. */
+static void test_count(void) {
+    VARCHAR(rows[4], 6);
+    for (size_t i = 0; i < 4; i++) {
+        memcpy(rows[i].arr, "ab  \0", 6);
+        rows[i].len = 4;
+    }
+    vb_rtrim(rows, 3);
+    vb_upper(rows, 3);
+    CHECK_MSG("vb_ count", rows[2].len == 2 && rows[3].len == 4 &&
+              memcmp(rows[2].arr, "AB", 2) == 0 &&
+              memcmp(rows[3].arr, "ab", 2) == 0,
+              "len2=%u len3=%u", rows[2].len, rows[3].len);
+    vb_zsetlen(rows, 0);
+    CHECK_MSG("vb_ zero count", rows[0].len == 2, "len=%u", rows[0].len);
+}
+
+static void test_rtrim_upper(void) {
+    static VARCHAR(rows[ROWS], 21);
+    static char raw[ROWS][21];
+    static size_t width[ROWS];
+    fill_rows(ROWS, raw, width);
+    for (size_t i = 0; i < ROWS; i++) {
+        memcpy(rows[i].arr, raw[i], 21);
+        rows[i].len = 20;
+    }
+    vb_rtrim(rows, ROWS);
+    vb_upper(rows, ROWS);
+    int ok = 1;
+    size_t bad_i = 0;
+    for (size_t i = 0; i < ROWS && ok; i++) {
+        if (rows[i].len != width[i]) { ok = 0; bad_i = i; }
+        for (size_t k = 0; k < width[i] && ok; k++)
+            if (rows[i].arr[k] != raw[i][k] - 32) { ok = 0; bad_i = i; }
+    }
+    CHECK_MSG("vb_rtrim/vb_upper", ok, "row %zu len=%u want %zu", bad_i,
+              rows[bad_i].len, width[bad_i]);
+
+    vb_lower(rows, ROWS);
+    CHECK_MSG("vb_lower", memcmp(rows[ROWS - 1].arr, raw[ROWS - 1],
+                                 width[ROWS - 1]) == 0, "row not lowered");
+}
+
+static void test_setlenz(void) {
+    VARCHAR(rows[5], 4);
+    for (size_t i = 0; i < 5; i++) {
+        memset(rows[i].arr, 'q', 4);
+        rows[i].len = (unsigned short)i;
+    }
+    rows[3].len = 4;                    /* no room for the terminator */
+    rows[4].len = 60;
+    size_t bad = vb_setlenz(rows, 5);
+    CHECK_MSG("vb_setlenz", bad == 2 && rows[1].len == 1 &&
+              rows[1].arr[1] == '\0' && rows[3].len == 3 &&
+              rows[4].len == 3 && rows[4].arr[3] == '\0',
+              "bad=%zu len3=%u len4=%u", bad, rows[3].len, rows[4].len);
+}
+
+static void test_valid(void) {
+    VARCHAR(rows[6], 4);
+    for (size_t i = 0; i < 6; i++)
+        rows[i].len = 4;
+    CHECK_MSG("vb_valid all", vb_valid(rows, 6) == 6, "got %zu",
+              vb_valid(rows, 6));
+    rows[4].len = 5;
+    CHECK_MSG("vb_valid first", vb_valid(rows, 6) == 4, "got %zu",
+              vb_valid(rows, 6));
+    CHECK_MSG("vb_valid count", vb_valid(rows, 3) == 3, "got %zu",
+              vb_valid(rows, 3));
+}
+
+/* Column copy sets each len and totals the truncated bytes. */
+static void test_copy_column(void) {
+    static VARCHAR(src[ROWS], 21);
+    static VARCHAR(dst[ROWS], 6);
+    static char raw[ROWS][21];
+    static size_t width[ROWS];
+    fill_rows(ROWS, raw, width);
+    size_t want_bytes = 0, want_ovf = 0;
+    for (size_t i = 0; i < ROWS; i++) {
+        memcpy(src[i].arr, raw[i], 21);
+        src[i].len = (unsigned short)width[i];
+        want_bytes += width[i] < 6 ? width[i] : 6;
+        want_ovf += width[i] > 6 ? width[i] - 6 : 0;
+    }
+    v_status_t st = vb_copy_st(dst, src, ROWS);
+    int ok = st.bytes == want_bytes && st.overflow == want_ovf;
+    size_t bad_i = 0;
+    for (size_t i = 0; i < ROWS && ok; i++) {
+        size_t n = width[i] < 6 ? width[i] : 6;
+        if (dst[i].len != n || memcmp(dst[i].arr, raw[i], n) != 0) {
+            ok = 0; bad_i = i;
+        }
+    }
+    CHECK_MSG("vb_copy_st", ok, "bytes=%zu/%zu overflow=%zu/%zu row %zu",
+              st.bytes, want_bytes, st.overflow, want_ovf, bad_i);
+
+    size_t n = vb_copy(src, dst, ROWS);
+    CHECK_MSG("vb_copy publish", n == want_bytes && varchar_overflow == 0 &&
+              src[7].len == 6, "n=%zu overflow=%zu", n, varchar_overflow);
+}
+
+/*
+ * Every count up to 40 at widths on both sides of the single-load limits,
+ * against the per-row macros.  Short counts leave no room for the wide
+ * loads, so this also covers the switch to the bounded tail kernels.
+ */
+#define CHECK_WIDTH(N)                                                        \
+static int check_width_##N(void) {                                           \
+    VARCHAR(a[40], N); VARCHAR(b[40], N);                                     \
+    for (size_t cnt = 0; cnt <= 40; cnt++) {                                  \
+        for (size_t i = 0; i < 40; i++) {                                     \
+            for (size_t k = 0; k < N; k++)                                    \
+                a[i].arr[k] = " aZ\tq "[(i * 3 + k) % 7];                     \
+            if ((i * 5) % (N + 2) < N)                                        \
+                a[i].arr[(i * 5) % (N + 2)] = '\0';                           \
+            a[i].len = (unsigned short)((i * 11) % (N + 3));                  \
+        }                                                                     \
+        memcpy(b, a, sizeof a);                                               \
+        vb_zsetlen(a, cnt);                                                   \
+        for (size_t i = 0; i < cnt; i++) zv_zsetlen(b[i]);                    \
+        if (memcmp(a, b, sizeof a)) return 1;                                 \
+        for (size_t i = 0; i < 40; i++)                                       \
+            a[i].len = b[i].len = (unsigned short)((i * 7) % (N + 1));        \
+        vb_upper(a, cnt);                                                     \
+        for (size_t i = 0; i < cnt; i++) v_upper(b[i]);                       \
+        if (memcmp(a, b, sizeof a)) return 2;                                 \
+        vb_rtrim(a, cnt);                                                     \
+        for (size_t i = 0; i < cnt; i++) v_rtrim(b[i]);                       \
+        if (memcmp(a, b, sizeof a)) return 3;                                 \
+        vb_lower(a, cnt);                                                     \
+        for (size_t i = 0; i < cnt; i++) v_lower(b[i]);                       \
+        if (memcmp(a, b, sizeof a)) return 4;                                 \
+    }                                                                         \
+    return 0;                                                                 \
+}
+
+CHECK_WIDTH(1)
+CHECK_WIDTH(3)
+CHECK_WIDTH(7)
+CHECK_WIDTH(8)
+CHECK_WIDTH(15)
+CHECK_WIDTH(16)
+CHECK_WIDTH(17)
+CHECK_WIDTH(40)
+
+static void test_widths(void) {
+    int r;
+#define RUN_WIDTH(N) \
+    r = check_width_##N(); \
+    CHECK_MSG("vb_ width " #N, r == 0, "step %d differs from per-row macro", r);
+    RUN_WIDTH(1) RUN_WIDTH(3) RUN_WIDTH(7) RUN_WIDTH(8)
+    RUN_WIDTH(15) RUN_WIDTH(16) RUN_WIDTH(17) RUN_WIDTH(40)
+#undef RUN_WIDTH
+}
+
+int main(int argc, char **argv) {
+    for (int i=1;i<argc;i++)
+        verbose |= (!strcmp(argv[i], "-v") || !strcmp(argv[i], "--verbose"));
+
+    test_zsetlen();
+    test_count();
+    test_rtrim_upper();
+    test_setlenz();
+    test_valid();
+    test_copy_column();
+    test_widths();
+
+    if (failures == 0)
+        printf(verbose ? "\nAll tests passed.\n" : "\n");
+    else
+        printf("\n%d test(s) failed.\n", failures);
+    return failures;
+}
@@ -0,0 +1,124 @@
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+#include "vsuite/builder.h"
+
+static int failures = 0;
+static int verbose = 0;
+
+/*
+ * CHECK_MSG() - Provide additional failure context.
+ * @name: Test name displayed on failure.
+ * @expr: Boolean expression indicating success.
+ * @fmt:  printf style format string used when @expr evaluates to false.
+ * @...: Values referenced by @fmt when reporting a failure.
+ */
+#define CHECK_MSG(name, expr, fmt, ...) do { \
+    if (!(expr)) { \
+        printf("\nFAIL: %s - " fmt "\n", name, ##__VA_ARGS__); \
+        failures++; \
+    } else if (verbose) { \
+        printf("PASS: %s\n", name); \
+    } else { \
+        fputc('.', stdout); fflush(stdout); \
+    } \
+} while (0)
+
+#define SET(v, s) do { (v).len = (unsigned short)strlen(s); memcpy((v).arr, s, (v).len); } while (0)
+
+/* A chain of every kind of append matches the snprintf equivalent. */
+static void test_chain(void) {
+    VARCHAR(desc, 64);
+    VARCHAR(vendor, 10);
+    char want[80];
+    SET(vendor, "V1042");
+    varchar_overflow = 99;
+    v_builder_t b = v_build_begin(desc);
+    v_build_lit(&b, "AP ");
+    v_build_v(&b, vendor);
+    v_build_char(&b, '/');
+    v_build_int_pad(&b, 7, 4);
+    v_build_char(&b, ' ');
+    v_build_str(&b, "inv");
+    v_build_int(&b, -12);
+    v_build_char(&b, ' ');
+    v_build_uint(&b, ULLONG_MAX);
+    v_build_char(&b, ' ');
+    v_build_decimal(&b, 44090, 2);
+    v_build_mem(&b, "xyz", 2);
+    size_t n = v_build_end(desc, &b);
+    snprintf(want, sizeof want, "AP V1042/0007 inv-12 %llu 440.90xy", ULLONG_MAX);
+    CHECK_MSG("v_build chain", n == strlen(want) && desc.len == n &&
+              varchar_overflow == 0 && memcmp(desc.arr, want, n) == 0,
+              "got '%.*s'", (int)desc.len, desc.arr);
+}
+
+/* Overflow is counted over the whole chain and reported once. */
+static void test_overflow(void) {
+    VARCHAR(v, 8);
+    VARCHAR(src, 6);
+    SET(src, "abcdef");
+    memset(v.arr, '#', sizeof v.arr);
+    v_builder_t b = v_build_begin(v);
+    v_build_v(&b, src);
+    v_build_int(&b, 12345);
+    v_build_char(&b, '!');
+    v_build_lit(&b, "tail");
+    size_t n = v_build_end(v, &b);
+    CHECK_MSG("v_build overflow", n == 8 && v.len == 8 &&
+              varchar_overflow == 8 && memcmp(v.arr, "abcdef12", 8) == 0,
+              "n=%zu overflow=%zu '%.*s'", n, varchar_overflow, (int)v.len,
+              v.arr);
+
+    b = v_build_begin(v);
+    v_build_lit(&b, "ok");
+    v_status_t st = v_build_end_st(v, &b);
+    CHECK_MSG("v_build_end_st", st.bytes == 2 && st.overflow == 0 && v.len == 2,
+              "bytes=%zu overflow=%zu", st.bytes, st.overflow);
+}
+
+static void test_continue(void) {
+    VARCHAR(v, 10);
+    SET(v, "key:");
+    v_builder_t b = v_build_continue(v);
+    v_build_int(&b, 42);
+    v_build_end(v, &b);
+    CHECK_MSG("v_build_continue", v.len == 6 && memcmp(v.arr, "key:42", 6) == 0,
+              "got '%.*s'", (int)v.len, v.arr);
+}
+
+/* The zv form keeps a byte for the terminator and writes it at the end. */
+static void test_zv(void) {
+    VARCHAR(z, 6);
+    memset(z.arr, '#', sizeof z.arr);
+    v_builder_t b = zv_build_begin(z);
+    v_build_lit(&b, "ab");
+    v_build_int(&b, 123);
+    size_t n = zv_build_end(z, &b);
+    CHECK_MSG("zv_build", n == 5 && z.len == 5 && varchar_overflow == 0 &&
+              strcmp(z.arr, "ab123") == 0, "n=%zu", n);
+
+    b = zv_build_continue(z);
+    v_build_lit(&b, "xyz");
+    n = zv_build_end(z, &b);
+    CHECK_MSG("zv_build overflow", n == 5 && varchar_overflow == 3 &&
+              strcmp(z.arr, "ab123") == 0, "n=%zu overflow=%zu", n,
+              varchar_overflow);
+}
+
+int main(int argc, char **argv) {
+    for (int i=1;i<argc;i++)
+        verbose |= (!strcmp(argv[i], "-v") || !strcmp(argv[i], "--verbose"));
+
+    test_chain();
+    test_overflow();
+    test_continue();
+    test_zv();
+
+    if (failures == 0)
+        printf(verbose ? "\nAll tests passed.\n" : "\n");
+    else
+        printf("\n%d test(s) failed.\n", failures);
+    return failures;
+}
@@ -0,0 +1,135 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vsuite/charset.h"
+#include "vsuite/zvarchar.h"
+
+static int failures = 0;
+static int verbose = 0;
+
+/*
+ * CHECK_MSG() - Provide additional failure context.
+ * @name: Test name displayed on failure.
+ * @expr: Boolean expression indicating success.
+ * @fmt:  printf style format string used when @expr evaluates to false.
+ * @...: Values referenced by @fmt when reporting a failure.
+ */
+#define CHECK_MSG(name, expr, fmt, ...) do { \
+    if (!(expr)) { \
+        printf("\nFAIL: %s - " fmt "\n", name, ##__VA_ARGS__); \
+        failures++; \
+    } else if (verbose) { \
+        printf("PASS: %s\n", name); \
+    } else { \
+        fputc('.', stdout); fflush(stdout); \
+    } \
+} while (0)
+
+#define SET(v, s) do { (v).len = (unsigned short)strlen(s); memcpy((v).arr, s, (v).len); } while (0)
+
+static void test_charset(void) {
+    vs_charset_t cs = vs_charset("09 \x80\xff");
+    int ok = 1;
+    for (int c = 0; c < 256; c++) {
+        int want = c == '0' || c == '9' || c == ' ' || c == 0x80 || c == 0xff;
+        ok = ok && vs_charset_has(&cs, (unsigned char)c) == want;
+    }
+    CHECK_MSG("vs_charset", ok, "wrong membership");
+
+    VARCHAR(set, 8);
+    set.len = 2;
+    set.arr[0] = '\0';
+    set.arr[1] = '|';
+    cs = v_charset(set);
+    CHECK_MSG("v_charset nul", vs_charset_has(&cs, '\0') &&
+              vs_charset_has(&cs, '|') && !vs_charset_has(&cs, 'a'),
+              "NUL not taken from the VARCHAR");
+}
+
+static void test_span(void) {
+    VARCHAR(v, 64);
+    vs_charset_t digits = vs_charset("0123456789");
+    vs_charset_t delims = vs_charset("|,;");
+    SET(v, "004512|ACME, INC;X");
+    v.arr[v.len] = '7';                 /* past len: must not be counted */
+    CHECK_MSG("v_strspn", v_strspn(v, &digits) == 6, "got %zu",
+              v_strspn(v, &digits));
+    CHECK_MSG("v_strcspn", v_strcspn(v, &delims) == 6, "got %zu",
+              v_strcspn(v, &delims));
+    CHECK_MSG("v_strpbrk", v_strpbrk(v, &delims) == 6, "got %ld",
+              v_strpbrk(v, &delims));
+    v.len = 5;
+    CHECK_MSG("v_strspn bounded", v_strspn(v, &digits) == 5 &&
+              v_strcspn(v, &delims) == 5 && v_strpbrk(v, &delims) == -1,
+              "scanned past len");
+    v.len = 0;
+    CHECK_MSG("v_strspn empty", v_strspn(v, &digits) == 0 &&
+              v_strpbrk(v, &delims) == -1, "nonzero span of nothing");
+
+    VARCHAR(z, 40);
+    SET(z, "  GL-0100 ");
+    zv_setlenz(z);
+    vs_charset_t blanks = vs_charset(" \t");
+    CHECK_MSG("zv_strspn", zv_strspn(z, &blanks) == 2 &&
+              zv_strcspn(z, &digits) == 5 && zv_strpbrk(z, &digits) == 5,
+              "got %zu", zv_strspn(z, &blanks));
+
+    char f[16] = "12AB";
+    memcpy(f + 5, "999", 3);            /* past the terminator */
+    CHECK_MSG("s_strspn", s_strspn(f, &digits) == 2 &&
+              s_strcspn(f, &digits) == 0 && s_strpbrk(f, &blanks) == -1,
+              "got %zu", s_strspn(f, &digits));
+    char full[4] = { '1', '2', '3', '4' };     /* no terminator */
+    CHECK_MSG("s_strspn full", s_strspn(full, &digits) == 4 &&
+              s_strcspn(full, &blanks) == 4, "read past S_SIZE");
+}
+
+/* Random data and sets, every length through the scalar and vector paths. */
+static void test_span_random(void) {
+    unsigned char buf[200], set[32];
+    unsigned seed = 4242;
+    int ok = 1;
+    for (int iter = 0; iter < 4000 && ok; iter++) {
+        seed = seed * 1103515245u + 12345u;
+        size_t setn = 1 + (seed >> 16) % 20;
+        for (size_t i = 0; i < setn; i++) {
+            seed = seed * 1103515245u + 12345u;
+            set[i] = (unsigned char)(seed >> 16);
+        }
+        vs_charset_t cs = vs_charset_make((const char *)set, setn);
+        seed = seed * 1103515245u + 12345u;
+        size_t n = (seed >> 8) % 150;
+        for (size_t i = 0; i < n; i++) {
+            seed = seed * 1103515245u + 12345u;
+            /* mostly members, so the spans reach the later blocks */
+            buf[i] = (seed >> 16) % 16 ? set[(seed >> 8) % setn]
+                                       : (unsigned char)(seed >> 20);
+        }
+        for (int in = 0; in <= 1 && ok; in++) {
+            size_t want = 0;
+            while (want < n && !!memchr(set, buf[want], setn) == in)
+                want++;
+            size_t got = vs_span((const char *)buf, n, &cs, in);
+            ok = got == want;
+            if (!ok)
+                printf("\nn=%zu in=%d got=%zu want=%zu", n, in, got, want);
+        }
+    }
+    CHECK_MSG("vs_span random", ok, "differs from the naive scan");
+}
+
+int main(int argc, char **argv) {
+    for (int i=1;i<argc;i++)
+        verbose |= (!strcmp(argv[i], "-v") || !strcmp(argv[i], "--verbose"));
+
+    test_charset();
+    test_span();
+    test_span_random();
+
+    if (failures == 0)
+        printf(verbose ? "\nAll tests passed.\n" : "\n");
+    else
+        printf("\n%d test(s) failed.\n", failures);
+    return failures;
+}
@@ -0,0 +1,226 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "vsuite/column.h"
+
+static int failures = 0;
+static int verbose = 0;
+
+/*
+ * CHECK_MSG() - Provide additional failure context.
+ * @name: Test name displayed on failure.
+ * @expr: Boolean expression indicating success.
+ * @fmt:  printf style format string used when @expr evaluates to false.
+ * @...: Values referenced by @fmt when reporting a failure.
+ */
+#define CHECK_MSG(name, expr, fmt, ...) do { \
+    if (!(expr)) { \
+        printf("\nFAIL: %s - " fmt "\n", name, ##__VA_ARGS__); \
+        failures++; \
+    } else if (verbose) { \
+        printf("PASS: %s\n", name); \
+    } else { \
+        fputc('.', stdout); fflush(stdout); \
+    } \
+} while (0)
+
+enum { ROWS = 100 };
+
+static const char *words[] = { "red", "green", "blue  ", "", "red ", "cyan" };
+#define NWORDS (sizeof words / sizeof words[0])
+
+/* Each VARCHAR() declaration is its own type, so fill through a macro. */
+#define fill_array(a, n) do {                               \
+    for (size_t i = 0; i < (n); i++) {                      \
+        const char *w = words[i % NWORDS];                  \
+        (a)[i].len = (unsigned short)strlen(w);             \
+        memcpy((a)[i].arr, w, (a)[i].len);                  \
+    }                                                       \
+} while (0)
+
+/* A round trip through a column leaves the array unchanged. */
+static void test_round_trip(void) {
+    static VARCHAR(a[ROWS], 8);
+    static VARCHAR(b[ROWS], 8);
+    static VCOLUMN(c, ROWS, 8);
+    fill_array(a, ROWS);
+    size_t n = vc_from_array(c, a, ROWS);
+    int ok = c.count == ROWS && varchar_overflow == 0;
+    for (size_t i = 0; i < ROWS && ok; i++)
+        ok = c.len[i] == a[i].len && memcmp(c.arr[i], a[i].arr, a[i].len) == 0;
+    CHECK_MSG("vc_from_array", ok && n == vc_total_len(c), "n=%zu count=%zu",
+              n, c.count);
+
+    size_t m = vc_to_array(b, c);
+    ok = m == n;
+    for (size_t i = 0; i < ROWS && ok; i++)
+        ok = b[i].len == a[i].len && memcmp(b[i].arr, a[i].arr, a[i].len) == 0;
+    CHECK_MSG("vc_to_array", ok, "m=%zu n=%zu", m, n);
+}
+
+/* Narrow columns truncate and extra rows are dropped. */
+static void test_truncate(void) {
+    static VARCHAR(a[10], 8);
+    VCOLUMN(c, 6, 4);
+    VARCHAR(narrow[6], 2);
+    fill_array(a, 10);
+    v_status_t st = vc_from_array_st(c, a, 10);
+    /* rows 0-5 store 3+4+4+0+4+4, lose 0+1+2+0+0+0; rows 6-9 lose 3+5+6+0 */
+    CHECK_MSG("vc_from_array_st", c.count == 6 && st.bytes == 19 &&
+              st.overflow == 17 && memcmp(c.arr[1], "gree", 4) == 0,
+              "count=%zu bytes=%zu overflow=%zu", c.count, st.bytes,
+              st.overflow);
+
+    size_t n = vc_to_array(narrow, c);
+    CHECK_MSG("vc_to_array truncate", n == 10 && varchar_overflow == 9 &&
+              narrow[1].len == 2 && memcmp(narrow[1].arr, "gr", 2) == 0 &&
+              narrow[3].len == 0,
+              "n=%zu overflow=%zu", n, varchar_overflow);
+}
+
+/* vc_valid() finds the first bad len at every position of the vector scan. */
+static void test_valid(void) {
+    static VCOLUMN(c, 37, 5);
+    c.count = 37;
+    int ok = 1;
+    for (size_t i = 0; i < 37; i++)
+        c.len[i] = (unsigned short)(i % 6);
+    ok = vc_valid(c) == 37;
+    for (size_t bad = 0; bad < 37 && ok; bad++) {
+        unsigned short save = c.len[bad];
+        c.len[bad] = bad & 1 ? 6 : 0xFFFF;
+        ok = vc_valid(c) == bad;
+        c.len[bad] = save;
+    }
+    CHECK_MSG("vc_valid", ok, "scan stopped at the wrong row");
+    c.count = 0;
+    CHECK_MSG("vc_valid empty", vc_valid(c) == 0, "got %zu", vc_valid(c));
+}
+
+static void test_lengths(void) {
+    static VCOLUMN(c, 50, 700);
+    c.count = 50;
+    for (size_t i = 0; i < 50; i++)
+        c.len[i] = (unsigned short)(i * 13);
+    c.len[33] = 40000;                  /* above the signed 16-bit range */
+    CHECK_MSG("vc_max_len", vc_max_len(c) == 40000, "got %zu", vc_max_len(c));
+    c.count = 33;
+    CHECK_MSG("vc_max_len tail", vc_max_len(c) == 32 * 13, "got %zu",
+              vc_max_len(c));
+    c.count = 50;
+    size_t want = 0;
+    for (size_t i = 0; i < 50; i++)
+        want += c.len[i] < 700 ? c.len[i] : 700;
+    CHECK_MSG("vc_total_len", vc_total_len(c) == want, "got %zu want %zu",
+              vc_total_len(c), want);
+}
+
+static void test_eq(void) {
+    static VARCHAR(a[ROWS], 8);
+    static VCOLUMN(c, ROWS, 8);
+    unsigned char match[ROWS];
+    fill_array(a, ROWS);
+    vc_from_array(c, a, ROWS);
+    size_t hits = vc_eq(c, "red", match);
+    int ok = 1;
+    for (size_t i = 0; i < ROWS && ok; i++)
+        ok = match[i] == (i % NWORDS == 0);
+    CHECK_MSG("vc_eq", ok && hits == (ROWS + NWORDS - 1) / NWORDS,
+              "hits=%zu", hits);
+    CHECK_MSG("vc_eq empty", vc_eq(c, "", NULL) == ROWS / NWORDS + 1,
+              "hits=%zu", vc_eq(c, "", NULL));
+    CHECK_MSG("vc_eq too long", vc_eq(c, "123456789", match) == 0 &&
+              match[0] == 0, "matched past the row width");
+    CHECK_MSG("vc_eqp", vc_eqp(c, "cyanide", 4, NULL) == ROWS / NWORDS,
+              "hits=%zu", vc_eqp(c, "cyanide", 4, NULL));
+}
+
+static void test_rtrim_case(void) {
+    static VARCHAR(a[ROWS], 8);
+    static VCOLUMN(c, ROWS, 8);
+    fill_array(a, ROWS);
+    vc_from_array(c, a, ROWS);
+    vc_rtrim(c);
+    vc_upper(c);
+    CHECK_MSG("vc_rtrim", c.len[2] == 4 && c.len[4] == 3 && c.len[1] == 5,
+              "len2=%u len4=%u", c.len[2], c.len[4]);
+    CHECK_MSG("vc_upper", vc_eq(c, "RED", NULL) == 2 * ((ROWS + 5) / 6) - 1,
+              "hits=%zu", vc_eq(c, "RED", NULL));
+    vc_lower(c);
+    CHECK_MSG("vc_lower", memcmp(c.arr[1], "green", 5) == 0, "row not lowered");
+}
+
+/* vc_hash() agrees with v_hash() on the same rows. */
+static void test_hash(void) {
+    static VARCHAR(a[ROWS], 8);
+    static VCOLUMN(c, ROWS, 8);
+    static uint64_t h[ROWS], ch[ROWS];
+    fill_array(a, ROWS);
+    a[7].arr[0] = 'G';
+    vc_from_array(c, a, ROWS);
+    size_t n = vc_hash(c, h);
+    size_t m = vc_casehash(c, ch);
+    int ok = 1, fold = 1;
+    for (size_t i = 0; i < ROWS; i++) {
+        ok &= h[i] == v_hash(a[i]);
+        fold &= ch[i] == v_casehash(a[i]);
+    }
+    CHECK_MSG("vc_hash", n == ROWS && ok && h[7] != h[1], "n=%zu", n);
+    CHECK_MSG("vc_casehash", m == ROWS && fold && ch[7] == ch[1], "m=%zu", m);
+}
+
+static void test_get_append(void) {
+    VCOLUMN(c, 2, 4);
+    VARCHAR(v, 6);
+    VARCHAR(small, 2);
+    vc_init(c);
+    memcpy(v.arr, "abcdef", 6);
+    v.len = 3;
+    long r0 = vc_append(c, v);
+    v.len = 6;
+    long r1 = vc_append(c, v);
+    CHECK_MSG("vc_append", r0 == 0 && r1 == 1 && c.count == 2 &&
+              c.len[1] == 4 && varchar_overflow == 2,
+              "r0=%ld r1=%ld len1=%u", r0, r1, c.len[1]);
+    varchar_overflow = 0;
+    CHECK_MSG("vc_append full", vc_append(c, v) == -1 && c.count == 2 &&
+              varchar_overflow == 6,
+              "count=%zu overflow=%zu", c.count, varchar_overflow);
+
+    size_t n = vc_get(small, c, 1);
+    CHECK_MSG("vc_get", n == 2 && small.len == 2 && varchar_overflow == 2 &&
+              memcmp(small.arr, "ab", 2) == 0, "n=%zu", n);
+    n = vc_get(v, c, 0);
+    CHECK_MSG("vc_get fit", n == 3 && v.len == 3 && varchar_overflow == 0,
+              "n=%zu", n);
+
+    v_status_t st = vc_get_st(small, c, 1);
+    CHECK_MSG("vc_get_st", st.bytes == 2 && st.overflow == 2 && small.len == 2,
+              "bytes=%zu overflow=%zu", st.bytes, st.overflow);
+    VCOLUMN(d, 1, 4);
+    vc_init(d);
+    st = vc_append_st(d, v);
+    CHECK_MSG("vc_append_st", st.bytes == 3 && st.overflow == 0 && d.count == 1 &&
+              d.len[0] == 3 && memcmp(d.arr[0], "abc", 3) == 0,
+              "bytes=%zu overflow=%zu", st.bytes, st.overflow);
+}
+
+int main(int argc, char **argv) {
+    for (int i=1;i<argc;i++)
+        verbose |= (!strcmp(argv[i], "-v") || !strcmp(argv[i], "--verbose"));
+
+    test_round_trip();
+    test_truncate();
+    test_valid();
+    test_lengths();
+    test_eq();
+    test_rtrim_case();
+    test_hash();
+    test_get_append();
+
+    if (failures == 0)
+        printf(verbose ? "\nAll tests passed.\n" : "\n");
+    else
+        printf("\n%d test(s) failed.\n", failures);
+    return failures;
+}
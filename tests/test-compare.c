@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vsuite/compare.h"
+
+static int failures = 0;
+static int verbose = 0;
+
+/*
+ * CHECK_MSG() - Provide additional failure context.
+ * @name: Test name displayed on failure.
+ * @expr: Boolean expression indicating success.
+ * @fmt:  printf style format string used when @expr evaluates to false.
+ * @...: Values referenced by @fmt when reporting a failure.
+ */
+#define CHECK_MSG(name, expr, fmt, ...) do { \
+    if (!(expr)) { \
+        printf("\nFAIL: %s - " fmt "\n", name, ##__VA_ARGS__); \
+        failures++; \
+    } else if (verbose) { \
+        printf("PASS: %s\n", name); \
+    } else { \
+        fputc('.', stdout); fflush(stdout); \
+    } \
+} while (0)
+
+#define SET(v, s) do { (v).len = (unsigned short)strlen(s); memcpy((v).arr, s, (v).len); } while (0)
+
+static int sign(int r) { return (r > 0) - (r < 0); }
+
+static int naive_fold(unsigned char c) { return c >= 'A' && c <= 'Z' ? c + 32 : c; }
+
+static int naive_casecmp(const char *a, size_t an, const char *b, size_t bn) {
+    for (size_t i = 0; i < an && i < bn; i++) {
+        int d = naive_fold((unsigned char)a[i]) - naive_fold((unsigned char)b[i]);
+        if (d)
+            return d;
+    }
+    return (an > bn) - (an < bn);
+}
+
+static int naive_cmp(const char *a, size_t an, const char *b, size_t bn) {
+    for (size_t i = 0; i < an && i < bn; i++)
+        if (a[i] != b[i])
+            return (unsigned char)a[i] - (unsigned char)b[i];
+    return (an > bn) - (an < bn);
+}
+
+static void test_cmp(void) {
+    VARCHAR(a, 32);
+    VARCHAR(b, 32);
+    SET(a, "AP0100");
+    SET(b, "AP0100");
+    a.arr[a.len] = 'x';                 /* past len: must be ignored */
+    CHECK_MSG("v_cmp equal", v_cmp(a, b) == 0 && v_eq(a, b), "got %d",
+              v_cmp(a, b));
+    SET(b, "AP01");
+    CHECK_MSG("v_cmp prefix", v_cmp(a, b) > 0 && v_cmp(b, a) < 0 &&
+              !v_eq(a, b), "shorter value not first");
+    SET(b, "AP0200");
+    CHECK_MSG("v_cmp order", v_cmp(a, b) < 0 && v_cmp(b, a) > 0,
+              "got %d", v_cmp(a, b));
+    a.arr[2] = '\0';
+    b.len = 6;
+    memcpy(b.arr, "AP\0" "100", 6);
+    CHECK_MSG("v_cmp nul", v_cmp(a, b) == 0 && v_eq(a, b),
+              "embedded NUL ended the compare");
+    b.arr[5] = '1';
+    CHECK_MSG("v_cmp after nul", v_cmp(a, b) < 0 && !v_eq(a, b),
+              "bytes after NUL ignored");
+    SET(a, "\xe9t\xe9");
+    SET(b, "ete");
+    CHECK_MSG("v_cmp unsigned", v_cmp(a, b) > 0, "high bytes sorted low");
+}
+
+static void test_fixed(void) {
+    VARCHAR(v, 16);
+    char f[8] = "GL";
+    char full[4] = { 'G', 'L', '0', '1' };
+    SET(v, "GL");
+    CHECK_MSG("vf_eq", vf_eq(v, f) && vf_eq(v, "GL") && !vf_eq(v, "GL0") &&
+              vf_cmp(v, "GL") == 0 && vf_cmp(v, "GM") < 0,
+              "wrong result against a fixed string");
+    SET(v, "GL01");
+    CHECK_MSG("vf_eq full", vf_eq(v, full) && vf_cmp(v, full) == 0,
+              "read past F_SIZE");
+    CHECK_MSG("vp_eq", vp_eq(v, "GL01") && vp_cmp(v, "GL010") < 0 &&
+              vp_caseeq(v, "gl01") && vp_casecmp(v, "gl02") < 0,
+              "wrong result against a pointer");
+    CHECK_MSG("vf_caseeq", vf_caseeq(v, "gL01") && vf_casecmp(v, "GK") > 0,
+              "wrong case-insensitive result");
+}
+
+static void test_casecmp(void) {
+    VARCHAR(a, 80);
+    VARCHAR(b, 80);
+    SET(a, "Accrued Payroll - Wages Payable, Hourly [Q3]");
+    SET(b, "ACCRUED PAYROLL - WAGES PAYABLE, HOURLY [q3]");
+    CHECK_MSG("v_casecmp", v_casecmp(a, b) == 0 && v_caseeq(a, b),
+              "got %d", v_casecmp(a, b));
+    b.arr[30] = '.';
+    CHECK_MSG("v_casecmp diff", v_casecmp(a, b) > 0 && !v_caseeq(a, b),
+              "got %d", v_casecmp(a, b));
+    /* '@' and '[' sit next to the letters and must not fold */
+    SET(a, "@[`{");
+    SET(b, "`{@[");
+    CHECK_MSG("v_casecmp edges", v_casecmp(a, b) < 0 && !v_caseeq(a, b),
+              "folded a non-letter");
+}
+
+/* Random pairs of every length through the word and vector paths. */
+static void test_random(void) {
+    char a[200], b[200];
+    unsigned seed = 777;
+    int ok = 1;
+    for (int iter = 0; iter < 30000 && ok; iter++) {
+        seed = seed * 1103515245u + 12345u;
+        size_t an = (seed >> 8) % 150, bn = an;
+        seed = seed * 1103515245u + 12345u;
+        if ((seed >> 16) % 4 == 0)
+            bn = (seed >> 4) % 150;
+        for (size_t i = 0; i < an; i++) {
+            seed = seed * 1103515245u + 12345u;
+            a[i] = (char)(seed >> 16);
+        }
+        for (size_t i = 0; i < bn; i++) {
+            seed = seed * 1103515245u + 12345u;
+            unsigned char c = i < an ? (unsigned char)a[i] : (unsigned char)(seed >> 16);
+            if ((seed >> 8) % 2 && ((c | 32) >= 'a' && (c | 32) <= 'z'))
+                c ^= 32;                /* same letter, other case */
+            if ((seed >> 20) % 300 == 0)
+                c = (unsigned char)(seed >> 12);
+            b[i] = (char)c;
+        }
+        ok = sign(vs_casecmp(a, an, b, bn)) == sign(naive_casecmp(a, an, b, bn)) &&
+             vs_caseeq(a, an, b, bn) == (naive_casecmp(a, an, b, bn) == 0) &&
+             sign(vs_cmp(a, an, b, bn)) == sign(naive_cmp(a, an, b, bn)) &&
+             vs_eq(a, an, b, bn) == (naive_cmp(a, an, b, bn) == 0) &&
+             vs_eq(a, an, a, an);
+        if (!ok)
+            printf("\nan=%zu bn=%zu", an, bn);
+    }
+    CHECK_MSG("vs_cmp random", ok, "differs from the naive compare");
+}
+
+int main(int argc, char **argv) {
+    for (int i=1;i<argc;i++)
+        verbose |= (!strcmp(argv[i], "-v") || !strcmp(argv[i], "--verbose"));
+
+    test_cmp();
+    test_fixed();
+    test_casecmp();
+    test_random();
+
+    if (failures == 0)
+        printf(verbose ? "\nAll tests passed.\n" : "\n");
+    else
+        printf("\n%d test(s) failed.\n", failures);
+    return failures;
+}
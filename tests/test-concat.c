@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "vsuite/concat.h"
+
+static int failures = 0;
+static int verbose = 0;
+
+/*
+ * CHECK_MSG() - Provide additional failure context.
+ * @name: Test name displayed on failure.
+ * @expr: Boolean expression indicating success.
+ * @fmt:  printf style format string used when @expr evaluates to false.
+ * @...: Values referenced by @fmt when reporting a failure.
+ */
+#define CHECK_MSG(name, expr, fmt, ...) do { \
+    if (!(expr)) { \
+        printf("\nFAIL: %s - " fmt "\n", name, ##__VA_ARGS__); \
+        failures++; \
+    } else if (verbose) { \
+        printf("PASS: %s\n", name); \
+    } else { \
+        fputc('.', stdout); fflush(stdout); \
+    } \
+} while (0)
+
+#define SET(v, s) do { (v).len = (unsigned short)strlen(s); memcpy((v).arr, s, (v).len); } while (0)
+
+static void test_many(void) {
+    VARCHAR(key, 32);
+    VARCHAR(entity, 4);
+    VARCHAR(org, 6);
+    VARCHAR(acct, 10);
+    VARCHAR(sep, 1);
+    SET(entity, "0100");
+    SET(org, "R123");
+    SET(acct, "6100200");
+    SET(sep, "|");
+    varchar_overflow = 5;
+    size_t n = v_concat_many(key, entity, sep, org, sep, acct);
+    CHECK_MSG("v_concat_many", n == 17 && key.len == 17 &&
+              varchar_overflow == 0 &&
+              memcmp(key.arr, "0100|R123|6100200", 17) == 0,
+              "n=%zu '%.*s'", n, (int)key.len, key.arr);
+
+    n = v_concat_many(key, org);
+    CHECK_MSG("v_concat_many one", n == 4 && memcmp(key.arr, "R123", 4) == 0,
+              "n=%zu", n);
+
+    n = v_concat_many(key, entity, org, acct, sep, entity, org, acct, sep);
+    CHECK_MSG("v_concat_many eight", n == 32 && varchar_overflow == 0 &&
+              memcmp(key.arr, "0100R1236100200|0100R1236100200|", 32) == 0,
+              "n=%zu overflow=%zu", n, varchar_overflow);
+
+    /* Appending by passing the destination first. */
+    SET(key, "K:");
+    n = v_concat_many(key, key, entity);
+    CHECK_MSG("v_concat_many append", n == 6 && memcmp(key.arr, "K:0100", 6) == 0,
+              "n=%zu", n);
+}
+
+static void test_overflow(void) {
+    VARCHAR(small, 6);
+    VARCHAR(a, 4);
+    VARCHAR(b, 8);
+    SET(a, "abcd");
+    SET(b, "efghijkl");
+    size_t n = v_concat_many(small, a, b, a);
+    CHECK_MSG("v_concat_many overflow", n == 6 && small.len == 6 &&
+              varchar_overflow == 10 && memcmp(small.arr, "abcdef", 6) == 0,
+              "n=%zu overflow=%zu", n, varchar_overflow);
+
+    v_status_t st = v_concat_many_st(small, b, a);
+    CHECK_MSG("v_concat_many_st", st.bytes == 6 && st.overflow == 6 &&
+              memcmp(small.arr, "efghij", 6) == 0,
+              "bytes=%zu overflow=%zu", st.bytes, st.overflow);
+
+    /* A corrupt source len is clamped to its declared size. */
+    a.len = 60000;
+    st = v_concat_many_st(small, a);
+    CHECK_MSG("v_concat_many clamp", st.bytes == 4 && st.overflow == 0,
+              "bytes=%zu overflow=%zu", st.bytes, st.overflow);
+}
+
+static void test_zv(void) {
+    VARCHAR(z, 8);
+    VARCHAR(a, 3);
+    VARCHAR(b, 5);
+    SET(a, "abc");
+    SET(b, "de");
+    memset(z.arr, '#', sizeof z.arr);
+    size_t n = zv_concat_many(z, a, b);
+    CHECK_MSG("zv_concat_many", n == 5 && z.len == 5 && zv_valid(z) &&
+              strcmp(z.arr, "abcde") == 0, "n=%zu", n);
+    n = zv_concat_many(z, a, b, a);
+    CHECK_MSG("zv_concat_many overflow", n == 7 && varchar_overflow == 1 &&
+              zv_valid(z) && strcmp(z.arr, "abcdeab") == 0,
+              "n=%zu overflow=%zu", n, varchar_overflow);
+}
+
+int main(int argc, char **argv) {
+    for (int i=1;i<argc;i++)
+        verbose |= (!strcmp(argv[i], "-v") || !strcmp(argv[i], "--verbose"));
+
+    test_many();
+    test_overflow();
+    test_zv();
+
+    if (failures == 0)
+        printf(verbose ? "\nAll tests passed.\n" : "\n");
+    else
+        printf("\n%d test(s) failed.\n", failures);
+    return failures;
+}
@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#define V_WARN_SINK(fmt, ...) fprintf(warn_file, fmt "\n", ##__VA_ARGS__)
+static FILE *warn_file;
+
+#include "vsuite/varchar.h"
+#include "vsuite/diag.h"
+#include "varchar-logFile.h"
+
+static int failures = 0;
+static int verbose = 0;
+FILE *logFile;
+
+/*
+ * CHECK_MSG() - Provide additional failure context.
+ * @name: Test name displayed on failure.
+ * @expr: Boolean expression indicating success.
+ * @fmt:  printf style format string used when @expr evaluates to false.
+ * @...: Values referenced by @fmt when reporting a failure.
+ */
+#define CHECK_MSG(name, expr, fmt, ...) do { \
+    if (!(expr)) { \
+        printf("\nFAIL: %s - " fmt "\n", name, ##__VA_ARGS__); \
+        failures++; \
+    } else if (verbose) { \
+        printf("PASS: %s\n", name); \
+    } else { \
+        fputc('.', stdout); fflush(stdout); \
+    } \
+} while (0)
+
+/* count_lines() - Lines written to @f so far; rewinds it for the next test. */
+static size_t count_lines(FILE *f, const char *needle) {
+    fflush(f);
+    rewind(f);
+    char line[512];
+    size_t n = 0;
+    while (fgets(line, sizeof line, f))
+        n += strstr(line, needle) != NULL;
+    rewind(f);
+    if (ftruncate(fileno(f), 0) != 0)
+        return (size_t)-1;
+    return n;
+}
+
+/* site_count() - Occurrences recorded for the site at @file:@line. */
+static uint64_t site_count(int line) {
+    for (vs_diag_site_t *s = vs_diag_sites; s; s = s->next)
+        if (s->line == line && strstr(s->file, "test-diag"))
+            return s->count;
+    return 0;
+}
+
+/* The first VS_DIAG_LIMIT occurrences are written, the rest counted. */
+static void test_limit(void) {
+    int line = 0;
+    for (int i = 0; i < 100; i++) {
+        line = __LINE__; VS_DIAG_LIMITED("limit %d", fprintf(logFile, "limit %d\n", i));
+    }
+    CHECK_MSG("VS_DIAG_LIMITED lines", count_lines(logFile, "limit ") == VS_DIAG_LIMIT,
+              "wrong number of lines");
+    CHECK_MSG("VS_DIAG_LIMITED count", site_count(line) == 100, "count %llu",
+              (unsigned long long)site_count(line));
+}
+
+/* Each call site has its own record. */
+static void test_sites(void) {
+    for (int i = 0; i < 20; i++) {
+        VS_DIAG_LIMITED("site a", fprintf(logFile, "site a\n"));
+        VS_DIAG_LIMITED("site b", fprintf(logFile, "site b\n"));
+    }
+    CHECK_MSG("VS_DIAG_LIMITED per site", count_lines(logFile, "site ") == 2 * VS_DIAG_LIMIT,
+              "sites share a record");
+}
+
+/* The varchar-logFile.h diagnostics are limited per site. */
+static void test_logfile(void) {
+    VARCHAR(v, 3);
+    for (int i = 0; i < 50; i++) {
+        memcpy(v.arr, "abc", 3);
+        VARCHAR_ZSETLEN(v);
+    }
+    CHECK_MSG("VARCHAR_ZSETLEN limited", count_lines(logFile, "VARCHAR_ZSETLEN") == VS_DIAG_LIMIT,
+              "not limited");
+}
+
+/* V_WARN goes to V_WARN_SINK, limited per site. */
+static void test_v_warn(void) {
+    VARCHAR(src, 8);
+    VARCHAR(dst, 4);
+    memcpy(src.arr, "overflow", 8);
+    src.len = 8;
+    for (int i = 0; i < 30; i++)
+        v_copy(dst, src);
+    CHECK_MSG("V_WARN limited", count_lines(warn_file, "v_copy(") == VS_DIAG_LIMIT,
+              "not limited");
+}
+
+static void *hammer(void *arg) {
+    (void)arg;
+    for (int i = 0; i < 10000; i++)
+        VS_DIAG_LIMITED("hammer", fprintf(logFile, "hammer\n"));
+    return NULL;
+}
+
+/* Concurrent sites count every occurrence and log the limit once. */
+static void test_threads(void) {
+    pthread_t th[4];
+    for (int t = 0; t < 4; t++)
+        pthread_create(&th[t], NULL, hammer, NULL);
+    for (int t = 0; t < 4; t++)
+        pthread_join(th[t], NULL);
+    uint64_t total = 0;
+    for (vs_diag_site_t *s = vs_diag_sites; s; s = s->next)
+        if (!strcmp(s->what, "hammer"))
+            total += s->count;
+    CHECK_MSG("VS_DIAG_LIMITED threads", total == 40000 &&
+              count_lines(logFile, "hammer") == VS_DIAG_LIMIT,
+              "total %llu", (unsigned long long)total);
+}
+
+/* vs_diag_report() lists the suppressing sites with their counts. */
+static void test_report(void) {
+    FILE *f = tmpfile();
+    size_t listed = vs_diag_report(f, 0);
+    size_t all = vs_diag_report(f, 1);
+    rewind(f);
+    char buf[4096];
+    size_t n = fread(buf, 1, sizeof buf - 1, f);
+    buf[n] = '\0';
+    CHECK_MSG("vs_diag_report", listed >= 5 && all >= listed &&
+              strstr(buf, "100 occurrences, 90 not logged : limit %d") != NULL,
+              "report:\n%s", buf);
+    fclose(f);
+}
+
+int main(int argc, char **argv) {
+    for (int i=1;i<argc;i++)
+        verbose |= (!strcmp(argv[i], "-v") || !strcmp(argv[i], "--verbose"));
+
+    logFile = tmpfile();
+    warn_file = tmpfile();
+    vs_diag_out = fopen("/dev/null", "w");
+    if (!logFile || !warn_file || !vs_diag_out) {
+        perror("tmpfile");
+        return 1;
+    }
+
+    test_limit();
+    test_sites();
+    test_logfile();
+    test_v_warn();
+    test_threads();
+    test_report();
+
+    if (failures == 0)
+        printf(verbose ? "\nAll tests passed.\n" : "\n");
+    else
+        printf("\n%d test(s) failed.\n", failures);
+    return failures;
+}
@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vsuite/groupby.h"
+
+static int failures = 0;
+static int verbose = 0;
+
+/*
+ * CHECK_MSG() - Provide additional failure context.
+ * @name: Test name displayed on failure.
+ * @expr: Boolean expression indicating success.
+ * @fmt:  printf style format string used when @expr evaluates to false.
+ * @...: Values referenced by @fmt when reporting a failure.
+ */
+#define CHECK_MSG(name, expr, fmt, ...) do { \
+    if (!(expr)) { \
+        printf("\nFAIL: %s - " fmt "\n", name, ##__VA_ARGS__); \
+        failures++; \
+    } else if (verbose) { \
+        printf("PASS: %s\n", name); \
+    } else { \
+        fputc('.', stdout); fflush(stdout); \
+    } \
+} while (0)
+
+#define SET(v, s) do { (v).len = (unsigned short)strlen(s); memcpy((v).arr, s, (v).len); } while (0)
+
+static void test_basic(void) {
+    vs_group_t *g = vs_group_create(2, 2, 0);
+    VARCHAR(ent, 8);
+    VARCHAR(acct, 16);
+    CHECK_MSG("vs_group_create", g && vs_group_count(g) == 0, "no group-by");
+    CHECK_MSG("vs_group_create keys", vs_group_create(0, 1, 0) == NULL &&
+              vs_group_create(VS_GROUP_KEYS_MAX + 1, 1, 0) == NULL,
+              "bad key count accepted");
+
+    SET(ent, "01");
+    SET(acct, "6100200");
+    acct.arr[acct.len] = 'x';           /* past len: not part of the key */
+    int64_t *s = v_group_row(g, ent, acct);
+    CHECK_MSG("v_group_row new", s && s[0] == 0 && s[1] == 0 &&
+              vs_group_count(g) == 1, "new group not zeroed");
+    s[0] += 1250; s[1] += 1;
+    s = v_group_row(g, ent, acct);
+    CHECK_MSG("v_group_row same", s && s[0] == 1250 && vs_group_count(g) == 1,
+              "same key made a new group");
+    s[0] += 750; s[1] += 1;
+
+    /* ("01", "6100200") and ("016", "100200") must not collide */
+    SET(ent, "016");
+    SET(acct, "100200");
+    s = v_group_row(g, ent, acct);
+    CHECK_MSG("v_group_row split", s && s[0] == 0 && vs_group_count(g) == 2,
+              "column boundary ignored");
+    s[0] -= 40;
+
+    const char *b[] = { "01", "6100200" };
+    size_t l[] = { 2, 7 };
+    CHECK_MSG("vs_group_row count", vs_group_row(g, b, l, 1) == NULL &&
+              vs_group_row(g, b, l, 2) != NULL, "key count not checked");
+    CHECK_MSG("vs_group_sums", vs_group_sums(g, 0)[0] == 2000 &&
+              vs_group_sums(g, 0)[1] == 2 && vs_group_sums(g, 1)[0] == -40,
+              "sums %lld %lld", (long long)vs_group_sums(g, 0)[0],
+              (long long)vs_group_sums(g, 1)[0]);
+    CHECK_MSG("vs_group_rows", vs_group_rows(g, 0) == 3 &&
+              vs_group_rows(g, 1) == 1, "rows %llu",
+              (unsigned long long)vs_group_rows(g, 0));
+
+    size_t n;
+    const char *k = vs_group_key(g, 1, 1, &n);
+    CHECK_MSG("vs_group_key", n == 6 && memcmp(k, "100200", 6) == 0,
+              "key %.*s", (int)n, k);
+    CHECK_MSG("v_group_key", v_group_key(acct, g, 0, 1) == 7 &&
+              acct.len == 7 && memcmp(acct.arr, "6100200", 7) == 0 &&
+              varchar_overflow == 0, "copy failed");
+    VARCHAR(tiny, 4);
+    CHECK_MSG("v_group_key overflow", v_group_key(tiny, g, 0, 1) == 4 &&
+              tiny.len == 4 && varchar_overflow == 3, "overflow %zu",
+              (size_t)varchar_overflow);
+    CHECK_MSG("vs_group_bytes", vs_group_bytes(g) > 0, "no memory reported");
+    vs_group_destroy(g);
+    vs_group_destroy(NULL);
+}
+
+static void test_empty(void) {
+    vs_group_t *g = vs_group_create(1, 0, 4);
+    VARCHAR(v, 4);
+    v.len = 0;
+    CHECK_MSG("empty key", v_group_row(g, v) != NULL &&
+              v_group_row(g, v) != NULL && vs_group_count(g) == 1 &&
+              vs_group_rows(g, 0) == 2, "empty key not grouped");
+    static char big[70000];
+    const char *b[] = { big };
+    size_t l[] = { sizeof big };
+    CHECK_MSG("key too long", vs_group_row(g, b, l, 1) == NULL &&
+              vs_group_count(g) == 1, "oversized key accepted");
+    vs_group_destroy(g);
+}
+
+/* Many groups through several table and array growths. */
+static void test_many(void) {
+    enum { N = 50000, ROWS = 200000 };
+    vs_group_t *g = vs_group_create(2, 1, 0);
+    VARCHAR(a, 8);
+    VARCHAR(b, 16);
+    int ok = 1;
+    for (size_t r = 0; r < ROWS && ok; r++) {
+        size_t i = r * 7919 % N;
+        a.len = (unsigned short)snprintf(a.arr, 8, "%zu", i % 13);
+        b.len = (unsigned short)snprintf(b.arr, 16, "%zu", i);
+        int64_t *s = v_group_row(g, a, b);
+        ok = s != NULL;
+        if (s)
+            s[0] += (int64_t)i;
+    }
+    CHECK_MSG("many groups", ok && vs_group_count(g) == N, "count %zu",
+              vs_group_count(g));
+    size_t bad = 0;
+    for (size_t id = 0; id < vs_group_count(g); id++) {
+        size_t n;
+        const char *k = vs_group_key(g, id, 1, &n);
+        char digits[16];
+        snprintf(digits, sizeof digits, "%.*s", (int)n, k);
+        size_t i = strtoul(digits, NULL, 10);
+        if (vs_group_sums(g, id)[0] != (int64_t)(i * (ROWS / N)) ||
+            vs_group_rows(g, id) != ROWS / N)
+            bad++;
+    }
+    CHECK_MSG("many sums", bad == 0, "%zu wrong groups", bad);
+    vs_group_destroy(g);
+}
+
+static void test_bulk(void) {
+    enum { ROWS = 1000 };
+    static VARCHAR(ent[ROWS], 4);
+    static VARCHAR(acct[ROWS], 12);
+    static int64_t debit[ROWS], credit[ROWS];
+    for (size_t r = 0; r < ROWS; r++) {
+        SET(ent[r], r % 2 ? "01" : "02");
+        acct[r].len = (unsigned short)snprintf(acct[r].arr, 12, "61%05zu", r % 10);
+        debit[r] = (int64_t)r;
+        credit[r] = 1;
+    }
+    vs_group_t *g = vs_group_create(2, 2, 0);
+    vs_group_col_t cols[] = { VB_GROUP_COL(ent), VB_GROUP_COL(acct) };
+    const int64_t *vals[] = { debit, credit };
+    CHECK_MSG("vb_group_add", vb_group_add(g, cols, vals, ROWS) == 0 &&
+              vs_group_count(g) == 10, "count %zu", vs_group_count(g));
+
+    /* row 0 opens ("02", "6100000"): rows 0, 10, 20, ... */
+    CHECK_MSG("vb_group_add sums", vs_group_sums(g, 0)[0] == 49500 &&
+              vs_group_sums(g, 0)[1] == 100 && vs_group_rows(g, 0) == 100,
+              "sum %lld", (long long)vs_group_sums(g, 0)[0]);
+
+    /* a second fetch adds to the same groups */
+    CHECK_MSG("vb_group_add again", vb_group_add(g, cols, vals, 15) == 0 &&
+              vs_group_count(g) == 10 && vs_group_rows(g, 0) == 102,
+              "rows %llu", (unsigned long long)vs_group_rows(g, 0));
+
+    static VARCHAR(out_ent[16], 4);
+    static VARCHAR(out_acct[16], 5);
+    CHECK_MSG("vb_group_keys", vb_group_keys(out_ent, 16, g, 0) == 20 &&
+              varchar_overflow == 0 && out_ent[1].len == 2 &&
+              memcmp(out_ent[1].arr, "01", 2) == 0, "keys not copied");
+    CHECK_MSG("vb_group_keys overflow", vb_group_keys(out_acct, 16, g, 1) == 50 &&
+              varchar_overflow == 20 && out_acct[3].len == 5 &&
+              memcmp(out_acct[3].arr, "61000", 5) == 0,
+              "overflow %zu", (size_t)varchar_overflow);
+    vs_group_destroy(g);
+}
+
+int main(int argc, char **argv) {
+    for (int i=1;i<argc;i++)
+        verbose |= (!strcmp(argv[i], "-v") || !strcmp(argv[i], "--verbose"));
+
+    test_basic();
+    test_empty();
+    test_many();
+    test_bulk();
+
+    if (failures == 0)
+        printf(verbose ? "\nAll tests passed.\n" : "\n");
+    else
+        printf("\n%d test(s) failed.\n", failures);
+    return failures;
+}
@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vsuite/hash.h"
+
+static int failures = 0;
+static int verbose = 0;
+
+/*
+ * CHECK_MSG() - Provide additional failure context.
+ * @name: Test name displayed on failure.
+ * @expr: Boolean expression indicating success.
+ * @fmt:  printf style format string used when @expr evaluates to false.
+ * @...: Values referenced by @fmt when reporting a failure.
+ */
+#define CHECK_MSG(name, expr, fmt, ...) do { \
+    if (!(expr)) { \
+        printf("\nFAIL: %s - " fmt "\n", name, ##__VA_ARGS__); \
+        failures++; \
+    } else if (verbose) { \
+        printf("PASS: %s\n", name); \
+    } else { \
+        fputc('.', stdout); fflush(stdout); \
+    } \
+} while (0)
+
+#define SET(v, s) do { (v).len = (unsigned short)strlen(s); memcpy((v).arr, s, (v).len); } while (0)
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void test_basic(void) {
+    VARCHAR(a, 32);
+    VARCHAR(b, 32);
+    SET(a, "GL0100");
+    SET(b, "GL0100");
+    a.arr[a.len] = 'x';                 /* past len: must be ignored */
+    b.arr[b.len] = 'y';
+    CHECK_MSG("v_hash equal", v_hash(a) == v_hash(b), "equal values differ");
+    b.len = 5;
+    CHECK_MSG("v_hash length", v_hash(a) != v_hash(b), "length not mixed in");
+    SET(b, "gl0100");
+    CHECK_MSG("v_casehash", v_casehash(a) == v_casehash(b) &&
+              v_hash(a) != v_hash(b), "case not folded");
+    CHECK_MSG("v_hash seed", v_hash_seed(a, 1) != v_hash_seed(a, 2),
+              "seed ignored");
+    a.len = 0;
+    b.len = 0;
+    CHECK_MSG("v_hash empty", v_hash(a) == v_hash(b) &&
+              v_hash_seed(a, 1) != v_hash_seed(a, 2), "empty value");
+}
+
+static void test_fields(void) {
+    VARCHAR(a, 8);
+    VARCHAR(b, 8);
+    VARCHAR(c, 8);
+    VARCHAR(d, 8);
+    SET(a, "AB");
+    SET(b, "C");
+    SET(c, "A");
+    SET(d, "BC");
+    CHECK_MSG("v_hash_fields", v_hash_fields(a, b) == v_hash_seed(b, v_hash(a)),
+              "not a chain of v_hash_seed");
+    CHECK_MSG("v_hash_fields split", v_hash_fields(a, b) != v_hash_fields(c, d),
+              "field boundary not mixed in");
+    CHECK_MSG("v_hash_fields order", v_hash_fields(a, b) != v_hash_fields(b, a),
+              "field order not mixed in");
+    SET(c, "ab");
+    SET(d, "c");
+    CHECK_MSG("v_casehash_fields", v_casehash_fields(a, b) ==
+              v_casehash_fields(c, d), "case not folded");
+}
+
+/* Every length: case variants agree, and a one-bit change alters ~half the bits. */
+static void test_lengths(void) {
+    char s[300] = { 0 }, u[300] = { 0 };
+    int ok = 1;
+    long bits = 0, trials = 0;
+    for (size_t n = 0; n <= 260 && ok; n++) {
+        for (size_t i = 0; i < n; i++) {
+            s[i] = (char)("aZ09-x"[i % 6] + (i / 6) % 3);
+            u[i] = (char)(s[i] >= 'a' && s[i] <= 'z' ? s[i] - 32 :
+                          s[i] >= 'A' && s[i] <= 'Z' ? s[i] + 32 : s[i]);
+        }
+        uint64_t h = vs_hash(s, n, VS_HASH_SEED);
+        ok = vs_casehash(s, n, 7) == vs_casehash(u, n, 7) &&
+             (n == 0 || vs_hash(u, n, VS_HASH_SEED) != h);
+        for (size_t i = 0; i < n && ok; i++) {
+            for (int bit = 0; bit < 8; bit++) {
+                s[i] ^= (char)(1 << bit);
+                uint64_t g = vs_hash(s, n, VS_HASH_SEED);
+                s[i] ^= (char)(1 << bit);
+                ok = g != h;
+                bits += __builtin_popcountll(g ^ h);
+                trials++;
+            }
+        }
+        if (!ok)
+            printf("\nn=%zu", n);
+    }
+    double avg = (double)bits / trials;
+    CHECK_MSG("vs_hash lengths", ok, "collision or case mismatch");
+    CHECK_MSG("vs_hash avalanche", avg > 31.0 && avg < 33.0,
+              "average %.2f bits changed", avg);
+}
+
+/* Distinct account numbers and short codes must not collide in 64 bits. */
+static void test_collisions(void) {
+    enum { N = 200000 + 26 * 26 * 26 + 26 * 26 + 26 };
+    uint64_t *h = malloc(N * sizeof *h);
+    char key[32];
+    int k = 0, dup = 0;
+    for (int i = 0; i < 200000; i++) {
+        int n = snprintf(key, sizeof key, "%02d-%06d%s", i % 37, i,
+                         i % 2 ? "-0001" : "");
+        h[k++] = vs_hash(key, (size_t)n, VS_HASH_SEED);
+    }
+    for (int n = 1; n <= 3; n++) {
+        int count = n == 1 ? 26 : n == 2 ? 26 * 26 : 26 * 26 * 26;
+        for (int i = 0; i < count; i++) {
+            for (int j = 0, x = i; j < n; j++, x /= 26)
+                key[j] = (char)('A' + x % 26);
+            h[k++] = vs_hash(key, (size_t)n, VS_HASH_SEED);
+        }
+    }
+    qsort(h, N, sizeof *h, cmp_u64);
+    for (int i = 1; i < N; i++)
+        dup += h[i] == h[i - 1];
+    CHECK_MSG("vs_hash collisions", dup == 0, "%d duplicates", dup);
+    int low = 0;
+    for (int i = 0; i < 4096; i++) {
+        int n = snprintf(key, sizeof key, "R%d", i);
+        low |= 1 << (vs_hash(key, (size_t)n, VS_HASH_SEED) & 15);
+    }
+    CHECK_MSG("vs_hash low bits", low == 0xffff, "low bits unused: %x", low);
+    free(h);
+}
+
+int main(int argc, char **argv) {
+    for (int i=1;i<argc;i++)
+        verbose |= (!strcmp(argv[i], "-v") || !strcmp(argv[i], "--verbose"));
+
+    test_basic();
+    test_fields();
+    test_lengths();
+    test_collisions();
+
+    if (failures == 0)
+        printf(verbose ? "\nAll tests passed.\n" : "\n");
+    else
+        printf("\n%d test(s) failed.\n", failures);
+    return failures;
+}
@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "vsuite/intern.h"
+
+static int failures = 0;
+static int verbose = 0;
+
+/*
+ * CHECK_MSG() - Provide additional failure context.
+ * @name: Test name displayed on failure.
+ * @expr: Boolean expression indicating success.
+ * @fmt:  printf style format string used when @expr evaluates to false.
+ * @...: Values referenced by @fmt when reporting a failure.
+ */
+#define CHECK_MSG(name, expr, fmt, ...) do { \
+    if (!(expr)) { \
+        printf("\nFAIL: %s - " fmt "\n", name, ##__VA_ARGS__); \
+        failures++; \
+    } else if (verbose) { \
+        printf("PASS: %s\n", name); \
+    } else { \
+        fputc('.', stdout); fflush(stdout); \
+    } \
+} while (0)
+
+static void test_basic(void) {
+    vs_intern_t *p = vs_intern_create(4);
+    VARCHAR(org, 5);
+    memcpy(org.arr, "3013X", 5);
+    org.len = 4;
+    uint32_t a = v_intern(p, org);
+    uint32_t b = vs_intern(p, "3014", 4);
+    uint32_t c = vs_intern(p, "3013", 4);
+    CHECK_MSG("v_intern ids", a == 0 && b == 1 && c == a &&
+              vs_intern_count(p) == 2, "a=%u b=%u c=%u", a, b, c);
+    CHECK_MSG("vs_intern_str", strcmp(vs_intern_str(p, a), "3013") == 0 &&
+              vs_intern_len(p, b) == 4, "str=%s", vs_intern_str(p, a));
+
+    /* Prefixes and the empty value are distinct. */
+    uint32_t e = vs_intern(p, "", 0);
+    uint32_t f = vs_intern(p, "301", 3);
+    CHECK_MSG("v_intern distinct", e == 2 && f == 3 &&
+              vs_intern(p, "", 0) == 2, "e=%u f=%u", e, f);
+
+    CHECK_MSG("vs_intern_lookup", vs_intern_lookup(p, "3014", 4) == 1 &&
+              vs_intern_lookup(p, "9999", 4) == VS_INTERN_NONE &&
+              vs_intern_count(p) == 4, "count=%zu", vs_intern_count(p));
+    org.len = 3;
+    CHECK_MSG("v_intern_lookup", v_intern_lookup(p, org) == 3, "got %u",
+              v_intern_lookup(p, org));
+    vs_intern_destroy(p);
+}
+
+/* Growth past the expected size keeps ids and canonical pointers. */
+static void test_grow(void) {
+    vs_intern_t *p = vs_intern_create(0);
+    const char *first = NULL;
+    int ok = 1;
+    for (int round = 0; round < 3 && ok; round++) {
+        for (unsigned i = 0; i < 5000 && ok; i++) {
+            char buf[16];
+            int n = snprintf(buf, sizeof buf, "code-%u", i * 7919);
+            uint32_t id = vs_intern(p, buf, (size_t)n);
+            ok = id == i && strcmp(vs_intern_str(p, id), buf) == 0;
+        }
+        if (round == 0)
+            first = vs_intern_str(p, 0);
+    }
+    CHECK_MSG("vs_intern grow", ok && vs_intern_count(p) == 5000 &&
+              vs_intern_str(p, 0) == first, "count=%zu",
+              vs_intern_count(p));
+    vs_intern_destroy(p);
+    vs_intern_destroy(NULL);
+}
+
+static void test_get(void) {
+    vs_intern_t *p = vs_intern_create(8);
+    VARCHAR(v, 4);
+    uint32_t id = vs_intern(p, "000000", 6);
+    size_t n = v_intern_get(v, p, id);
+    CHECK_MSG("v_intern_get overflow", n == 4 && v.len == 4 &&
+              varchar_overflow == 2 && memcmp(v.arr, "0000", 4) == 0,
+              "n=%zu overflow=%zu", n, varchar_overflow);
+    id = vs_intern(p, "01", 2);
+    n = v_intern_get(v, p, id);
+    CHECK_MSG("v_intern_get", n == 2 && v.len == 2 && varchar_overflow == 0 &&
+              memcmp(v.arr, "01", 2) == 0, "n=%zu", n);
+    v_status_t st = v_intern_get_st(v, p, 0);
+    CHECK_MSG("v_intern_get_st", st.bytes == 4 && st.overflow == 2 && v.len == 4,
+              "bytes=%zu overflow=%zu", st.bytes, st.overflow);
+    vs_intern_destroy(p);
+}
+
+/* Values of every length up to 24 hash the tail bytes correctly. */
+static void test_lengths(void) {
+    vs_intern_t *p = vs_intern_create(64);
+    char buf[32];
+    memset(buf, 'z', sizeof buf);
+    int ok = 1;
+    for (size_t n = 0; n <= 24; n++)
+        ok &= vs_intern(p, buf, n) == n;
+    for (size_t n = 1; n <= 24 && ok; n++) {
+        buf[n - 1] = 'y';
+        ok = vs_intern_lookup(p, buf, n) == VS_INTERN_NONE;
+        buf[n - 1] = 'z';
+    }
+    CHECK_MSG("vs_intern lengths", ok && vs_intern_count(p) == 25,
+              "count=%zu", vs_intern_count(p));
+    vs_intern_destroy(p);
+}
+
+int main(int argc, char **argv) {
+    for (int i=1;i<argc;i++)
+        verbose |= (!strcmp(argv[i], "-v") || !strcmp(argv[i], "--verbose"));
+
+    test_basic();
+    test_grow();
+    test_get();
+    test_lengths();
+
+    if (failures == 0)
+        printf(verbose ? "\nAll tests passed.\n" : "\n");
+    else
+        printf("\n%d test(s) failed.\n", failures);
+    return failures;
+}
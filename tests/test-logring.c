@@ -0,0 +1,190 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "vsuite/logring.h"
+
+static int failures = 0;
+static int verbose = 0;
+
+/*
+ * CHECK_MSG() - Provide additional failure context.
+ * @name: Test name displayed on failure.
+ * @expr: Boolean expression indicating success.
+ * @fmt:  printf style format string used when @expr evaluates to false.
+ * @...: Values referenced by @fmt when reporting a failure.
+ */
+#define CHECK_MSG(name, expr, fmt, ...) do { \
+    if (!(expr)) { \
+        printf("\nFAIL: %s - " fmt "\n", name, ##__VA_ARGS__); \
+        failures++; \
+    } else if (verbose) { \
+        printf("PASS: %s\n", name); \
+    } else { \
+        fputc('.', stdout); fflush(stdout); \
+    } \
+} while (0)
+
+enum { THREADS = 4, PER_THREAD = 5000 };
+
+static FILE *log_a;
+
+/* open_log() - Empty temporary file for one test. */
+static FILE *open_log(void) {
+    char path[] = "/tmp/test-logring-XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+        return NULL;
+    unlink(path);
+    return fdopen(fd, "w+");
+}
+
+/* read_log() - Whole contents of @f; caller frees. */
+static char *read_log(FILE *f, size_t *n) {
+    long size = lseek(fileno(f), 0, SEEK_END);
+    char *buf = malloc(size + 1);
+    *n = (size_t)pread(fileno(f), buf, size, 0);
+    buf[*n] = '\0';
+    return buf;
+}
+
+static void *producer(void *arg) {
+    int t = (int)(size_t)arg;
+    for (int i = 0; i < PER_THREAD; i++)
+        vs_log_printf(log_a, "Line %d : thread %d message %05d\n", __LINE__, t, i);
+    return NULL;
+}
+
+/* Every message from every thread arrives once, whole and in its thread's order. */
+static void test_threads(void) {
+    pthread_t th[THREADS];
+    for (size_t t = 0; t < THREADS; t++)
+        pthread_create(&th[t], NULL, producer, (void *)t);
+    for (size_t t = 0; t < THREADS; t++)
+        pthread_join(th[t], NULL);
+    vs_log_flush();
+
+    size_t n;
+    char *buf = read_log(log_a, &n);
+    int next[THREADS] = { 0 };
+    size_t lines = 0, bad = 0;
+    for (char *p = buf, *nl; (nl = strchr(p, '\n')); p = nl + 1) {
+        int line, t, i;
+        lines++;
+        if (sscanf(p, "Line %d : thread %d message %d", &line, &t, &i) != 3 ||
+            t < 0 || t >= THREADS || i != next[t]++)
+            bad++;
+    }
+    CHECK_MSG("vs_log_printf threads", lines == THREADS * PER_THREAD && bad == 0,
+              "%zu lines, %zu out of order", lines, bad);
+    free(buf);
+}
+
+/* A message longer than a slot is cut and marked. */
+static void test_truncate(void) {
+    char big[2 * VS_LOG_SLOT];
+    memset(big, 'x', sizeof big - 1);
+    big[sizeof big - 1] = '\0';
+    size_t before = vs_log_truncated();
+    int r = vs_log_printf(log_a, "%s\n", big);
+    vs_log_flush();
+    size_t n;
+    char *buf = read_log(log_a, &n);
+    CHECK_MSG("vs_log_printf truncate", r == (int)sizeof big &&
+              vs_log_truncated() == before + 1 && n > 4 &&
+              memcmp(buf + n - 4, "...\n", 4) == 0, "tail '%s'", buf + n - 4);
+    free(buf);
+}
+
+/* Another stream is written synchronously. */
+static void test_other_stream(void) {
+    FILE *f = open_log();
+    int r = vs_log_printf(f, "direct %d\n", 42);
+    fflush(f);
+    size_t n;
+    char *buf = read_log(f, &n);
+    CHECK_MSG("vs_log_printf other stream", r == 10 && strcmp(buf, "direct 42\n") == 0,
+              "got '%s'", buf);
+    free(buf);
+    fclose(f);
+}
+
+/* count_lines() - Lines of @f that start with @prefix. */
+static size_t count_lines(FILE *f, const char *prefix) {
+    size_t n, count = 0;
+    char *buf = read_log(f, &n);
+    for (char *p = buf, *nl; (nl = strchr(p, '\n')); p = nl + 1)
+        count += strncmp(p, prefix, strlen(prefix)) == 0;
+    free(buf);
+    return count;
+}
+
+/* Queued messages reach the file when the child exits or aborts. */
+static void test_child(int crash) {
+    FILE *f = open_log();
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        for (int i = 0; i < 1000; i++)
+            vs_log_printf(f, "child %d\n", i);
+        if (crash)
+            abort();
+        exit(0);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    size_t lines = count_lines(f, "child ");
+    if (crash)
+        CHECK_MSG("vs_log abort flush", WIFSIGNALED(status) &&
+                  WTERMSIG(status) == SIGABRT && lines == 1000,
+                  "status %x, %zu lines", status, lines);
+    else
+        CHECK_MSG("vs_log exit flush", WIFEXITED(status) && lines == 1000,
+                  "status %x, %zu lines", status, lines);
+    fclose(f);
+}
+
+/* A child that has not logged yet keeps the handler but not the ring. */
+static void test_fork_signal(void) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        raise(SIGTERM);
+        exit(0);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    CHECK_MSG("vs_log signal after fork", WIFSIGNALED(status) &&
+              WTERMSIG(status) == SIGTERM, "status %x", status);
+}
+
+int main(int argc, char **argv) {
+    for (int i=1;i<argc;i++)
+        verbose |= (!strcmp(argv[i], "-v") || !strcmp(argv[i], "--verbose"));
+
+    log_a = open_log();
+    if (!log_a) {
+        perror("mkstemp");
+        return 1;
+    }
+
+    test_threads();
+    test_truncate();
+    test_other_stream();
+    test_child(0);
+    test_child(1);
+    test_fork_signal();
+
+    vs_log_stop();
+    fclose(log_a);
+
+    if (failures == 0)
+        printf(verbose ? "\nAll tests passed.\n" : "\n");
+    else
+        printf("\n%d test(s) failed.\n", failures);
+    return failures;
+}
@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vsuite/map.h"
+
+static int failures = 0;
+static int verbose = 0;
+
+/*
+ * CHECK_MSG() - Provide additional failure context.
+ * @name: Test name displayed on failure.
+ * @expr: Boolean expression indicating success.
+ * @fmt:  printf style format string used when @expr evaluates to false.
+ * @...: Values referenced by @fmt when reporting a failure.
+ */
+#define CHECK_MSG(name, expr, fmt, ...) do { \
+    if (!(expr)) { \
+        printf("\nFAIL: %s - " fmt "\n", name, ##__VA_ARGS__); \
+        failures++; \
+    } else if (verbose) { \
+        printf("PASS: %s\n", name); \
+    } else { \
+        fputc('.', stdout); fflush(stdout); \
+    } \
+} while (0)
+
+#define SET(v, s) do { (v).len = (unsigned short)strlen(s); memcpy((v).arr, s, (v).len); } while (0)
+
+static void test_basic(void) {
+    vs_map_t *m = vs_map_create(0);
+    VARCHAR(k, 40);
+    int one = 1, two = 2;
+    SET(k, "6100200");
+    k.arr[k.len] = 'x';                 /* past len: not part of the key */
+    CHECK_MSG("vs_map_create", m && vs_map_count(m) == 0, "no map");
+    CHECK_MSG("v_map_put", v_map_put(m, k, &one) == 0 &&
+              v_map_get(m, k) == &one && vs_map_count(m) == 1,
+              "value not stored");
+    CHECK_MSG("vs_map_get bounded", vs_map_get(m, "6100200x", 8) == NULL &&
+              vs_map_get(m, "6100200", 7) == &one, "bytes past len used");
+    CHECK_MSG("v_map_put replace", v_map_put(m, k, &two) == 0 &&
+              v_map_get(m, k) == &two && vs_map_count(m) == 1,
+              "value not replaced");
+    SET(k, "ACCRUED PAYROLL - WAGES");    /* longer than VS_MAP_INLINE */
+    void **cell = v_map_insert(m, k);
+    CHECK_MSG("v_map_insert new", cell && *cell == NULL &&
+              vs_map_count(m) == 2, "new key not added empty");
+    *cell = &one;
+    k.arr[0] = 'X';                     /* the map keeps its own copy */
+    CHECK_MSG("v_map_find long", v_map_find(m, k) == NULL &&
+              *vs_map_find(m, "ACCRUED PAYROLL - WAGES", 23) == &one,
+              "long key not copied");
+    CHECK_MSG("vs_map_erase", vs_map_erase(m, "6100200", 7) == 1 &&
+              vs_map_erase(m, "6100200", 7) == 0 &&
+              vs_map_get(m, "6100200", 7) == NULL && vs_map_count(m) == 1,
+              "erase failed");
+    CHECK_MSG("vs_map empty key", vs_map_put(m, "", 0, &two) == 0 &&
+              vs_map_get(m, "", 0) == &two && vs_map_get(m, "\0", 1) == NULL,
+              "empty key");
+    vs_map_destroy(m);
+}
+
+/* Keys of every length up to 40, with NULs, growth, erase and reinsert. */
+static void test_many(void) {
+    enum { N = 20000 };
+    vs_map_t *m = vs_map_create(16);
+    char key[48];
+    int ok = 1;
+    for (size_t i = 0; i < N && ok; i++) {
+        size_t n = i % 41;
+        memset(key, 0, sizeof key);
+        snprintf(key, sizeof key, "%zu", i);
+        ok = vs_map_put(m, key, n, (void *)(uintptr_t)(i + 1)) == 0;
+    }
+    /* keys of length 0..k collide on "" prefixes; count the distinct ones */
+    size_t distinct = vs_map_count(m);
+    for (size_t i = 0; i < N && ok; i++) {
+        size_t n = i % 41;
+        memset(key, 0, sizeof key);
+        snprintf(key, sizeof key, "%zu", i);
+        void **cell = vs_map_find(m, key, n);
+        ok = cell != NULL;
+        if (!ok)
+            printf("\nmissing %zu", i);
+    }
+    CHECK_MSG("vs_map many", ok && distinct > N / 2, "lost keys, %zu distinct",
+              distinct);
+
+    for (size_t i = 0; i < N; i += 2) {
+        snprintf(key, sizeof key, "k%zu", i);
+        vs_map_put(m, key, strlen(key), (void *)(uintptr_t)i);
+    }
+    for (size_t i = 0; i < N; i += 4) {
+        snprintf(key, sizeof key, "k%zu", i);
+        ok = ok && vs_map_erase(m, key, strlen(key)) == 1;
+    }
+    for (size_t i = 0; i < N && ok; i += 2) {
+        snprintf(key, sizeof key, "k%zu", i);
+        void *v = vs_map_get(m, key, strlen(key));
+        ok = i % 4 ? v == (void *)(uintptr_t)i : v == NULL;
+    }
+    CHECK_MSG("vs_map erase many", ok, "wrong keys after erase");
+
+    size_t it = 0, seen = 0;
+    for (vs_map_slot_t *e; (e = vs_map_next(m, &it)); seen++)
+        ok = ok && vs_map_get(m, vs_map_key(e), e->len) == e->value;
+    CHECK_MSG("vs_map_next", ok && seen == vs_map_count(m),
+              "walked %zu of %zu", seen, vs_map_count(m));
+    vs_map_destroy(m);
+}
+
+/* Insert and erase churn in a small table exercises the same-size rebuild. */
+static void test_churn(void) {
+    vs_map_t *m = vs_map_create(8);
+    char key[16];
+    int ok = 1;
+    for (int i = 0; i < 100000 && ok; i++) {
+        int n = snprintf(key, sizeof key, "C%d", i);
+        ok = vs_map_put(m, key, (size_t)n, m) == 0;
+        if (i >= 4) {
+            n = snprintf(key, sizeof key, "C%d", i - 4);
+            ok = ok && vs_map_erase(m, key, (size_t)n) == 1;
+        }
+    }
+    CHECK_MSG("vs_map churn", ok && vs_map_count(m) == 4 && m->mask + 1 <= 64,
+              "count %zu slots %zu", vs_map_count(m), m->mask + 1);
+    vs_map_destroy(m);
+}
+
+static void test_build(void) {
+    VARCHAR(acct[6], 24);
+    SET(acct[0], "6100200");
+    SET(acct[1], "6100300");
+    SET(acct[2], "6100200");            /* duplicate: first row wins */
+    SET(acct[3], "ACCOUNTS PAYABLE TRADE");
+    SET(acct[4], "");
+    SET(acct[5], "1000");
+    vs_map_t *m = vs_map_create(0);
+    CHECK_MSG("vb_map_build", vb_map_build(m, acct, 6) == 0 &&
+              vs_map_count(m) == 5, "count %zu", vs_map_count(m));
+    void **r0 = vs_map_find(m, "6100200", 7);
+    void **r3 = v_map_find(m, acct[3]);
+    void **r4 = vs_map_find(m, "", 0);
+    CHECK_MSG("vb_map_build rows", r0 && vs_map_row(*r0) == 0 &&
+              r3 && vs_map_row(*r3) == 3 && r4 && vs_map_row(*r4) == 4,
+              "wrong row index");
+    vs_map_destroy(m);
+}
+
+int main(int argc, char **argv) {
+    for (int i=1;i<argc;i++)
+        verbose |= (!strcmp(argv[i], "-v") || !strcmp(argv[i], "--verbose"));
+
+    test_basic();
+    test_many();
+    test_churn();
+    test_build();
+
+    if (failures == 0)
+        printf(verbose ? "\nAll tests passed.\n" : "\n");
+    else
+        printf("\n%d test(s) failed.\n", failures);
+    return failures;
+}
@@ -0,0 +1,260 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "vsuite/number.h"
+
+static int failures = 0;
+static int verbose = 0;
+
+/*
+ * CHECK_MSG() - Provide additional failure context.
+ * @name: Test name displayed on failure.
+ * @expr: Boolean expression indicating success.
+ * @fmt:  printf style format string used when @expr evaluates to false.
+ * @...: Values referenced by @fmt when reporting a failure.
+ */
+#define CHECK_MSG(name, expr, fmt, ...) do { \
+    if (!(expr)) { \
+        printf("\nFAIL: %s - " fmt "\n", name, ##__VA_ARGS__); \
+        failures++; \
+    } else if (verbose) { \
+        printf("PASS: %s\n", name); \
+    } else { \
+        fputc('.', stdout); fflush(stdout); \
+    } \
+} while (0)
+
+/* Load @s into a VARCHAR(20) whose unused bytes are junk, as after a fetch. */
+#define SET(v, s) do {                                   \
+    memset((v).arr, '7', sizeof (v).arr);                \
+    (v).len = (unsigned short)strlen(s);                 \
+    memcpy((v).arr, s, (v).len);                         \
+} while (0)
+
+static void test_long(void) {
+    VARCHAR(v, 20);
+    long x;
+    static const struct { const char *in; v_num_status_t st; long out; } cases[] = {
+        { "0", V_NUM_OK, 0 },
+        { "8744", V_NUM_OK, 8744 },
+        { "  -42 ", V_NUM_OK, -42 },
+        { "+12345678", V_NUM_OK, 12345678 },
+        { "123456789012", V_NUM_OK, 123456789012L },
+        { "0000000000000000001", V_NUM_OK, 1 },
+        { "9223372036854775807", V_NUM_OK, LONG_MAX },
+        { "-9223372036854775808", V_NUM_OK, LONG_MIN },
+        { "9223372036854775808", V_NUM_RANGE, LONG_MAX },
+        { "-9223372036854775809", V_NUM_RANGE, LONG_MIN },
+        { "99999999999999999999", V_NUM_RANGE, LONG_MAX },
+        { "", V_NUM_EMPTY, 0 },
+        { "   ", V_NUM_EMPTY, 0 },
+        { "-", V_NUM_INVALID, 0 },
+        { "12a", V_NUM_INVALID, 0 },
+        { "1 2", V_NUM_INVALID, 0 },
+        { "440.9", V_NUM_INVALID, 0 },
+        { "8744\xff\xff", V_NUM_INVALID, 0 },
+        { "--1", V_NUM_INVALID, 0 },
+        { "12345678:", V_NUM_INVALID, 0 },
+        { "1234567/", V_NUM_INVALID, 0 },
+    };
+    for (size_t i = 0; i < sizeof cases / sizeof cases[0]; i++) {
+        SET(v, cases[i].in);
+        x = 99;
+        v_num_status_t st = v_to_long(v, &x);
+        CHECK_MSG("v_to_long", st == cases[i].st && x == cases[i].out,
+                  "'%s' -> st=%d x=%ld", cases[i].in, st, x);
+    }
+}
+
+static void test_ulong(void) {
+    VARCHAR(v, 20);
+    unsigned long x;
+    SET(v, "18446744073709551615");
+    CHECK_MSG("v_to_ulong max", v_to_ulong(v, &x) == V_NUM_OK &&
+              x == ULONG_MAX, "x=%lu", x);
+    SET(v, "18446744073709551616");
+    CHECK_MSG("v_to_ulong range", v_to_ulong(v, &x) == V_NUM_RANGE &&
+              x == ULONG_MAX, "x=%lu", x);
+    SET(v, "-1");
+    CHECK_MSG("v_to_ulong negative", v_to_ulong(v, &x) == V_NUM_RANGE &&
+              x == 0, "x=%lu", x);
+    SET(v, "-0");
+    CHECK_MSG("v_to_ulong -0", v_to_ulong(v, &x) == V_NUM_OK && x == 0,
+              "x=%lu", x);
+    SET(v, "x");
+    CHECK_MSG("v_to_ulong invalid", v_to_ulong(v, &x) == V_NUM_INVALID,
+              "x=%lu", x);
+}
+
+static void test_decimal(void) {
+    VARCHAR(v, 20);
+    long x;
+    static const struct {
+        const char *in; unsigned scale; v_num_status_t st; long out;
+    } cases[] = {
+        { "440.9", 2, V_NUM_OK, 44090 },
+        { "440.9", 0, V_NUM_OK, 441 },
+        { "-440.4", 0, V_NUM_OK, -440 },
+        { "-440.5", 0, V_NUM_OK, -441 },
+        { "1.005", 2, V_NUM_OK, 101 },
+        { "1.0049999", 2, V_NUM_OK, 100 },
+        { ".5", 1, V_NUM_OK, 5 },
+        { "5.", 3, V_NUM_OK, 5000 },
+        { " 12345678.12345678 ", 8, V_NUM_OK, 1234567812345678L },
+        { "0.99999", 4, V_NUM_OK, 10000 },
+        { "8744", 2, V_NUM_OK, 874400 },
+        { ".", 2, V_NUM_INVALID, 0 },
+        { "1.2.3", 2, V_NUM_INVALID, 0 },
+        { "1.2x", 4, V_NUM_INVALID, 0 },
+        { "1.23x", 1, V_NUM_INVALID, 0 },
+        { "92233720368547758.08", 2, V_NUM_RANGE, LONG_MAX },
+        { "1", 19, V_NUM_RANGE, 0 },
+    };
+    for (size_t i = 0; i < sizeof cases / sizeof cases[0]; i++) {
+        SET(v, cases[i].in);
+        x = 99;
+        v_num_status_t st = v_to_decimal(v, cases[i].scale, &x);
+        CHECK_MSG("v_to_decimal", st == cases[i].st && x == cases[i].out,
+                  "'%s' scale %u -> st=%d x=%ld", cases[i].in,
+                  cases[i].scale, st, x);
+    }
+}
+
+/*
+ * Every digit string up to 19 digits, at every offset, in buffers that do
+ * and do not leave room for the eight byte loads, against strtol().
+ */
+static void test_swar_positions(void) {
+    char buf[40];
+    int ok = 1;
+    for (size_t len = 1; len <= 18 && ok; len++) {
+        for (size_t off = 0; off < 10 && ok; off++) {
+            for (size_t cap_extra = 0; cap_extra < 9 && ok; cap_extra++) {
+                memset(buf, 'x', sizeof buf);
+                for (size_t k = 0; k < len; k++)
+                    buf[off + k] = (char)('0' + (k * 7 + off) % 10);
+                char tmp[40];
+                memcpy(tmp, buf + off, len);
+                tmp[len] = '\0';
+                long want = strtol(tmp, NULL, 10), got = -1;
+                v_num_status_t st = vs_to_long(buf + off, len,
+                                               len + cap_extra, &got);
+                ok = st == V_NUM_OK && got == want;
+                if (!ok)
+                    printf("\nlen=%zu off=%zu cap+%zu: %ld != %ld", len, off,
+                           cap_extra, got, want);
+            }
+        }
+    }
+    CHECK_MSG("vs_to_long positions", ok, "SWAR path disagrees with strtol");
+}
+
+/* Formatting matches snprintf for every kind of value. */
+static void test_from_int(void) {
+    VARCHAR(v, 24);
+    char want[32];
+    static const long long vals[] = {
+        0, 7, -7, 10, 99, 100, -100, 4294967295LL, 4294967296LL,
+        123456789012LL, LLONG_MAX, LLONG_MIN,
+    };
+    int ok = 1;
+    for (size_t i = 0; i < sizeof vals / sizeof vals[0] && ok; i++) {
+        size_t n = v_from_int(v, vals[i]);
+        snprintf(want, sizeof want, "%lld", vals[i]);
+        ok = n == strlen(want) && v.len == n && varchar_overflow == 0 &&
+             memcmp(v.arr, want, n) == 0;
+        if (!ok)
+            printf("\n%lld -> '%.*s'", vals[i], (int)v.len, v.arr);
+    }
+    CHECK_MSG("v_from_int", ok, "differs from snprintf");
+
+    size_t n = v_from_uint(v, ULLONG_MAX);
+    CHECK_MSG("v_from_uint", n == 20 &&
+              memcmp(v.arr, "18446744073709551615", 20) == 0, "n=%zu", n);
+
+    ok = 1;
+    for (unsigned long long x = 1, d = 1; d <= 20 && ok; x *= 10, d++) {
+        for (long long delta = -1; delta <= 1 && ok; delta++) {
+            unsigned long long y = x + delta;
+            n = v_from_uint(v, y);
+            snprintf(want, sizeof want, "%llu", y);
+            ok = n == strlen(want) && memcmp(v.arr, want, n) == 0;
+        }
+    }
+    CHECK_MSG("v_from_uint powers", ok, "wrong digits near a power of ten");
+}
+
+static void test_from_int_pad(void) {
+    VARCHAR(v, 8);
+    size_t n = v_from_int_pad(v, 42, 6);
+    CHECK_MSG("v_from_int_pad", n == 6 && memcmp(v.arr, "000042", 6) == 0,
+              "n=%zu", n);
+    n = v_from_int_pad(v, -42, 6);
+    CHECK_MSG("v_from_int_pad neg", n == 6 && memcmp(v.arr, "-00042", 6) == 0,
+              "n=%zu", n);
+    n = v_from_int_pad(v, 1234567, 3);
+    CHECK_MSG("v_from_int_pad wide", n == 7 && memcmp(v.arr, "1234567", 7) == 0,
+              "n=%zu", n);
+    n = v_from_int_pad(v, 5, 10);
+    CHECK_MSG("v_from_int_pad overflow", n == 8 && v.len == 8 &&
+              varchar_overflow == 2 && memcmp(v.arr, "00000000", 8) == 0,
+              "n=%zu overflow=%zu", n, varchar_overflow);
+}
+
+static void test_from_decimal(void) {
+    VARCHAR(v, 24);
+    VARCHAR(narrow, 4);
+    static const struct { long long in; unsigned scale; const char *out; } cases[] = {
+        { 44090, 2, "440.90" },
+        { -5, 2, "-0.05" },
+        { 5, 3, "0.005" },
+        { 0, 2, "0.00" },
+        { 100, 2, "1.00" },
+        { -123, 0, "-123" },
+        { LLONG_MIN, 18, "-9.223372036854775808" },
+        { 1, 19, "0.0000000000000000001" },
+    };
+    int ok = 1;
+    for (size_t i = 0; i < sizeof cases / sizeof cases[0] && ok; i++) {
+        size_t n = v_from_decimal(v, cases[i].in, cases[i].scale);
+        ok = n == strlen(cases[i].out) && v.len == n &&
+             memcmp(v.arr, cases[i].out, n) == 0 && varchar_overflow == 0;
+        if (!ok)
+            printf("\n%lld/%u -> '%.*s'", cases[i].in, cases[i].scale,
+                   (int)v.len, v.arr);
+    }
+    CHECK_MSG("v_from_decimal", ok, "wrong text");
+
+    /* Parsing the text back gives the same value. */
+    long back = 0;
+    v_from_decimal(v, -123456789, 4);
+    CHECK_MSG("v_from_decimal round trip",
+              v_to_decimal(v, 4, &back) == V_NUM_OK && back == -123456789,
+              "back=%ld", back);
+
+    v_status_t st = v_from_decimal_st(narrow, -5, 2);
+    CHECK_MSG("v_from_decimal_st overflow", st.bytes == 4 && st.overflow == 1 &&
+              narrow.len == 4 && memcmp(narrow.arr, "-0.0", 4) == 0,
+              "bytes=%zu overflow=%zu", st.bytes, st.overflow);
+}
+
+int main(int argc, char **argv) {
+    for (int i=1;i<argc;i++)
+        verbose |= (!strcmp(argv[i], "-v") || !strcmp(argv[i], "--verbose"));
+
+    test_long();
+    test_ulong();
+    test_decimal();
+    test_swar_positions();
+    test_from_int();
+    test_from_int_pad();
+    test_from_decimal();
+
+    if (failures == 0)
+        printf(verbose ? "\nAll tests passed.\n" : "\n");
+    else
+        printf("\n%d test(s) failed.\n", failures);
+    return failures;
+}
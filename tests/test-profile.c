@@ -0,0 +1,150 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define VSUITE_PROFILE
+#include "vsuite/varchar.h"
+#include "vsuite/zvarchar.h"
+#include "vsuite/number.h"
+
+static int failures = 0;
+static int verbose = 0;
+
+/*
+ * CHECK_MSG() - Provide additional failure context.
+ * @name: Test name displayed on failure.
+ * @expr: Boolean expression indicating success.
+ * @fmt:  printf style format string used when @expr evaluates to false.
+ * @...: Values referenced by @fmt when reporting a failure.
+ */
+#define CHECK_MSG(name, expr, fmt, ...) do { \
+    if (!(expr)) { \
+        printf("\nFAIL: %s - " fmt "\n", name, ##__VA_ARGS__); \
+        failures++; \
+    } else if (verbose) { \
+        printf("PASS: %s\n", name); \
+    } else { \
+        fputc('.', stdout); fflush(stdout); \
+    } \
+} while (0)
+
+/* hist_total() - Samples in the histogram of @s. */
+static uint64_t hist_total(const vs_profile_site_t *s) {
+    uint64_t n = 0;
+    for (int b = 0; b < VS_PROFILE_BUCKETS; b++)
+        n += s->hist[b];
+    return n;
+}
+
+/* CHECK_SITE() - @macro at @line was sampled @n times, consistently. */
+#define CHECK_SITE(name, macro, line, n) do { \
+    vs_profile_site_t *__s = vs_profile_find(macro, __FILE__, line); \
+    CHECK_MSG(name, __s && __s->calls == (n) && hist_total(__s) == (n), \
+              "calls %llu hist %llu", __s ? (unsigned long long)__s->calls : 0ULL, \
+              __s ? (unsigned long long)hist_total(__s) : 0ULL); \
+} while (0)
+
+/* Every instrumented family records its own site. */
+static void test_sites(void) {
+    VARCHAR(dst, 16);
+    VARCHAR(src, 16);
+    memcpy(src.arr, "  1234  ", 8);
+    src.len = 8;
+    dst.len = 0;
+    int line;
+
+    line = __LINE__; for (int i = 0; i < 100; i++) v_copy(dst, src);
+    CHECK_SITE("v_copy", "v_copy", line, 100);
+    dst.len = 0;
+    line = __LINE__; for (int i = 0; i < 3; i++) v_strcat(dst, src);
+    CHECK_SITE("v_strcat", "v_strcat", line, 3);
+    line = __LINE__; for (int i = 0; i < 5; i++) zv_copy(dst, src);
+    CHECK_SITE("zv_copy", "zv_copy", line, 5);
+    line = __LINE__; v_trim(dst);
+    CHECK_SITE("v_trim", "v_trim", line, 1);
+    line = __LINE__; zv_zsetlen(dst);
+    CHECK_SITE("zv_zsetlen", "zv_zsetlen", line, 1);
+    line = __LINE__; v_sprintf(dst, "%d", 42);
+    CHECK_SITE("v_sprintf", "v_sprintf", line, 1);
+
+    long out = 0;
+    line = __LINE__; v_num_status_t st = v_to_long(dst, &out);
+    CHECK_SITE("v_to_long", "v_to_long", line, 1);
+    CHECK_MSG("v_to_long value", st == V_NUM_OK && out == 42, "out %ld", out);
+    line = __LINE__; size_t n = v_from_int(dst, -7);
+    CHECK_SITE("v_from_int", "v_from_int", line, 1);
+    CHECK_MSG("v_from_int value", n == 2 && !memcmp(dst.arr, "-7", 2), "n %zu", n);
+}
+
+/* Quantiles are bucket upper bounds. */
+static void test_quantile(void) {
+    vs_profile_site_t s = { "x", "y", 1, 100, 0, { 0 } };
+    s.hist[0] = 10;
+    s.hist[4] = 80;
+    s.hist[9] = 10;
+    CHECK_MSG("vs_profile_quantile", vs_profile_quantile(&s, 0.05) == 0 &&
+              vs_profile_quantile(&s, 0.50) == 16 &&
+              vs_profile_quantile(&s, 0.90) == 16 &&
+              vs_profile_quantile(&s, 0.99) == 512,
+              "p50 %llu p99 %llu", (unsigned long long)vs_profile_quantile(&s, 0.50),
+              (unsigned long long)vs_profile_quantile(&s, 0.99));
+}
+
+/* The CSV lists reached sites only, slowest total first. */
+static void test_dump(void) {
+    size_t all, reached = 0;
+    vs_profile_site_t *s = vs_profile_sites(&all);
+    for (size_t i = 0; i < all; i++)
+        reached += s[i].calls != 0;
+
+    FILE *f = tmpfile();
+    size_t rows = vs_profile_dump_csv(f);
+    rewind(f);
+    char line[1024];
+    size_t lines = 0;
+    double prev = 1e300;
+    int sorted = 1;
+    while (fgets(line, sizeof line, f)) {
+        if (lines++ == 0)
+            continue;
+        char *p = line;
+        for (int c = 0; c < 4 && p; c++)
+            p = strchr(p + 1, ',');
+        double total = p ? strtod(p + 1, NULL) : -1;
+        sorted &= total <= prev;
+        prev = total;
+    }
+    fclose(f);
+    CHECK_MSG("vs_profile_dump_csv", rows == reached && lines == reached + 1 && sorted,
+              "rows %zu lines %zu reached %zu sorted %d", rows, lines, reached, sorted);
+
+    f = tmpfile();
+    rows = vs_profile_dump_json(f);
+    rewind(f);
+    char buf[16384];
+    size_t len = fread(buf, 1, sizeof buf - 1, f);
+    buf[len] = '\0';
+    fclose(f);
+    size_t objects = 0;
+    for (char *p = buf; (p = strstr(p, "{\"macro\": ")); p++)
+        objects++;
+    CHECK_MSG("vs_profile_dump_json", rows == reached && objects == reached &&
+              !strncmp(buf, "{\"ns_per_tick\": ", 16) &&
+              strstr(buf, "\"macro\": \"v_to_long\""),
+              "json:\n%s", buf);
+}
+
+int main(int argc, char **argv) {
+    for (int i=1;i<argc;i++)
+        verbose |= (!strcmp(argv[i], "-v") || !strcmp(argv[i], "--verbose"));
+
+    test_sites();
+    test_quantile();
+    test_dump();
+
+    if (failures == 0)
+        printf(verbose ? "\nAll tests passed.\n" : "\n");
+    else
+        printf("\n%d test(s) failed.\n", failures);
+    return failures;
+}
@@ -37,11 +37,19 @@ static void test_vp_copy(void) {
  */
 static void test_vp_copy_overflow(void) {
     VARCHAR(dst, 4);
-    const char *src = "abcd";
+    const char *src = "abcde";
     vp_copy(dst, src);
     CHECK("vp_copy  overflow", dst.len == 0); /* no data copied */
 }
 
+/* A VARCHAR holds no terminator, so a source of exactly its size fits. */
+static void test_vp_copy_exact(void) {
+    VARCHAR(dst, 4);
+    const char *src = "abcd";
+    vp_copy(dst, src);
+    CHECK("vp_copy  exact", dst.len == 4 && memcmp(dst.arr, "abcd", 4) == 0);
+}
+
 /* Copying an empty string should yield an empty VARCHAR. */
 static void test_vp_copy_empty(void) {
     VARCHAR(dst, 4);
@@ -244,6 +252,7 @@ int main(int argc, char **argv) {
 
     test_vp_copy();
     test_vp_copy_overflow();
+    test_vp_copy_exact();
     test_vp_copy_empty();
     test_vp_copy_large();
 
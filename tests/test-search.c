@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vsuite/search.h"
+
+static int failures = 0;
+static int verbose = 0;
+
+/*
+ * CHECK_MSG() - Provide additional failure context.
+ * @name: Test name displayed on failure.
+ * @expr: Boolean expression indicating success.
+ * @fmt:  printf style format string used when @expr evaluates to false.
+ * @...: Values referenced by @fmt when reporting a failure.
+ */
+#define CHECK_MSG(name, expr, fmt, ...) do { \
+    if (!(expr)) { \
+        printf("\nFAIL: %s - " fmt "\n", name, ##__VA_ARGS__); \
+        failures++; \
+    } else if (verbose) { \
+        printf("PASS: %s\n", name); \
+    } else { \
+        fputc('.', stdout); fflush(stdout); \
+    } \
+} while (0)
+
+#define SET(v, s) do { (v).len = (unsigned short)strlen(s); memcpy((v).arr, s, (v).len); } while (0)
+
+static size_t naive_strstr(const char *h, size_t hn, const char *n, size_t nn) {
+    for (size_t i = 0; i + nn <= hn; i++)
+        if (memcmp(h + i, n, nn) == 0)
+            return i;
+    return VS_NOT_FOUND;
+}
+
+static void test_index(void) {
+    VARCHAR(v, 40);
+    SET(v, "GL|0100|R123|6100200");
+    v.arr[v.len] = '|';                 /* past len: must not be found */
+    CHECK_MSG("v_index", v_index(v, '|') == 2 && v_index(v, 'R') == 8,
+              "got %ld", v_index(v, '|'));
+    CHECK_MSG("v_rindex", v_rindex(v, '|') == 12 && v_rindex(v, 'G') == 0,
+              "got %ld", v_rindex(v, '|'));
+    CHECK_MSG("v_index none", v_index(v, 'x') == -1 && v_rindex(v, 'x') == -1,
+              "found a byte that is not there");
+    v.len = 0;
+    CHECK_MSG("v_index empty", v_index(v, '|') == -1 && v_rindex(v, '|') == -1,
+              "found a byte in an empty VARCHAR");
+    v.len = 6;
+    v.arr[3] = '\0';
+    CHECK_MSG("v_index nul", v_index(v, '\0') == 3 && v_rindex(v, '\0') == 3,
+              "got %ld", v_index(v, '\0'));
+}
+
+/* Every position and length through the small, vector and memchr paths. */
+static void test_index_positions(void) {
+    char buf[200];
+    int ok = 1;
+    for (size_t n = 0; n <= 150 && ok; n++) {
+        memset(buf, 'a', sizeof buf);
+        buf[n] = 'x';                   /* just past the end */
+        ok = vs_index(buf, n, 'x') == VS_NOT_FOUND &&
+             vs_rindex(buf, n, 'x') == VS_NOT_FOUND;
+        buf[n] = 'a';
+        for (size_t p = 0; p < n && ok; p++) {
+            buf[p] = 'x';
+            ok = vs_index(buf, n, 'x') == p && vs_rindex(buf, n, 'x') == p;
+            if (p + 1 < n) {
+                buf[n - 1] = 'x';
+                ok = ok && vs_index(buf, n, 'x') == p &&
+                     vs_rindex(buf, n, 'x') == n - 1;
+                buf[n - 1] = 'a';
+            }
+            buf[p] = 'a';
+            if (!ok)
+                printf("\nn=%zu p=%zu", n, p);
+        }
+    }
+    CHECK_MSG("vs_index positions", ok, "wrong offset");
+}
+
+static void test_strstr(void) {
+    VARCHAR(v, 64);
+    VARCHAR(sub, 16);
+    SET(v, "ACCRUED PAYROLL - WAGES PAYABLE");
+    SET(sub, "PAY");
+    CHECK_MSG("v_strstr", v_strstr(v, sub) == 8, "got %ld", v_strstr(v, sub));
+    CHECK_MSG("vp_strstr", vp_strstr(v, "WAGES") == 18 &&
+              vp_strstr(v, "wages") == -1 && vp_strstr(v, "") == 0,
+              "got %ld", vp_strstr(v, "WAGES"));
+    v.len = 10;
+    CHECK_MSG("v_strstr bounded", vp_strstr(v, "PAYROLL") == -1 &&
+              vp_strstr(v, "PA") == 8, "matched past len");
+    sub.len = 0;
+    CHECK_MSG("v_strstr empty", v_strstr(v, sub) == 0, "got %ld",
+              v_strstr(v, sub));
+}
+
+/* Random haystacks over small alphabets against a naive search. */
+static void test_strstr_random(void) {
+    char h[300], nd[80];
+    unsigned seed = 12345;
+    int ok = 1;
+    for (int iter = 0; iter < 20000 && ok; iter++) {
+        seed = seed * 1103515245u + 12345u;
+        int alpha = 2 + (seed >> 16) % 3;
+        size_t hn = (seed >> 8) % 280;
+        seed = seed * 1103515245u + 12345u;
+        size_t nn = 1 + (seed >> 16) % 70;
+        for (size_t i = 0; i < hn; i++) {
+            seed = seed * 1103515245u + 12345u;
+            h[i] = (char)('a' + (seed >> 16) % alpha);
+        }
+        seed = seed * 1103515245u + 12345u;
+        if (hn >= nn && (seed >> 16) % 2) {
+            /* take the needle from the haystack so it is found */
+            size_t at = (seed >> 8) % (hn - nn + 1);
+            memcpy(nd, h + at, nn);
+        } else {
+            for (size_t i = 0; i < nn; i++) {
+                seed = seed * 1103515245u + 12345u;
+                nd[i] = (char)('a' + (seed >> 16) % alpha);
+            }
+        }
+        size_t got = vs_strstr(h, hn, nd, nn);
+        size_t want = naive_strstr(h, hn, nd, nn);
+        ok = got == want;
+        if (!ok)
+            printf("\nhn=%zu nn=%zu got=%zu want=%zu", hn, nn, got, want);
+    }
+    CHECK_MSG("vs_strstr random", ok, "differs from the naive search");
+
+    /* A periodic long needle, the two-way worst case. */
+    static char big[4096], needle[100];
+    memset(big, 'a', sizeof big);
+    memset(needle, 'a', sizeof needle);
+    needle[99] = 'b';
+    CHECK_MSG("vs_strstr periodic", vs_strstr(big, sizeof big, needle, 100) ==
+              VS_NOT_FOUND, "found a missing needle");
+    big[4000] = 'b';
+    CHECK_MSG("vs_strstr periodic hit",
+              vs_strstr(big, sizeof big, needle, 100) == 3901,
+              "got %zu", vs_strstr(big, sizeof big, needle, 100));
+}
+
+int main(int argc, char **argv) {
+    for (int i=1;i<argc;i++)
+        verbose |= (!strcmp(argv[i], "-v") || !strcmp(argv[i], "--verbose"));
+
+    test_index();
+    test_index_positions();
+    test_strstr();
+    test_strstr_random();
+
+    if (failures == 0)
+        printf(verbose ? "\nAll tests passed.\n" : "\n");
+    else
+        printf("\n%d test(s) failed.\n", failures);
+    return failures;
+}
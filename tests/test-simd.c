@@ -0,0 +1,349 @@
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "vsuite/simd.h"
+#include "vsuite/zvarchar.h"
+
+static int failures = 0;
+static int verbose = 0;
+
+/*
+ * CHECK_MSG() - Provide additional failure context.
+ * @name: Test name displayed on failure.
+ * @expr: Boolean expression indicating success.
+ * @fmt:  printf style format string used when @expr evaluates to false.
+ * @...: Values referenced by @fmt when reporting a failure.
+ */
+#define CHECK_MSG(name, expr, fmt, ...) do { \
+    if (!(expr)) { \
+        printf("\nFAIL: %s - " fmt "\n", name, ##__VA_ARGS__); \
+        failures++; \
+    } else if (verbose) { \
+        printf("PASS: %s\n", name); \
+    } else { \
+        fputc('.', stdout); fflush(stdout); \
+    } \
+} while (0)
+
+/* Byte-at-a-time reference used to validate the vector kernels. */
+static char *ref_find_nul(char *s, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        if (s[i] == '\0')
+            return s + i;
+    return NULL;
+}
+
+/*
+ * Place a single terminator at every position of every length up to 300 so
+ * the small-buffer words, the SSE2 loop, the AVX2 loop and every overlapping
+ * tail load are all exercised.
+ */
+static void test_find_nul_positions(void) {
+    enum { MAX = 300 };
+    static char buf[MAX];
+    size_t bad_n = 0, bad_pos = 0;
+    int ok = 1;
+    for (size_t n = 0; n <= MAX && ok; n++) {
+        memset(buf, 'x', MAX);
+        if (vs_find_nul(buf, n) != NULL) {
+            ok = 0; bad_n = n; bad_pos = n;
+            break;
+        }
+        for (size_t pos = 0; pos < n; pos++) {
+            memset(buf, 'x', MAX);
+            buf[pos] = '\0';
+            if (pos + 3 < n)
+                buf[pos + 3] = '\0';     /* later NULs must not win */
+            if (vs_find_nul(buf, n) != ref_find_nul(buf, n)) {
+                ok = 0; bad_n = n; bad_pos = pos;
+                break;
+            }
+        }
+    }
+    CHECK_MSG("vs_find_nul positions", ok,
+              "mismatch at n=%zu pos=%zu", bad_n, bad_pos);
+}
+
+/* High-bit bytes must not be mistaken for terminators by the SWAR words. */
+static void test_find_nul_high_bytes(void) {
+    char buf[24];
+    memset(buf, 0x80, sizeof buf);
+    CHECK_MSG("vs_find_nul 0x80", vs_find_nul(buf, sizeof buf) == NULL,
+              "unexpected hit");
+    memset(buf, 0x01, sizeof buf);
+    buf[9] = '\0';
+    CHECK_MSG("vs_find_nul 0x01", vs_find_nul(buf, sizeof buf) == buf + 9,
+              "got offset %td", vs_find_nul(buf, sizeof buf) - buf);
+}
+
+/*
+ * Run the scan against buffers that end exactly at a PROT_NONE page.  Any
+ * read past @n faults, proving the tail handling stays within bounds.
+ */
+static void test_find_nul_guard_page(void) {
+    long page = sysconf(_SC_PAGESIZE);
+    char *map = mmap(NULL, 2 * page, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (map == MAP_FAILED) {
+        CHECK_MSG("vs_find_nul guard", 0, "mmap failed");
+        return;
+    }
+    mprotect(map + page, page, PROT_NONE);
+    int ok = 1;
+    for (size_t n = 0; n <= 200; n++) {
+        char *s = map + page - n;
+        memset(s, 'y', n);
+        if (vs_find_nul(s, n) != NULL)
+            ok = 0;
+    }
+    munmap(map, 2 * page);
+    CHECK_MSG("vs_find_nul guard", ok, "terminator reported in clean buffer");
+}
+
+/* zv_zsetlen now goes through the vector scan; check typical field widths. */
+static void test_zsetlen_widths(void) {
+    VARCHAR(entity, 3); VARCHAR(rpt_class, 7); VARCHAR(amount, 20);
+    VARCHAR(desc, 64);
+    memcpy(entity.arr, "01", 3);
+    memcpy(rpt_class.arr, "000000", 7);
+    memset(amount.arr, 'z', sizeof amount.arr);
+    memcpy(amount.arr, "440.9", 6);
+    memset(desc.arr, '\0', sizeof desc.arr);
+    memcpy(desc.arr, "COGEN - ACCOUNTS PAYABLES", 25);
+    zv_zsetlen(entity);
+    zv_zsetlen(rpt_class);
+    zv_zsetlen(amount);
+    zv_zsetlen(desc);
+    CHECK_MSG("zv_zsetlen widths",
+              entity.len == 2 && rpt_class.len == 6 && amount.len == 5 &&
+              desc.len == 25,
+              "got %u %u %u %u", entity.len, rpt_class.len, amount.len, desc.len);
+}
+
+/*
+ * Compare vs_upper/vs_lower with a plain ASCII reference for every byte value
+ * at every offset of every length up to 100, covering the SWAR words, both
+ * vector widths and the overlapping tail stores.
+ */
+static void test_case_all_bytes(void) {
+    enum { MAX = 100 };
+    char buf[MAX], up[MAX], lo[MAX];
+    int ok = 1;
+    size_t bad_n = 0;
+    for (size_t n = 0; n <= MAX && ok; n++) {
+        for (size_t i = 0; i < n; i++) {
+            unsigned char c = (unsigned char)((i * 37 + n * 11) & 0xff);
+            buf[i] = (char)c;
+            up[i] = (char)(c >= 'a' && c <= 'z' ? c - 32 : c);
+        }
+        vs_upper(buf, n);
+        if (memcmp(buf, up, n) != 0) { ok = 0; bad_n = n; break; }
+        for (size_t i = 0; i < n; i++) {
+            unsigned char c = (unsigned char)up[i];
+            lo[i] = (char)(c >= 'A' && c <= 'Z' ? c + 32 : c);
+        }
+        vs_lower(buf, n);
+        if (memcmp(buf, lo, n) != 0) { ok = 0; bad_n = n; break; }
+    }
+    CHECK_MSG("vs_upper/vs_lower bytes", ok, "mismatch at n=%zu", bad_n);
+
+    unsigned char all[256];
+    for (int c = 0; c < 256; c++)
+        all[c] = (unsigned char)c;
+    vs_upper((char *)all, sizeof all);
+    int bad = -1;
+    for (int c = 0; c < 256 && bad < 0; c++)
+        if (all[c] != (c >= 'a' && c <= 'z' ? c - 32 : c))
+            bad = c;
+    CHECK_MSG("vs_upper 0..255", bad < 0, "byte 0x%02x became 0x%02x",
+              bad, bad < 0 ? 0 : all[bad]);
+}
+
+/* Conversion must stop at len and leave the rest of the buffer alone. */
+static void test_case_bounds(void) {
+    VARCHAR(v, 40);
+    memset(v.arr, 'q', sizeof v.arr);
+    v.len = 21;
+    v_upper(v);
+    int ok = 1;
+    for (size_t i = 0; i < sizeof v.arr; i++)
+        if (v.arr[i] != (i < 21 ? 'Q' : 'q'))
+            ok = 0;
+    CHECK_MSG("v_upper bounds", ok, "bytes beyond len were modified");
+}
+
+static int ref_is_space(unsigned char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+           c == '\r';
+}
+
+/*
+ * Put a single non-blank byte at every position of blank-filled buffers of
+ * every length up to 200 and check both span kernels against a byte loop.
+ * The blank filler cycles through the whole whitespace set and the probe
+ * byte cycles through every non-blank value, including the high-bit ones.
+ */
+static void test_span_space_positions(void) {
+    enum { MAX = 200 };
+    static const char ws[] = " \t\n\v\f\r";
+    char buf[MAX];
+    int ok = 1;
+    size_t bad_n = 0, bad_pos = 0;
+    unsigned probe = 0;
+    for (size_t n = 0; n <= MAX && ok; n++) {
+        for (size_t i = 0; i < n; i++)
+            buf[i] = ws[i % 6];
+        if (vs_span_space(buf, n) != n || vs_rspan_space(buf, n) != 0) {
+            ok = 0; bad_n = n; bad_pos = n;
+            break;
+        }
+        for (size_t pos = 0; pos < n; pos++) {
+            unsigned char c;
+            do { c = (unsigned char)(probe++ & 0xff); } while (ref_is_space(c));
+            char save = buf[pos];
+            buf[pos] = (char)c;
+            if (vs_span_space(buf, n) != pos || vs_rspan_space(buf, n) != pos + 1) {
+                ok = 0; bad_n = n; bad_pos = pos;
+                break;
+            }
+            buf[pos] = save;
+        }
+    }
+    CHECK_MSG("vs_span_space positions", ok,
+              "mismatch at n=%zu pos=%zu", bad_n, bad_pos);
+}
+
+/* Both span kernels must stay within the buffer, at either end. */
+static void test_span_space_guard_page(void) {
+    long page = sysconf(_SC_PAGESIZE);
+    char *map = mmap(NULL, 3 * page, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (map == MAP_FAILED) {
+        CHECK_MSG("vs_span_space guard", 0, "mmap failed");
+        return;
+    }
+    mprotect(map, page, PROT_NONE);
+    mprotect(map + 2 * page, page, PROT_NONE);
+    int ok = 1;
+    for (size_t n = 0; n <= 200; n++) {
+        char *lo = map + page;              /* starts right after a guard */
+        char *hi = map + 2 * page - n;      /* ends right before a guard  */
+        memset(lo, ' ', n);
+        memset(hi, ' ', n);
+        if (vs_span_space(lo, n) != n || vs_rspan_space(lo, n) != 0 ||
+            vs_span_space(hi, n) != n || vs_rspan_space(hi, n) != 0)
+            ok = 0;
+    }
+    munmap(map, 3 * page);
+    CHECK_MSG("vs_span_space guard", ok, "wrong result on blank buffer");
+}
+
+/* Fused v_trim on a blank-padded CHAR column wider than a vector. */
+static void test_trim_fused(void) {
+    VARCHAR(v, 80);
+    memset(v.arr, ' ', sizeof v.arr);
+    memcpy(v.arr + 37, "COGEN - ACCOUNTS PAYABLES", 25);
+    v.len = sizeof v.arr;
+    v_trim(v);
+    CHECK_MSG("v_trim fused", v.len == 25 &&
+              memcmp(v.arr, "COGEN - ACCOUNTS PAYABLES", 25) == 0,
+              "len=%u buf='%.*s'", v.len, v.len, v.arr);
+}
+
+/*
+ * vs_copy_fcn() against memmove for every length up to 80, at every source
+ * and destination offset within 8 bytes of each other, so the fixed-size
+ * moves see forward, backward and exact overlap as well as disjoint buffers.
+ * The function is called directly because vs_copy() is plain memmove at -O0.
+ */
+static void test_copy_overlap(void) {
+    enum { MAX = 80, SPAN = MAX + 16 };
+    char ref[SPAN], got[SPAN];
+    int ok = 1;
+    size_t bad_n = 0;
+    for (size_t n = 0; n <= MAX && ok; n++) {
+        for (size_t so = 0; so < 8 && ok; so++) {
+            for (size_t doff = 0; doff < 8; doff++) {
+                for (size_t i = 0; i < SPAN; i++)
+                    ref[i] = got[i] = (char)(i * 7 + 1);
+                memmove(ref + doff, ref + so, n);
+                vs_copy_fcn(got + doff, got + so, n, MAX);
+                if (memcmp(ref, got, SPAN) != 0) { ok = 0; bad_n = n; break; }
+            }
+        }
+    }
+    CHECK_MSG("vs_copy overlap", ok, "mismatch at n=%zu", bad_n);
+}
+
+/* The fixed-size moves must read and write exactly n bytes at either end. */
+static void test_copy_guard_page(void) {
+    long page = sysconf(_SC_PAGESIZE);
+    char *map = mmap(NULL, 3 * page, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (map == MAP_FAILED) {
+        CHECK_MSG("vs_copy guard", 0, "mmap failed");
+        return;
+    }
+    mprotect(map, page, PROT_NONE);
+    mprotect(map + 2 * page, page, PROT_NONE);
+    int ok = 1;
+    for (size_t n = 0; n <= 64; n++) {
+        char *lo = map + page;              /* starts right after a guard */
+        char *hi = map + 2 * page - n;      /* ends right before a guard  */
+        memset(lo, 'c', n);
+        vs_copy_fcn(hi, lo, n, 64);
+        if (memcmp(hi, lo, n) != 0)
+            ok = 0;
+        memset(hi, 'd', n);
+        vs_copy_fcn(lo, hi, n, 64);
+        if (memcmp(hi, lo, n) != 0)
+            ok = 0;
+    }
+    munmap(map, 3 * page);
+    CHECK_MSG("vs_copy guard", ok, "copied bytes differ");
+}
+
+/* Narrow fields take the fixed-size path; a corrupt len still copies. */
+static void test_copy_narrow_fields(void) {
+    VARCHAR(a, 3); VARCHAR(b, 7); VARCHAR(c, 20);
+    memcpy(c.arr, "0123456789abcdefghij", 20);
+    c.len = 20;
+    size_t n = v_copy(b, c);
+    CHECK_MSG("v_copy 20 -> 7", n == 7 && memcmp(b.arr, "0123456", 7) == 0,
+              "n=%zu buf='%.7s'", n, b.arr);
+    b.len = 7;
+    n = v_copy(a, b);
+    CHECK_MSG("v_copy 7 -> 3", n == 3 && memcmp(a.arr, "012", 3) == 0,
+              "n=%zu buf='%.3s'", n, a.arr);
+    c.len = 2;
+    a.len = 1;
+    n = v_strcat(a, c);
+    CHECK_MSG("v_strcat 3", n == 2 && a.len == 3 && memcmp(a.arr, "001", 3) == 0,
+              "n=%zu len=%u buf='%.3s'", n, a.len, a.arr);
+}
+
+int main(int argc, char **argv) {
+    for (int i=1;i<argc;i++)
+        verbose |= (!strcmp(argv[i], "-v") || !strcmp(argv[i], "--verbose"));
+
+    test_find_nul_positions();
+    test_find_nul_high_bytes();
+    test_find_nul_guard_page();
+    test_zsetlen_widths();
+    test_case_all_bytes();
+    test_case_bounds();
+    test_span_space_positions();
+    test_span_space_guard_page();
+    test_trim_fused();
+    test_copy_overlap();
+    test_copy_guard_page();
+    test_copy_narrow_fields();
+
+    if (failures == 0)
+        printf(verbose ? "\nAll tests passed.\n" : "\n");
+    else
+        printf("\n%d test(s) failed.\n", failures);
+    return failures;
+}
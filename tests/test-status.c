@@ -0,0 +1,194 @@
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "vsuite/varchar.h"
+#include "vsuite/zvarchar.h"
+#include "vsuite/pstr.h"
+#include "vsuite/fixed.h"
+
+static int failures = 0;
+static int verbose = 0;
+
+/*
+ * CHECK_MSG() - Provide additional failure context.
+ * @name: Test name displayed on failure.
+ * @expr: Boolean expression indicating success.
+ * @fmt:  printf style format string used when @expr evaluates to false.
+ * @...: Values referenced by @fmt when reporting a failure.
+ */
+#define CHECK_MSG(name, expr, fmt, ...) do { \
+    if (!(expr)) { \
+        printf("\nFAIL: %s - " fmt "\n", name, ##__VA_ARGS__); \
+        failures++; \
+    } else if (verbose) { \
+        printf("PASS: %s\n", name); \
+    } else { \
+        fputc('.', stdout); fflush(stdout); \
+    } \
+} while (0)
+
+/* The _st variants report overflow by value and leave the global alone. */
+static void test_v_status(void) {
+    VARCHAR(src, 8); VARCHAR(dst, 3);
+    memcpy(src.arr, "abcdef", 6);
+    src.len = 6;
+    varchar_overflow = 99;
+    v_status_t st = v_copy_st(dst, src);
+    CHECK_MSG("v_copy_st", st.bytes == 3 && st.overflow == 3 &&
+              memcmp(dst.arr, "abc", 3) == 0 && varchar_overflow == 99,
+              "bytes=%zu overflow=%zu global=%zu", st.bytes, st.overflow,
+              varchar_overflow);
+
+    st = v_strncpy_st(dst, src, 2);
+    CHECK_MSG("v_strncpy_st", st.bytes == 2 && st.overflow == 0,
+              "bytes=%zu overflow=%zu", st.bytes, st.overflow);
+
+    dst.len = 1;
+    st = v_strcat_st(dst, src);
+    CHECK_MSG("v_strcat_st", st.bytes == 2 && st.overflow == 4 && dst.len == 3,
+              "bytes=%zu overflow=%zu len=%u", st.bytes, st.overflow, dst.len);
+
+    dst.len = 0;
+    st = v_strncat_st(dst, src, 2);
+    CHECK_MSG("v_strncat_st", st.bytes == 2 && st.overflow == 0 && dst.len == 2,
+              "bytes=%zu overflow=%zu len=%u", st.bytes, st.overflow, dst.len);
+}
+
+static void test_zv_status(void) {
+    VARCHAR(src, 8); VARCHAR(dst, 4);
+    memcpy(src.arr, "abcdef", 6);
+    src.len = 6;
+    v_status_t st = zv_copy_st(dst, src);
+    CHECK_MSG("zv_copy_st", st.bytes == 3 && st.overflow == 3 &&
+              dst.len == 3 && strcmp(dst.arr, "abc") == 0,
+              "bytes=%zu overflow=%zu len=%u", st.bytes, st.overflow, dst.len);
+
+    st = zv_strncpy_st(dst, src, 1);
+    CHECK_MSG("zv_strncpy_st", st.bytes == 1 && st.overflow == 0 &&
+              strcmp(dst.arr, "a") == 0,
+              "bytes=%zu overflow=%zu", st.bytes, st.overflow);
+
+    st = zv_strcat_st(dst, src);
+    CHECK_MSG("zv_strcat_st", st.bytes == 2 && st.overflow == 4 &&
+              strcmp(dst.arr, "aab") == 0,
+              "bytes=%zu overflow=%zu buf='%s'", st.bytes, st.overflow, dst.arr);
+
+    zv_init(dst);
+    st = zv_strncat_st(dst, src, 2);
+    CHECK_MSG("zv_strncat_st", st.bytes == 2 && st.overflow == 0 &&
+              strcmp(dst.arr, "ab") == 0,
+              "bytes=%zu overflow=%zu buf='%s'", st.bytes, st.overflow, dst.arr);
+}
+
+static void test_interop_status(void) {
+    VARCHAR(v, 4);
+    v_status_t st = vp_copy_st(v, "abcdef");
+    CHECK_MSG("vp_copy_st", st.bytes == 0 && st.overflow == 2 && v.len == 0,
+              "bytes=%zu overflow=%zu", st.bytes, st.overflow);
+
+    st = zvp_copy_st(v, "abcdef");
+    CHECK_MSG("zvp_copy_st", st.bytes == 0 && st.overflow == 3 &&
+              v.len == 0 && v.arr[0] == '\0',
+              "bytes=%zu overflow=%zu", st.bytes, st.overflow);
+
+    char out[3];
+    st = pv_copy_st(out, sizeof out, v);
+    CHECK_MSG("pv_copy_st empty", st.bytes == 0 && st.overflow == 0 &&
+              out[0] == '\0',
+              "bytes=%zu overflow=%zu", st.bytes, st.overflow);
+
+    memcpy(v.arr, "abcd", 4);
+    v.len = 4;
+    st = pv_copy_st(out, sizeof out, v);
+    CHECK_MSG("pv_copy_st", st.bytes == 0 && st.overflow == 2 &&
+              out[0] == '\0',
+              "bytes=%zu overflow=%zu", st.bytes, st.overflow);
+
+    out[0] = 'x';
+    st = pv_copy_st(out, 0, v);
+    CHECK_MSG("pv_copy_st zero cap", st.bytes == 0 && st.overflow == 5 &&
+              out[0] == 'x',
+              "bytes=%zu overflow=%zu", st.bytes, st.overflow);
+
+    char lit[] = "abcde";
+    st = vf_copy_st(v, lit);
+    CHECK_MSG("vf_copy_st", st.bytes == 0 && st.overflow == 1 && v.len == 0,
+              "bytes=%zu overflow=%zu", st.bytes, st.overflow);
+
+    st = zvf_copy_st(v, lit);
+    CHECK_MSG("zvf_copy_st", st.bytes == 0 && st.overflow == 2 &&
+              v.len == 0 && v.arr[0] == '\0',
+              "bytes=%zu overflow=%zu", st.bytes, st.overflow);
+}
+
+/* The classic macros still publish their result through varchar_overflow. */
+static void test_publish(void) {
+    VARCHAR(src, 8); VARCHAR(dst, 3);
+    memcpy(src.arr, "abcde", 5);
+    src.len = 5;
+    size_t n = v_copy(dst, src);
+    CHECK_MSG("v_copy publish", n == 3 && varchar_overflow == 2,
+              "n=%zu overflow=%zu", n, varchar_overflow);
+    src.len = 1;
+    n = v_copy(dst, src);
+    CHECK_MSG("v_copy publish reset", n == 1 && varchar_overflow == 0,
+              "n=%zu overflow=%zu", n, varchar_overflow);
+}
+
+/*
+ * Each worker overflows by a different amount many times and checks that it
+ * only ever sees its own value in varchar_overflow.
+ */
+struct worker {
+    size_t extra;
+    int ok;
+};
+
+static void *overflow_worker(void *arg) {
+    struct worker *w = arg;
+    VARCHAR(src, 64); VARCHAR(dst, 8);
+    memset(src.arr, 'w', sizeof src.arr);
+    src.len = 8 + w->extra;
+    w->ok = 1;
+    for (int i = 0; i < 100000; i++) {
+        v_copy(dst, src);
+        if (varchar_overflow != w->extra)
+            w->ok = 0;
+    }
+    return NULL;
+}
+
+static void test_thread_local(void) {
+    enum { T = 4 };
+    pthread_t tid[T];
+    struct worker w[T];
+    for (int i = 0; i < T; i++) {
+        w[i].extra = (size_t)(i + 1) * 7;
+        pthread_create(&tid[i], NULL, overflow_worker, &w[i]);
+    }
+    int ok = 1;
+    for (int i = 0; i < T; i++) {
+        pthread_join(tid[i], NULL);
+        ok &= w[i].ok;
+    }
+    CHECK_MSG("varchar_overflow thread local", ok,
+              "a worker observed another thread's overflow");
+}
+
+int main(int argc, char **argv) {
+    for (int i=1;i<argc;i++)
+        verbose |= (!strcmp(argv[i], "-v") || !strcmp(argv[i], "--verbose"));
+
+    test_v_status();
+    test_zv_status();
+    test_interop_status();
+    test_publish();
+    test_thread_local();
+
+    if (failures == 0)
+        printf(verbose ? "\nAll tests passed.\n" : "\n");
+    else
+        printf("\n%d test(s) failed.\n", failures);
+    return failures;
+}
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include "vsuite/varchar.h"
@@ -108,6 +109,25 @@ static void test_case(void) {
     CHECK("s_lower", strcmp(buf, "a1b") == 0);
 }
 
+/* A char * is converted up to its terminator, not sizeof(char *) bytes */
+static void test_case_pointer(void) {
+    const char *text = "  pointer argument longer than eight bytes  ";
+    char *heap = malloc(strlen(text) + 1);
+    if (!heap) {
+        CHECK("s_upper pointer malloc", 0);
+        return;
+    }
+    strcpy(heap, text);
+    char *p = heap;
+    s_upper(p);
+    CHECK("s_upper pointer", strcmp(heap, "  POINTER ARGUMENT LONGER THAN EIGHT BYTES  ") == 0);
+    s_lower(p);
+    CHECK("s_lower pointer", strcmp(heap, text) == 0);
+    s_trim(p);
+    CHECK("s_trim pointer", strcmp(heap, "pointer argument longer than eight bytes") == 0);
+    free(heap);
+}
+
 /* Stress test with a large buffer */
 static void test_mass_upper(void) {
     enum { N = 4096 };
@@ -132,6 +152,7 @@ int main(int argc, char **argv) {
     test_strncat();
     test_trim();
     test_case();
+    test_case_pointer();
     test_mass_upper();
 
     if (failures == 0)
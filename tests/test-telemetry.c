@@ -0,0 +1,244 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#define VSUITE_TELEMETRY
+#include "vsuite/varchar.h"
+#include "vsuite/zvarchar.h"
+#include "vsuite/string.h"
+#include "vsuite/pstr.h"
+#include "vsuite/fixed.h"
+#include "vsuite/concat.h"
+#include "vsuite/builder.h"
+#include "vsuite/number.h"
+#include "vsuite/batch.h"
+#include "vsuite/column.h"
+
+static int failures = 0;
+static int verbose = 0;
+
+/*
+ * CHECK_MSG() - Provide additional failure context.
+ * @name: Test name displayed on failure.
+ * @expr: Boolean expression indicating success.
+ * @fmt:  printf style format string used when @expr evaluates to false.
+ * @...: Values referenced by @fmt when reporting a failure.
+ */
+#define CHECK_MSG(name, expr, fmt, ...) do { \
+    if (!(expr)) { \
+        printf("\nFAIL: %s - " fmt "\n", name, ##__VA_ARGS__); \
+        failures++; \
+    } else if (verbose) { \
+        printf("PASS: %s\n", name); \
+    } else { \
+        fputc('.', stdout); fflush(stdout); \
+    } \
+} while (0)
+
+/* CHECK_SITE() - Compare the counters of @macro at @line. */
+#define CHECK_SITE(name, macro, line, sz, ncalls, novf, req) do { \
+    vs_telemetry_site_t *__s = vs_telemetry_find(macro, __FILE__, line); \
+    CHECK_MSG(name, __s && __s->size == (sz) && __s->calls == (ncalls) && \
+              __s->overflow == (novf) && __s->required == (req), \
+              "size %zu calls %llu overflow %llu required %llu", \
+              __s ? __s->size : 0, \
+              __s ? (unsigned long long)__s->calls : 0ULL, \
+              __s ? (unsigned long long)__s->overflow : 0ULL, \
+              __s ? (unsigned long long)__s->required : 0ULL); \
+} while (0)
+
+/* Calls, overflows and the largest source are counted per site. */
+static void test_copy(void) {
+    VARCHAR(dst, 8);
+    VARCHAR(src, 16);
+    int line = 0;
+    memset(src.arr, 'x', sizeof src.arr);
+    for (unsigned short n = 0; n <= 12; n++) {
+        src.len = n;
+        line = __LINE__; v_copy(dst, src);
+    }
+    CHECK_SITE("v_copy", "v_copy", line, 8, 13, 4, 12);
+
+    for (unsigned short n = 0; n <= 5; n++) {
+        src.len = n;
+        line = __LINE__; zv_copy(dst, src);
+    }
+    CHECK_SITE("zv_copy counts the terminator", "zv_copy", line, 8, 6, 0, 6);
+
+    src.len = 16;
+    line = __LINE__; v_strncpy(dst, src, 3);
+    CHECK_SITE("v_strncpy", "v_strncpy", line, 8, 1, 0, 3);
+}
+
+/* Concatenation needs room for what is already there. */
+static void test_cat(void) {
+    VARCHAR(dst, 8);
+    VARCHAR(src, 4);
+    memcpy(src.arr, "abcd", 4);
+    src.len = 4;
+    dst.len = 0;
+    int line = __LINE__; for (int i = 0; i < 3; i++) v_strcat(dst, src);
+    CHECK_SITE("v_strcat", "v_strcat", line, 8, 3, 1, 12);
+
+    dst.len = 0;
+    line = __LINE__; for (int i = 0; i < 3; i++) zv_strncat(dst, src, 2);
+    CHECK_SITE("zv_strncat", "zv_strncat", line, 8, 3, 0, 7);
+}
+
+/* v_sprintf() needs the formatted length plus its terminator. */
+static void test_sprintf(void) {
+    VARCHAR(dst, 6);
+    int line = __LINE__; v_sprintf(dst, "%d", 42);
+    CHECK_SITE("v_sprintf fits", "v_sprintf", line, 6, 1, 0, 3);
+    line = __LINE__; v_sprintf(dst, "%s", "overflowing");
+    CHECK_SITE("v_sprintf overflow", "v_sprintf", line, 6, 1, 1, 12);
+}
+
+/* The interop, C string, concat, builder, number and column copies count too. */
+static void test_families(void) {
+    VARCHAR(v, 4);
+    int line = __LINE__; vp_copy(v, "abcdef");
+    CHECK_SITE("vp_copy", "vp_copy", line, 4, 1, 1, 6);
+    line = __LINE__; zvp_copy(v, "ab");
+    CHECK_SITE("zvp_copy", "zvp_copy", line, 4, 1, 0, 3);
+    line = __LINE__; vf_copy(v, "abcde");
+    CHECK_SITE("vf_copy", "vf_copy", line, 4, 1, 1, 5);
+
+    memcpy(v.arr, "ab", 2);
+    v.len = 2;
+    char out[8];
+    volatile size_t cap = sizeof out;
+    line = __LINE__; pv_copy(out, sizeof out, v);
+    CHECK_SITE("pv_copy", "pv_copy", line, 8, 1, 0, 3);
+    line = __LINE__; pv_copy(out, cap, v);
+    CHECK_SITE("pv_copy runtime capacity", "pv_copy", line, 0, 1, 0, 3);
+
+    char s[5];
+    line = __LINE__; s_copy(s, "abcdef");
+    CHECK_SITE("s_copy", "s_copy", line, 5, 1, 1, 7);
+    line = __LINE__; s_strcat(s, "xy");
+    CHECK_SITE("s_strcat", "s_strcat", line, 5, 1, 1, 7);
+
+    VARCHAR(p, 4);
+    VARCHAR(k, 6);
+    memcpy(p.arr, "abcd", 4);
+    p.len = 4;
+    line = __LINE__; v_concat_many(k, p, p);
+    CHECK_SITE("v_concat_many", "v_concat_many", line, 6, 1, 1, 8);
+
+    v_builder_t b = zv_build_begin(k);
+    v_build_lit(&b, "abcdefg");
+    line = __LINE__; zv_build_end(k, &b);
+    CHECK_SITE("zv_build_end", "zv_build_end", line, 6, 1, 1, 8);
+
+    VARCHAR(num, 3);
+    line = __LINE__; v_from_int(num, -1234);
+    CHECK_SITE("v_from_int", "v_from_int", line, 3, 1, 1, 5);
+
+    VARCHAR(dst[2], 4);
+    VARCHAR(src[2], 8);
+    memset(src, 'z', sizeof src);
+    src[0].len = 3;
+    src[1].len = 6;
+    line = __LINE__; vb_copy(dst, src, 2);
+    CHECK_SITE("vb_copy", "vb_copy", line, 4, 1, 1, 6);
+
+    VCOLUMN(col, 2, 8);
+    VARCHAR(a, 8);
+    memset(a.arr, 'a', sizeof a.arr);
+    a.len = 6;
+    vc_init(col);
+    line = __LINE__; vc_append(col, a);
+    CHECK_SITE("vc_append", "vc_append", line, 8, 1, 0, 6);
+    line = __LINE__; vc_get(v, col, 0);
+    CHECK_SITE("vc_get", "vc_get", line, 4, 1, 1, 6);
+}
+
+static void *hammer(void *arg) {
+    unsigned short len = (unsigned short)(uintptr_t)arg;
+    VARCHAR(dst, 32);
+    VARCHAR(src, 64);
+    memset(src.arr, 'y', sizeof src.arr);
+    src.len = len;
+    for (int i = 0; i < 10000; i++)
+        v_copy(dst, src);
+    return NULL;
+}
+
+/* Concurrent calls lose no counts and keep the largest size. */
+static void test_threads(void) {
+    pthread_t th[4];
+    for (int t = 0; t < 4; t++)
+        pthread_create(&th[t], NULL, hammer, (void *)(uintptr_t)(10 + 15 * t));
+    for (int t = 0; t < 4; t++)
+        pthread_join(th[t], NULL);
+    size_t n;
+    vs_telemetry_site_t *s = vs_telemetry_sites(&n);
+    uint64_t calls = 0, ovf = 0, req = 0;
+    for (size_t i = 0; i < n; i++)
+        if (s[i].size == 32) {
+            calls += s[i].calls;
+            ovf += s[i].overflow;
+            req = s[i].required;
+        }
+    CHECK_MSG("VS_TELEMETRY threads", calls == 40000 && ovf == 20000 && req == 55,
+              "calls %llu overflow %llu required %llu", (unsigned long long)calls,
+              (unsigned long long)ovf, (unsigned long long)req);
+}
+
+/* The dumps contain one row or object per record. */
+static void test_dump(void) {
+    size_t n;
+    vs_telemetry_sites(&n);
+    char buf[16384];
+
+    FILE *f = tmpfile();
+    size_t rows = vs_telemetry_dump_csv(f);
+    rewind(f);
+    size_t len = fread(buf, 1, sizeof buf - 1, f);
+    buf[len] = '\0';
+    fclose(f);
+    size_t lines = 0;
+    for (char *p = buf; *p; p++)
+        lines += *p == '\n';
+    CHECK_MSG("vs_telemetry_dump_csv", rows == n && lines == n + 1 &&
+              !strncmp(buf, "macro,file,line,size,calls,overflow,required\n", 45) &&
+              strstr(buf, "v_sprintf,\"" __FILE__ "\","),
+              "csv:\n%s", buf);
+
+    char path[] = "/tmp/test-telemetry-XXXXXX.json";
+    int fd = mkstemps(path, 5);
+    long dumped = fd < 0 ? -1 : vs_telemetry_dump(path);
+    f = fopen(path, "r");
+    len = f ? fread(buf, 1, sizeof buf - 1, f) : 0;
+    buf[len] = '\0';
+    if (f)
+        fclose(f);
+    remove(path);
+    size_t objects = 0;
+    for (char *p = buf; (p = strstr(p, "{\"macro\": ")); p++)
+        objects++;
+    CHECK_MSG("vs_telemetry_dump json", dumped == (long)n && objects == n &&
+              buf[0] == '[' && strstr(buf, "\"macro\": \"zv_copy\"") &&
+              strstr(buf, "\"size\": 6, \"calls\": 1, \"overflow\": 1, \"required\": 12}"),
+              "json:\n%s", buf);
+}
+
+int main(int argc, char **argv) {
+    for (int i=1;i<argc;i++)
+        verbose |= (!strcmp(argv[i], "-v") || !strcmp(argv[i], "--verbose"));
+
+    test_copy();
+    test_cat();
+    test_sprintf();
+    test_families();
+    test_threads();
+    test_dump();
+
+    if (failures == 0)
+        printf(verbose ? "\nAll tests passed.\n" : "\n");
+    else
+        printf("\n%d test(s) failed.\n", failures);
+    return failures;
+}